@@ -61,6 +61,7 @@ from .biggles import (
     Points,
     Polygon,
     Slope,
+    StreamingCurve,
     SymmetricErrorBarsX,
     SymmetricErrorBarsY,
     Table,
@@ -22,8 +22,16 @@
 
 #include <Python.h>
 #include <math.h>
+#include <stdlib.h>
+#include <string.h>
 #include <numpy/arrayobject.h>
 
+#if !defined(_WIN32)
+#include <pthread.h>
+#include <unistd.h>
+#define BGL_HAVE_PTHREAD 1
+#endif
+
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
@@ -83,22 +91,82 @@
  
 #define BGL_MAX_SEGS 4
 
+/*
+ *  contour_lines() does this for a whole list of levels, and connects
+ *  the dots in C. Every segment endpoint lies on an edge, or at a
+ *  vertex, of the triangulation above, so it's labelled by the pair
+ *  of triangulation vertices it lies between.
+ *  Endpoints are matched by looking their labels up in a hash table,
+ *  not by comparing coordinates, and a crossing is always
+ *  interpolated from the same end of its edge, so the cells on
+ *  either side of an edge agree on where it is.
+ *
+ *  Levels don't depend on one another, so they're handed out to a
+ *  few threads. The result is a single array of vertices, with
+ *  offsets marking where each polyline, and each level, begins.
+ *  Without POSIX threads the levels are all traced by the caller.
+ */
+
+#define BGL_MAX_CONTOUR_THREADS 16
+
+#ifdef BGL_HAVE_PTHREAD
+typedef pthread_t BGL_Thread;
+#define BGL_NCPU()			sysconf( _SC_NPROCESSORS_ONLN )
+#define BGL_THREAD_START(t,f,arg)	(pthread_create( &(t), NULL, f, arg ) == 0)
+#define BGL_THREAD_JOIN(t)		pthread_join( t, NULL )
+#else
+typedef int BGL_Thread;
+#define BGL_NCPU()			1
+#define BGL_THREAD_START(t,f,arg)	((void) &(t), 0)
+#define BGL_THREAD_JOIN(t)
+#endif
+
+typedef unsigned long long BGL_Key;
+
+struct BGL_Grid
+{
+	const double *x, *y, *z;
+	npy_intp nx, ny;
+	BGL_Key nv;		/* number of triangulation vertices */
+};
+
+struct BGL_Seg
+{
+	BGL_Key key[2];
+	double p[2][2];
+};
+
+struct BGL_Lines
+{
+	double *verts;		/* (x,y) pairs */
+	npy_intp nverts, maxverts;
+	npy_intp *offsets;	/* start of each line */
+	npy_intp nlines, maxlines;
+	int failed;
+};
+
 static int
-_find_zero( double p[3], double q[3], double zero[2] )
+_edge_zero( double p[5][3], BGL_Key id[5], BGL_Key nv, int a, int b,
+	BGL_Key *key, double zero[2] )
 {
-	double a;
+	double t;
+	int s, u;
 
-	if ( p[2] == 0. )
+	if ( p[a][2] == 0. )
 	{
-		zero[0] = p[0];
-		zero[1] = p[1];
+		*key = id[a]*nv + id[a];
+		zero[0] = p[a][0];
+		zero[1] = p[a][1];
 		return 1;
 	}
-	else if ( p[2]*q[2] < 0. )
+	else if ( p[a][2]*p[b][2] < 0. )
 	{
-		a = p[2]/(p[2] - q[2]);
-		zero[0] = p[0] + a*(q[0] - p[0]);
-		zero[1] = p[1] + a*(q[1] - p[1]);
+		s = id[a] < id[b] ? a : b;
+		u = id[a] < id[b] ? b : a;
+		t = p[s][2]/(p[s][2] - p[u][2]);
+		*key = id[s]*nv + id[u];
+		zero[0] = p[s][0] + t*(p[u][0] - p[s][0]);
+		zero[1] = p[s][1] + t*(p[u][1] - p[s][1]);
 		return 1;
 	}
 
@@ -106,12 +174,13 @@ _find_zero( double p[3], double q[3], double zero[2] )
 }
 
 static int
-_pixel_interpolate( PyObject *x, PyObject *y, PyObject *z,
-	double z0, int i, int j, double segs[BGL_MAX_SEGS][4] )
+_cell_segments( const struct BGL_Grid *g, double z0, npy_intp i, npy_intp j,
+	struct BGL_Seg segs[BGL_MAX_SEGS] )
 {
-	int k, l, ii, jj, kk;
+	int k, l, kk, nz, ns;
+	npy_intp ii, jj;
 	double p[5][3], zeros[3][2];
-	int nz, ns;
+	BGL_Key id[5], keys[3];
 
 	for ( l = 0; l < 3; l++ )
 		p[4][l] = 0.;
@@ -121,13 +190,15 @@ _pixel_interpolate( PyObject *x, PyObject *y, PyObject *z,
 		ii = i + (k/2 % 2);
 		jj = j + ((k+1)/2 % 2);
 
-		p[k][0] = BGL_DArray1(x,ii);
-		p[k][1] = BGL_DArray1(y,jj);
-		p[k][2] = BGL_DArray2(z,ii,jj) - z0;
+		p[k][0] = g->x[ii];
+		p[k][1] = g->y[jj];
+		p[k][2] = g->z[ii*g->ny + jj] - z0;
+		id[k] = (BGL_Key) (ii*g->ny + jj);
 
 		for ( l = 0; l < 3; l++ )
 			p[4][l] += 0.25 * p[k][l];
 	}
+	id[4] = (BGL_Key) (g->nx*g->ny + i*(g->ny - 1) + j);
 
 	ns = 0;
 
@@ -136,16 +207,18 @@ _pixel_interpolate( PyObject *x, PyObject *y, PyObject *z,
 		kk = (k + 1) % 4;
 
 		nz = 0;
-		nz += _find_zero( p[4], p[k], zeros[nz] );
-		nz += _find_zero( p[k], p[kk], zeros[nz] );
-		nz += _find_zero( p[kk], p[4], zeros[nz] );
+		nz += _edge_zero( p, id, g->nv, 4, k, keys+nz, zeros[nz] );
+		nz += _edge_zero( p, id, g->nv, k, kk, keys+nz, zeros[nz] );
+		nz += _edge_zero( p, id, g->nv, kk, 4, keys+nz, zeros[nz] );
 
 		if ( nz == 2 )
 		{
-			segs[ns][0] = zeros[0][0];
-			segs[ns][1] = zeros[0][1];
-			segs[ns][2] = zeros[1][0];
-			segs[ns][3] = zeros[1][1];
+			for ( l = 0; l < 2; l++ )
+			{
+				segs[ns].key[l] = keys[l];
+				segs[ns].p[l][0] = zeros[l][0];
+				segs[ns].p[l][1] = zeros[l][1];
+			}
 			ns++;
 		}
 	}
@@ -153,57 +226,383 @@ _pixel_interpolate( PyObject *x, PyObject *y, PyObject *z,
 	return ns;
 }
 
+static int
+_grow( void **buf, npy_intp *max, npy_intp need, size_t size )
+{
+	npy_intp n;
+	void *p;
+
+	if ( need <= *max )
+		return 1;
+	n = BGL_MAX( need, 2*(*max) + 64 );
+	p = realloc( *buf, n*size );
+	if ( p == NULL )
+		return 0;
+	*buf = p;
+	*max = n;
+	return 1;
+}
+
+static void
+_lines_add_vertex( struct BGL_Lines *lines, const double p[2] )
+{
+	if ( !_grow( (void **) &lines->verts, &lines->maxverts,
+			lines->nverts + 1, 2*sizeof(double) ) )
+	{
+		lines->failed = 1;
+		return;
+	}
+	lines->verts[2*lines->nverts] = p[0];
+	lines->verts[2*lines->nverts+1] = p[1];
+	lines->nverts++;
+}
+
+static void
+_lines_begin( struct BGL_Lines *lines )
+{
+	if ( !_grow( (void **) &lines->offsets, &lines->maxlines,
+			lines->nlines + 1, sizeof(npy_intp) ) )
+	{
+		lines->failed = 1;
+		return;
+	}
+	lines->offsets[lines->nlines++] = lines->nverts;
+}
+
+/*
+ *  Join segments into polylines. Nodes are the distinct endpoint
+ *  labels; lines are walked from nodes that don't have exactly two
+ *  segments (ends and junctions), and whatever is left over is
+ *  closed loops.
+ */
+
+static int
+_stitch( struct BGL_Seg *segs, npy_intp nseg, struct BGL_Lines *lines )
+{
+	BGL_Key *table_key;
+	npy_intp *table_node, *node, *deg, *start, *adj, *fill;
+	double *coords;
+	char *used;
+	npy_intp s, n, nnode, cap, h, a, m, cur, seg;
+	int e, bits, ok;
+
+	if ( nseg == 0 )
+		return 1;
+
+	for ( bits = 4, cap = 16; cap < 4*nseg; bits++, cap *= 2 )
+		;
+
+	table_key = (BGL_Key *) malloc( cap*sizeof(BGL_Key) );
+	table_node = (npy_intp *) malloc( cap*sizeof(npy_intp) );
+	node = (npy_intp *) malloc( 2*nseg*sizeof(npy_intp) );
+	coords = (double *) malloc( 4*nseg*sizeof(double) );
+	deg = (npy_intp *) calloc( 2*nseg + 1, sizeof(npy_intp) );
+	start = (npy_intp *) malloc( (2*nseg + 1)*sizeof(npy_intp) );
+	fill = (npy_intp *) malloc( (2*nseg + 1)*sizeof(npy_intp) );
+	adj = (npy_intp *) malloc( 2*nseg*sizeof(npy_intp) );
+	used = (char *) calloc( nseg, 1 );
+
+	ok = table_key && table_node && node && coords && deg && start
+		&& fill && adj && used;
+	if ( !ok )
+		goto quit;
+
+	/* label -> node */
+	for ( h = 0; h < cap; h++ )
+		table_node[h] = -1;
+
+	nnode = 0;
+	for ( s = 0; s < nseg; s++ )
+		for ( e = 0; e < 2; e++ )
+		{
+			BGL_Key key = segs[s].key[e];
+
+			h = (npy_intp) ((key * 0x9E3779B97F4A7C15ULL) >> (64 - bits));
+			while ( table_node[h] >= 0 && table_key[h] != key )
+				h = (h + 1) & (cap - 1);
+			if ( table_node[h] < 0 )
+			{
+				table_key[h] = key;
+				table_node[h] = nnode;
+				coords[2*nnode] = segs[s].p[e][0];
+				coords[2*nnode+1] = segs[s].p[e][1];
+				nnode++;
+			}
+			node[2*s+e] = table_node[h];
+			deg[table_node[h]]++;
+		}
+
+	/* node -> segments, as (2*segment + end) */
+	start[0] = 0;
+	for ( n = 0; n < nnode; n++ )
+	{
+		start[n+1] = start[n] + deg[n];
+		fill[n] = start[n];
+	}
+	for ( s = 0; s < 2*nseg; s++ )
+		adj[fill[node[s]]++] = s;
+
+	for ( m = 0; m < 2; m++ )
+	for ( n = 0; n < nnode; n++ )
+	{
+		/* first pass: open lines; second pass: loops */
+		if ( m == 0 && deg[n] == 2 )
+			continue;
+
+		for ( a = start[n]; a < start[n+1]; a++ )
+		{
+			if ( used[adj[a]/2] )
+				continue;
+
+			_lines_begin( lines );
+			_lines_add_vertex( lines, coords + 2*n );
+			cur = n;
+			seg = adj[a];
+
+			while ( seg >= 0 )
+			{
+				used[seg/2] = 1;
+				cur = node[seg ^ 1];
+				_lines_add_vertex( lines, coords + 2*cur );
+
+				seg = -1;
+				if ( deg[cur] != 2 )
+					break;
+				for ( h = start[cur]; h < start[cur+1]; h++ )
+					if ( !used[adj[h]/2] )
+					{
+						seg = adj[h];
+						break;
+					}
+			}
+		}
+	}
+
+quit:
+	free( table_key );
+	free( table_node );
+	free( node );
+	free( coords );
+	free( deg );
+	free( start );
+	free( fill );
+	free( adj );
+	free( used );
+	return ok;
+}
+
+static void
+_contour_level( const struct BGL_Grid *g, double z0, struct BGL_Lines *lines )
+{
+	struct BGL_Seg *segs = NULL, cell[BGL_MAX_SEGS];
+	npy_intp i, j, nseg = 0, maxseg = 0;
+	int k, ns;
+
+	for ( i = 0; i < g->nx-1; i++ )
+		for ( j = 0; j < g->ny-1; j++ )
+		{
+			const double *z = g->z + i*g->ny + j;
+
+			/* most cells lie entirely above or below the level */
+			if ( (z[0] > z0 && z[1] > z0
+			      && z[g->ny] > z0 && z[g->ny+1] > z0)
+			     || (z[0] < z0 && z[1] < z0
+			      && z[g->ny] < z0 && z[g->ny+1] < z0) )
+				continue;
+
+			ns = _cell_segments( g, z0, i, j, cell );
+			if ( ns == 0 )
+				continue;
+			if ( !_grow( (void **) &segs, &maxseg, nseg + ns,
+					sizeof(struct BGL_Seg) ) )
+			{
+				lines->failed = 1;
+				free( segs );
+				return;
+			}
+			for ( k = 0; k < ns; k++ )
+				segs[nseg++] = cell[k];
+		}
+
+	if ( !_stitch( segs, nseg, lines ) )
+		lines->failed = 1;
+	free( segs );
+}
+
+struct BGL_ContourJob
+{
+	const struct BGL_Grid *grid;
+	const double *levels;
+	struct BGL_Lines *lines;
+	npy_intp nlevels;
+	int first, stride;
+};
+
+static void *
+_contour_job( void *arg )
+{
+	struct BGL_ContourJob *job = (struct BGL_ContourJob *) arg;
+	npy_intp k;
+
+	for ( k = job->first; k < job->nlevels; k += job->stride )
+		_contour_level( job->grid, job->levels[k], job->lines + k );
+
+	return NULL;
+}
+
+static void
+_contour_levels( const struct BGL_Grid *g, const double *levels,
+	npy_intp nlevels, struct BGL_Lines *lines )
+{
+	struct BGL_ContourJob jobs[BGL_MAX_CONTOUR_THREADS];
+	BGL_Thread threads[BGL_MAX_CONTOUR_THREADS];
+	int started[BGL_MAX_CONTOUR_THREADS];
+	long ncpu;
+	int t, nthreads;
+
+	ncpu = BGL_NCPU();
+	nthreads = (int) BGL_MIN( nlevels, BGL_MAX(ncpu, 1) );
+	nthreads = BGL_MAX( BGL_MIN(nthreads, BGL_MAX_CONTOUR_THREADS), 1 );
+
+	for ( t = 0; t < nthreads; t++ )
+	{
+		jobs[t].grid = g;
+		jobs[t].levels = levels;
+		jobs[t].lines = lines;
+		jobs[t].nlevels = nlevels;
+		jobs[t].first = t;
+		jobs[t].stride = nthreads;
+	}
+
+	/* thread 0's share runs here, as does anyone's whose thread
+	 * couldn't be started */
+	for ( t = 1; t < nthreads; t++ )
+		started[t] = BGL_THREAD_START( threads[t],
+				_contour_job, &jobs[t] );
+	_contour_job( &jobs[0] );
+	for ( t = 1; t < nthreads; t++ )
+	{
+		if ( started[t] )
+			BGL_THREAD_JOIN( threads[t] );
+		else
+			_contour_job( &jobs[t] );
+	}
+}
+
 static PyObject *
-biggles_contour_segments( PyObject *self, PyObject *args )
+biggles_contour_lines( PyObject *self, PyObject *args )
 {
-	PyObject *ox, *oy, *oz, *list, *ref;
-	PyObject *x, *y, *z;
-	double z0;
-	double segs[BGL_MAX_SEGS][4];
-	int i, j, k, ns;
+	PyObject *ox, *oy, *oz, *olevels, *ret;
+	PyObject *x, *y, *z, *levels, *verts, *offsets, *level_offsets;
+	struct BGL_Grid grid;
+	struct BGL_Lines *lines;
+	npy_intp k, l, nlevels, nverts, nlines, dims[2];
+	int failed;
 
-	list = NULL;
+	ret = verts = offsets = level_offsets = NULL;
+	lines = NULL;
 
-	if ( !PyArg_ParseTuple(args, "OOOd", &ox, &oy, &oz, &z0) )
+	if ( !PyArg_ParseTuple(args, "OOOO", &ox, &oy, &oz, &olevels) )
 		return NULL;
 
 	x = PyArray_ContiguousFromAny( ox, NPY_DOUBLE, 1, 1 );
 	y = PyArray_ContiguousFromAny( oy, NPY_DOUBLE, 1, 1 );
 	z = PyArray_ContiguousFromAny( oz, NPY_DOUBLE, 2, 2 );
+	levels = PyArray_ContiguousFromAny( olevels, NPY_DOUBLE, 0, 1 );
 
-	if ( x == NULL || y == NULL || z == NULL )
+	if ( x == NULL || y == NULL || z == NULL || levels == NULL )
+		goto quit;
+
+	if ( PyArray_DIM(z,0) != PyArray_DIM(x,0)
+	     || PyArray_DIM(z,1) != PyArray_DIM(y,0) )
+	{
+		PyErr_SetString( PyExc_ValueError,
+				 "array dimensions are not compatible" );
 		goto quit;
+	}
+
+	grid.x = (const double *) PyArray_DATA(x);
+	grid.y = (const double *) PyArray_DATA(y);
+	grid.z = (const double *) PyArray_DATA(z);
+	grid.nx = PyArray_DIM(z,0);
+	grid.ny = PyArray_DIM(z,1);
+	grid.nv = (BGL_Key) (grid.nx*grid.ny
+		+ BGL_MAX(grid.nx-1, 0)*BGL_MAX(grid.ny-1, 0));
+
+	nlevels = PyArray_SIZE(levels);
+	lines = (struct BGL_Lines *) calloc( nlevels + 1, sizeof(struct BGL_Lines) );
+	if ( lines == NULL )
+	{
+		PyErr_NoMemory();
+		goto quit;
+	}
 
-    if ( PyArray_DIM(z,0) != PyArray_DIM(x,0)
-             || PyArray_DIM(z,1) != PyArray_DIM(y,0) ) {
-        PyErr_SetString( PyExc_ValueError,
-                         "array dimensions are not compatible" );
-        goto quit;
+	Py_BEGIN_ALLOW_THREADS
+	_contour_levels( &grid, (const double *) PyArray_DATA(levels),
+		nlevels, lines );
+	Py_END_ALLOW_THREADS
+
+	failed = 0;
+	nverts = nlines = 0;
+	for ( l = 0; l < nlevels; l++ )
+	{
+		failed |= lines[l].failed;
+		nverts += lines[l].nverts;
+		nlines += lines[l].nlines;
+	}
+	if ( failed )
+	{
+		PyErr_NoMemory();
+		goto quit;
 	}
 
-	list = PyList_New( 0 );
-	if ( list == NULL )
+	dims[0] = nverts;
+	dims[1] = 2;
+	verts = PyArray_ZEROS( 2, dims, NPY_DOUBLE, 0 );
+	dims[0] = nlines + 1;
+	offsets = PyArray_ZEROS( 1, dims, NPY_INTP, 0 );
+	dims[0] = nlevels + 1;
+	level_offsets = PyArray_ZEROS( 1, dims, NPY_INTP, 0 );
+
+	if ( verts == NULL || offsets == NULL || level_offsets == NULL )
 		goto quit;
 
-	for ( i = 0; i < PyArray_DIM(z,0)-1; i++ )
-        for ( j = 0; j < PyArray_DIM(z,1)-1; j++ )
-        {
-            ns = _pixel_interpolate( x, y, z, z0, i, j, segs );
-            for ( k = 0; k < ns; k++ )
-            {
-                ref = Py_BuildValue( "((dd)(dd))",
-                                     segs[k][0], segs[k][1],
-                                     segs[k][2], segs[k][3] );
-                PyList_Append( list, ref );
-                Py_DECREF(ref); /* ??? */
-            }
-        }
+	nverts = nlines = 0;
+	for ( l = 0; l < nlevels; l++ )
+	{
+		*(npy_intp *) PyArray_GETPTR1(level_offsets, l) = nlines;
+		if ( lines[l].nverts > 0 )
+			memcpy( PyArray_GETPTR2(verts, nverts, 0), lines[l].verts,
+				2*lines[l].nverts*sizeof(double) );
+		for ( k = 0; k < lines[l].nlines; k++ )
+			*(npy_intp *) PyArray_GETPTR1(offsets, nlines + k) =
+				nverts + lines[l].offsets[k];
+		nverts += lines[l].nverts;
+		nlines += lines[l].nlines;
+	}
+	*(npy_intp *) PyArray_GETPTR1(level_offsets, nlevels) = nlines;
+	*(npy_intp *) PyArray_GETPTR1(offsets, nlines) = nverts;
+
+	ret = Py_BuildValue( "OOO", verts, offsets, level_offsets );
 
 quit:
+	if ( lines != NULL )
+	{
+		for ( l = 0; l < nlevels; l++ )
+		{
+			free( lines[l].verts );
+			free( lines[l].offsets );
+		}
+		free( lines );
+	}
 	Py_XDECREF(x);
 	Py_XDECREF(y);
 	Py_XDECREF(z);
-	return list;
+	Py_XDECREF(levels);
+	Py_XDECREF(verts);
+	Py_XDECREF(offsets);
+	Py_XDECREF(level_offsets);
+	return ret;
 }
 
 /******************************************************************************
@@ -320,12 +719,14 @@ biggles_hammer_call_vec( PyObject *self, PyObject *args )
 	if ( u == NULL || v == NULL )
 		goto quit1;
 
+	Py_BEGIN_ALLOW_THREADS
 	for ( i = 0; i < n; i++ )
 	{
 		_lb_input( BGL_DArray1(l,i), BGL_DArray1(b,i),
 			l0, b0, rot, &ll, &bb );
 		_lb2uv( ll, bb, BGL_DArray1_ptr(u,i), BGL_DArray1_ptr(v,i) );
 	}
+	Py_END_ALLOW_THREADS
 
 	ret = Py_BuildValue( "OO", u, v );
 
@@ -398,6 +799,7 @@ biggles_hammer_geodesic_fill( PyObject *self, PyObject *args )
 	if ( l2 == NULL || b2 == NULL )
 		goto quit;
 
+	Py_BEGIN_ALLOW_THREADS
 	for ( i = 0; i < n-1; i++ ) {
 		_lb_geodesic( div,
 			BGL_DArray1(l,i), BGL_DArray1(b,i),
@@ -405,6 +807,7 @@ biggles_hammer_geodesic_fill( PyObject *self, PyObject *args )
             BGL_DArray1_ptr(l2, i*div),
             BGL_DArray1_ptr(b2, i*div));
     }
+	Py_END_ALLOW_THREADS
 
 	ref = Py_BuildValue( "OO", l2, b2 );
 quit:
@@ -435,6 +838,583 @@ biggles_hammer_connect( PyObject *self, PyObject *args )
 	return Py_BuildValue( "i", connect );
 }
 
+/******************************************************************************
+ *  biggles.py
+ *
+ *  _PlotGeometry.call_vec in one pass: log scaling, if any, and the
+ *  affine map to device coordinates, without temporary arrays. The
+ *  result has the shape of x, which y has to match.
+ */
+
+static PyObject *
+biggles_geom_call_vec( PyObject *self, PyObject *args )
+{
+	PyObject *ox, *oy, *ret;
+	PyObject *x, *y, *p, *q;
+	const double *px, *py;
+	double *pp, *pq, u, v;
+	double t0, t1, m00, m01, m10, m11;
+	int xlog, ylog;
+	npy_intp i, n;
+
+	ret = p = q = NULL;
+
+	if ( !PyArg_ParseTuple(args, "OOiidddddd", &ox, &oy, &xlog, &ylog,
+			&t0, &t1, &m00, &m01, &m10, &m11) )
+		return NULL;
+
+	x = PyArray_ContiguousFromAny( ox, NPY_DOUBLE, 0, 0 );
+	y = PyArray_ContiguousFromAny( oy, NPY_DOUBLE, 0, 0 );
+
+	if ( x == NULL || y == NULL )
+		goto quit;
+
+	n = PyArray_SIZE((PyArrayObject*)x);
+	if ( PyArray_SIZE((PyArrayObject*)y) != n )
+	{
+		PyErr_SetString( PyExc_ValueError, "x and y differ in size" );
+		goto quit;
+	}
+
+	p = PyArray_EMPTY( PyArray_NDIM((PyArrayObject*)x),
+		PyArray_DIMS((PyArrayObject*)x), NPY_DOUBLE, 0 );
+	q = PyArray_EMPTY( PyArray_NDIM((PyArrayObject*)x),
+		PyArray_DIMS((PyArrayObject*)x), NPY_DOUBLE, 0 );
+
+	if ( p == NULL || q == NULL )
+		goto quit;
+
+	px = (const double *)PyArray_DATA((PyArrayObject*)x);
+	py = (const double *)PyArray_DATA((PyArrayObject*)y);
+	pp = (double *)PyArray_DATA((PyArrayObject*)p);
+	pq = (double *)PyArray_DATA((PyArrayObject*)q);
+
+	Py_BEGIN_ALLOW_THREADS
+	for ( i = 0; i < n; i++ )
+	{
+		u = xlog ? log10(px[i]) : px[i];
+		v = ylog ? log10(py[i]) : py[i];
+		pp[i] = t0 + m00*u + m01*v;
+		pq[i] = t1 + m10*u + m11*v;
+	}
+	Py_END_ALLOW_THREADS
+
+	ret = Py_BuildValue( "NN", PyArray_Return((PyArrayObject*)p),
+		PyArray_Return((PyArrayObject*)q) );
+	p = q = NULL;
+
+quit:
+	Py_XDECREF(x);
+	Py_XDECREF(y);
+	Py_XDECREF(p);
+	Py_XDECREF(q);
+	return ret;
+}
+
+/******************************************************************************
+ *  biggles.py
+ *
+ *  Polyline decimation. Consecutive points falling in the same device
+ *  column, of width tol, are replaced by the first, lowest, highest
+ *  and last of them, kept in their original order. The decimated line
+ *  covers the same pixels as the original to within one column, and a
+ *  curve with many more points than columns shrinks to at most four
+ *  points per column.
+ */
+
+static PyObject *
+biggles_decimate( PyObject *self, PyObject *args )
+{
+	PyObject *ox, *oy, *ret;
+	PyObject *x, *y, *u, *v, *r;
+	PyArray_Dims dims;
+	double tol, col, yi;
+	npy_intp i, i0, i1, imin, imax, n, m;
+	npy_intp keep[4];
+	int k, nkeep;
+
+	ret = u = v = NULL;
+
+	if ( !PyArg_ParseTuple(args, "OOd", &ox, &oy, &tol) )
+		return NULL;
+
+	x = PyArray_ContiguousFromAny( ox, NPY_DOUBLE, 1, 1 );
+	y = PyArray_ContiguousFromAny( oy, NPY_DOUBLE, 1, 1 );
+
+	if ( x == NULL || y == NULL )
+		goto quit;
+
+	if ( !(tol > 0.) )
+	{
+		PyErr_SetString( PyExc_ValueError, "tolerance must be positive" );
+		goto quit;
+	}
+
+	n = BGL_MIN( PyArray_SIZE(x), PyArray_SIZE(y) );
+
+	u = PyArray_ZEROS( 1, &n, NPY_DOUBLE, 0 );
+	v = PyArray_ZEROS( 1, &n, NPY_DOUBLE, 0 );
+
+	if ( u == NULL || v == NULL )
+		goto quit;
+
+	m = 0;
+	Py_BEGIN_ALLOW_THREADS
+	for ( i0 = 0; i0 < n; i0 = i1 + 1 )
+	{
+		col = floor( BGL_DArray1(x,i0)/tol );
+		imin = imax = i1 = i0;
+
+		/* NaNs end a run, and are passed through on their own */
+		if ( BGL_DArray1(y,i0) == BGL_DArray1(y,i0) )
+		{
+			for ( i = i0+1; i < n; i++ )
+			{
+				yi = BGL_DArray1(y,i);
+				if ( floor(BGL_DArray1(x,i)/tol) != col || yi != yi )
+					break;
+				if ( yi < BGL_DArray1(y,imin) )
+					imin = i;
+				if ( yi > BGL_DArray1(y,imax) )
+					imax = i;
+				i1 = i;
+			}
+		}
+
+		nkeep = 0;
+		keep[nkeep++] = i0;
+		if ( BGL_MIN(imin,imax) > keep[nkeep-1] )
+			keep[nkeep++] = BGL_MIN(imin,imax);
+		if ( BGL_MAX(imin,imax) > keep[nkeep-1] )
+			keep[nkeep++] = BGL_MAX(imin,imax);
+		if ( i1 > keep[nkeep-1] )
+			keep[nkeep++] = i1;
+
+		for ( k = 0; k < nkeep; k++, m++ )
+		{
+			BGL_DArray1(u,m) = BGL_DArray1(x,keep[k]);
+			BGL_DArray1(v,m) = BGL_DArray1(y,keep[k]);
+		}
+	}
+	Py_END_ALLOW_THREADS
+
+	dims.ptr = &m;
+	dims.len = 1;
+	if ( (r = PyArray_Resize( (PyArrayObject*)u, &dims, 0, NPY_CORDER )) == NULL )
+		goto quit;
+	Py_DECREF(r);
+	if ( (r = PyArray_Resize( (PyArrayObject*)v, &dims, 0, NPY_CORDER )) == NULL )
+		goto quit;
+	Py_DECREF(r);
+
+	ret = Py_BuildValue( "OO", u, v );
+
+quit:
+	Py_XDECREF(x);
+	Py_XDECREF(y);
+	Py_XDECREF(u);
+	Py_XDECREF(v);
+	return ret;
+}
+
+/******************************************************************************
+ *  biggles.py
+ *
+ *  RingBuffer, the point store of a StreamingCurve. The x and y values
+ *  are the two rows of a 2-d array, which arrays() hands out slices of,
+ *  so a curve is drawn from the buffer without copying it.
+ *
+ *  Unbounded buffers grow by doubling, and keep running limits. A new
+ *  array is allocated on growth, so slices handed out earlier stay
+ *  valid (if stale).
+ *
+ *  Window buffers keep the last `window' points. Each point is stored
+ *  twice, at p and p+window, so the points held are always a contiguous
+ *  run of a row, however the buffer has wrapped. The limits of the
+ *  window come from monotonic deques of point numbers, one per limit,
+ *  in which each point is pushed and popped at most once. Slices of a
+ *  window buffer are overwritten by later appends.
+ *
+ *  NaNs are stored, but don't count towards the limits.
+ */
+
+struct BGL_Deque
+{
+	long long *t;		/* point numbers, circular */
+	npy_intp head, len;
+};
+
+typedef struct
+{
+	PyObject_HEAD
+	PyObject *data;		/* (2,size) doubles */
+	npy_intp size;		/* columns of data */
+	npy_intp window;	/* 0 for unbounded */
+	npy_intp n;		/* points held */
+	long long count;	/* points appended since clear() */
+	double lim[4];		/* xmin, ymin, xmax, ymax (unbounded) */
+	struct BGL_Deque q[4];	/* deques for the same (window) */
+} BGL_RingBuffer;
+
+#define BGL_Ring(rb,row,col)\
+	(*(double *)PyArray_GETPTR2((PyArrayObject*)(rb)->data,row,col))
+
+static double
+_ring_value( BGL_RingBuffer *rb, int row, long long t )
+{
+	return BGL_Ring( rb, row, (npy_intp)(t % rb->window) );
+}
+
+static void
+_ring_reset_limits( BGL_RingBuffer *rb )
+{
+	int k;
+
+	for ( k = 0; k < 4; k++ )
+	{
+		rb->lim[k] = k < 2 ? HUGE_VAL : -HUGE_VAL;
+		rb->q[k].head = rb->q[k].len = 0;
+	}
+}
+
+/* limit k: 0,1 are minima and 2,3 maxima, of row k%2 */
+static void
+_ring_push( BGL_RingBuffer *rb, int k, long long t, double v )
+{
+	struct BGL_Deque *q = rb->q + k;
+	npy_intp w = rb->window;
+	double u;
+
+	/* drop points which have left the window */
+	while ( q->len > 0 && q->t[q->head] <= t - w )
+	{
+		q->head = (q->head + 1) % w;
+		q->len--;
+	}
+
+	if ( v != v )
+		return;
+
+	/* drop points which can no longer be the limit */
+	while ( q->len > 0 )
+	{
+		u = _ring_value( rb, k%2, q->t[(q->head + q->len - 1) % w] );
+		if ( k < 2 ? u < v : u > v )
+			break;
+		q->len--;
+	}
+
+	q->t[(q->head + q->len) % w] = t;
+	q->len++;
+}
+
+static int
+_ring_reserve( BGL_RingBuffer *rb, npy_intp n )
+{
+	PyObject *data;
+	npy_intp dims[2], size;
+
+	if ( n <= rb->size )
+		return 0;
+
+	size = BGL_MAX( BGL_MAX(2*rb->size, n), 1024 );
+	dims[0] = 2;
+	dims[1] = size;
+	if ( (data = PyArray_EMPTY(2, dims, NPY_DOUBLE, 0)) == NULL )
+		return -1;
+	if ( rb->n > 0 )
+	{
+		memcpy( PyArray_GETPTR2((PyArrayObject*)data,0,0),
+			PyArray_GETPTR2((PyArrayObject*)rb->data,0,0),
+			rb->n * sizeof(double) );
+		memcpy( PyArray_GETPTR2((PyArrayObject*)data,1,0),
+			PyArray_GETPTR2((PyArrayObject*)rb->data,1,0),
+			rb->n * sizeof(double) );
+	}
+	Py_XDECREF( rb->data );
+	rb->data = data;
+	rb->size = size;
+	return 0;
+}
+
+static void
+_ring_append( BGL_RingBuffer *rb, double x, double y )
+{
+	npy_intp p;
+	int k;
+
+	if ( rb->window == 0 )
+	{
+		BGL_Ring(rb,0,rb->n) = x;
+		BGL_Ring(rb,1,rb->n) = y;
+		rb->n++;
+		/* the comparisons are false for NaNs */
+		if ( x < rb->lim[0] ) rb->lim[0] = x;
+		if ( y < rb->lim[1] ) rb->lim[1] = y;
+		if ( x > rb->lim[2] ) rb->lim[2] = x;
+		if ( y > rb->lim[3] ) rb->lim[3] = y;
+	}
+	else
+	{
+		p = (npy_intp)(rb->count % rb->window);
+		BGL_Ring(rb,0,p) = BGL_Ring(rb,0,p+rb->window) = x;
+		BGL_Ring(rb,1,p) = BGL_Ring(rb,1,p+rb->window) = y;
+		if ( rb->n < rb->window )
+			rb->n++;
+		for ( k = 0; k < 4; k++ )
+			_ring_push( rb, k, rb->count, k%2 ? y : x );
+	}
+	rb->count++;
+}
+
+static int
+BGL_RingBuffer_init( BGL_RingBuffer *rb, PyObject *args, PyObject *kw )
+{
+	static char *kwlist[] = { "window", NULL };
+	Py_ssize_t window = 0;
+	int k;
+
+	if ( !PyArg_ParseTupleAndKeywords(args, kw, "|n", kwlist, &window) )
+		return -1;
+	if ( window < 0 )
+	{
+		PyErr_SetString( PyExc_ValueError, "window must not be negative" );
+		return -1;
+	}
+
+	Py_CLEAR( rb->data );
+	for ( k = 0; k < 4; k++ )
+	{
+		PyMem_Free( rb->q[k].t );
+		rb->q[k].t = NULL;
+	}
+	rb->size = rb->n = 0;
+	rb->count = 0;
+	rb->window = window;
+	_ring_reset_limits( rb );
+
+	if ( window > 0 )
+	{
+		if ( _ring_reserve(rb, 2*window) < 0 )
+			return -1;
+		for ( k = 0; k < 4; k++ )
+			if ( (rb->q[k].t = PyMem_New(long long, window)) == NULL )
+			{
+				PyErr_NoMemory();
+				return -1;
+			}
+	}
+	return 0;
+}
+
+static void
+BGL_RingBuffer_dealloc( BGL_RingBuffer *rb )
+{
+	int k;
+
+	Py_XDECREF( rb->data );
+	for ( k = 0; k < 4; k++ )
+		PyMem_Free( rb->q[k].t );
+	Py_TYPE(rb)->tp_free( (PyObject*)rb );
+}
+
+static PyObject *
+BGL_RingBuffer_extend( BGL_RingBuffer *rb, PyObject *args )
+{
+	PyObject *ox, *oy, *x, *y;
+	npy_intp i, n;
+	const double *px, *py;
+	PyObject *ret = NULL;
+
+	if ( !PyArg_ParseTuple(args, "OO", &ox, &oy) )
+		return NULL;
+
+	x = PyArray_ContiguousFromAny( ox, NPY_DOUBLE, 0, 1 );
+	y = PyArray_ContiguousFromAny( oy, NPY_DOUBLE, 0, 1 );
+
+	if ( x == NULL || y == NULL )
+		goto quit;
+
+	n = PyArray_SIZE((PyArrayObject*)x);
+	if ( PyArray_SIZE((PyArrayObject*)y) != n )
+	{
+		PyErr_SetString( PyExc_ValueError, "x and y differ in length" );
+		goto quit;
+	}
+	px = (const double *)PyArray_DATA((PyArrayObject*)x);
+	py = (const double *)PyArray_DATA((PyArrayObject*)y);
+
+	if ( rb->window == 0 )
+	{
+		if ( _ring_reserve(rb, rb->n + n) < 0 )
+			goto quit;
+	}
+	else if ( n > rb->window )
+	{
+		/* only the last window points are kept */
+		rb->count += n - rb->window;
+		px += n - rb->window;
+		py += n - rb->window;
+		n = rb->window;
+	}
+
+	for ( i = 0; i < n; i++ )
+		_ring_append( rb, px[i], py[i] );
+
+	Py_INCREF(Py_None);
+	ret = Py_None;
+quit:
+	Py_XDECREF(x);
+	Py_XDECREF(y);
+	return ret;
+}
+
+static PyObject *
+BGL_RingBuffer_clear( BGL_RingBuffer *rb, PyObject *args )
+{
+	rb->n = 0;
+	rb->count = 0;
+	_ring_reset_limits( rb );
+	Py_INCREF(Py_None);
+	return Py_None;
+}
+
+static PyObject *
+BGL_RingBuffer_arrays( BGL_RingBuffer *rb, PyObject *args )
+{
+	PyObject *x, *y, *ret;
+	npy_intp start = 0, stride, dims[1];
+
+	if ( rb->data == NULL && _ring_reserve(rb, 1) < 0 )
+		return NULL;
+
+	if ( rb->window > 0 )
+		start = (npy_intp)((rb->count - rb->n) % rb->window);
+
+	dims[0] = rb->n;
+	stride = sizeof(double);
+	x = PyArray_New( &PyArray_Type, 1, dims, NPY_DOUBLE, &stride,
+		PyArray_GETPTR2((PyArrayObject*)rb->data,0,start), 0,
+		NPY_ARRAY_ALIGNED, NULL );
+	y = PyArray_New( &PyArray_Type, 1, dims, NPY_DOUBLE, &stride,
+		PyArray_GETPTR2((PyArrayObject*)rb->data,1,start), 0,
+		NPY_ARRAY_ALIGNED, NULL );
+
+	ret = NULL;
+	if ( x == NULL || y == NULL )
+		goto quit;
+
+	/* the slices keep the array they point into alive */
+	Py_INCREF(rb->data);
+	if ( PyArray_SetBaseObject((PyArrayObject*)x, rb->data) < 0 )
+		goto quit;
+	Py_INCREF(rb->data);
+	if ( PyArray_SetBaseObject((PyArrayObject*)y, rb->data) < 0 )
+		goto quit;
+
+	ret = Py_BuildValue( "OO", x, y );
+quit:
+	Py_XDECREF(x);
+	Py_XDECREF(y);
+	return ret;
+}
+
+static PyObject *
+BGL_RingBuffer_limits( BGL_RingBuffer *rb, PyObject *args )
+{
+	double lim[4];
+	int k;
+
+	for ( k = 0; k < 4; k++ )
+	{
+		if ( rb->window == 0 )
+			lim[k] = rb->lim[k];
+		else if ( rb->q[k].len == 0 )
+			lim[k] = k < 2 ? HUGE_VAL : -HUGE_VAL;
+		else
+			lim[k] = _ring_value( rb, k%2, rb->q[k].t[rb->q[k].head] );
+	}
+
+	/* no points, or only NaNs */
+	if ( !(lim[0] <= lim[2] && lim[1] <= lim[3]) )
+	{
+		Py_INCREF(Py_None);
+		return Py_None;
+	}
+	return Py_BuildValue( "dddd", lim[0], lim[1], lim[2], lim[3] );
+}
+
+static Py_ssize_t
+BGL_RingBuffer_length( BGL_RingBuffer *rb )
+{
+	return rb->n;
+}
+
+static PyMethodDef BGL_RingBuffer_methods[] =
+{
+	{ "extend", (PyCFunction)BGL_RingBuffer_extend, METH_VARARGS,
+		"extend(x, y): append points, given as numbers or sequences" },
+	{ "clear", (PyCFunction)BGL_RingBuffer_clear, METH_NOARGS,
+		"clear(): remove all the points" },
+	{ "arrays", (PyCFunction)BGL_RingBuffer_arrays, METH_NOARGS,
+		"arrays(): the points held, oldest first, as views x, y" },
+	{ "limits", (PyCFunction)BGL_RingBuffer_limits, METH_NOARGS,
+		"limits(): (xmin, ymin, xmax, ymax) of the points, or None" },
+	{ NULL }
+};
+
+static PySequenceMethods BGL_RingBuffer_as_sequence =
+{
+	(lenfunc)BGL_RingBuffer_length,	/* sq_length */
+};
+
+static PyTypeObject BGL_RingBufferType =
+{
+#if PY_MAJOR_VERSION >= 3
+	PyVarObject_HEAD_INIT(NULL, 0)
+#else
+	PyObject_HEAD_INIT(NULL)
+	0,				/* ob_size */
+#endif
+	"_biggles.RingBuffer",		/* tp_name */
+	sizeof(BGL_RingBuffer),		/* tp_basicsize */
+	0,				/* tp_itemsize */
+	(destructor)BGL_RingBuffer_dealloc, /* tp_dealloc */
+	0,				/* tp_print */
+	0,				/* tp_getattr */
+	0,				/* tp_setattr */
+	0,				/* tp_compare */
+	0,				/* tp_repr */
+	0,				/* tp_as_number */
+	&BGL_RingBuffer_as_sequence,	/* tp_as_sequence */
+	0,				/* tp_as_mapping */
+	0,				/* tp_hash */
+	0,				/* tp_call */
+	0,				/* tp_str */
+	0,				/* tp_getattro */
+	0,				/* tp_setattro */
+	0,				/* tp_as_buffer */
+	Py_TPFLAGS_DEFAULT,		/* tp_flags */
+	"RingBuffer(window=0): x,y points, all of them, or the last window",
+	0,				/* tp_traverse */
+	0,				/* tp_clear */
+	0,				/* tp_richcompare */
+	0,				/* tp_weaklistoffset */
+	0,				/* tp_iter */
+	0,				/* tp_iternext */
+	BGL_RingBuffer_methods,		/* tp_methods */
+	0,				/* tp_members */
+	0,				/* tp_getset */
+	0,				/* tp_base */
+	0,				/* tp_dict */
+	0,				/* tp_descr_get */
+	0,				/* tp_descr_set */
+	0,				/* tp_dictoffset */
+	(initproc)BGL_RingBuffer_init,	/* tp_init */
+	0,				/* tp_alloc */
+	PyType_GenericNew,		/* tp_new */
+};
+
 /******************************************************************************
  *  module init
  */
@@ -443,7 +1423,7 @@ static PyMethodDef BigglesMethods[] =
 {
 
 	/* contour.py */
-	{ "contour_segments", biggles_contour_segments, METH_VARARGS },
+	{ "contour_lines", biggles_contour_lines, METH_VARARGS },
 
 	/* hammer.py */
 	{ "hammer_call", biggles_hammer_call, METH_VARARGS },
@@ -451,6 +1431,10 @@ static PyMethodDef BigglesMethods[] =
 	{ "hammer_connect", biggles_hammer_connect, METH_VARARGS },
 	{ "hammer_geodesic_fill", biggles_hammer_geodesic_fill, METH_VARARGS },
 
+	/* biggles.py */
+	{ "decimate", biggles_decimate, METH_VARARGS },
+	{ "geom_call_vec", biggles_geom_call_vec, METH_VARARGS },
+
 	{ NULL, NULL }
 };
 
@@ -497,6 +1481,17 @@ init_biggles(void)
 #endif
 
     import_array();
+
+    if (PyType_Ready(&BGL_RingBufferType) < 0) {
+#if PY_MAJOR_VERSION >= 3
+        return NULL;
+#else
+        return;
+#endif
+    }
+    Py_INCREF(&BGL_RingBufferType);
+    PyModule_AddObject(m, "RingBuffer", (PyObject *)&BGL_RingBufferType);
+
 #if PY_MAJOR_VERSION >= 3
     return m;
 #endif
@@ -26,6 +26,7 @@ import os
 import numpy
 import tempfile
 import warnings
+import weakref
 
 from . import config, _biggles
 from geometry import *
@@ -160,6 +161,12 @@ class _PlotGeometry(object):
     def call_vec(self, x, y):
         u = numpy.asarray(x)
         v = numpy.asarray(y)
+        if u.shape == v.shape:
+            # log scaling and affine map in a single pass
+            t, m = self.aff.t, self.aff.m
+            return _biggles.geom_call_vec(
+                u, v, bool(self.xlog), bool(self.ylog),
+                t[0], t[1], m[0][0], m[0][1], m[1][0], m[1][1])
         if self.xlog:
             u = self._logfunc_vec(u)
         if self.ylog:
@@ -181,6 +188,12 @@ class _PlotContext(object):
         self.geom = _PlotGeometry(data, dev, xlog=xlog, ylog=ylog)
         self.plot_geom = _PlotGeometry(BoundingBox((0, 0), (1, 1)), dev)
 
+    def layout_key(self):
+        # a weak reference, so that a cached layout doesn't keep the
+        # device (and any output it only writes when deleted) alive
+        return (weakref.ref(self.draw), self.dev_bbox.p0, self.dev_bbox.p1,
+                self.data_bbox.p0, self.data_bbox.p1, self.xlog, self.ylog)
+
     def do_clip(self):
         xr = self.dev_bbox.xrange()
         yr = self.dev_bbox.yrange()
@@ -656,6 +669,23 @@ class _ArcObject(_DeviceObject):
 
 
 class _PlotComponent(_StyleKeywords, _ConfAttributes):
+    """
+    Base class for plot components.
+
+    The device objects built by make() are kept between calls to bbox()
+    and render() with the same plot context, and limits() is computed
+    once.  Both are discarded when an attribute or style keyword is set;
+    call invalidate() after modifying data arrays in place.  Components
+    whose make() depends on other objects set layout_cached to False.
+    Each invalidation bumps the generation, which retained plots use to
+    tell which components changed since they were last drawn.
+    """
+
+    layout_cached = True
+
+    _layout_key = None
+    _layout_limits = None
+    _generation = 0
 
     def __init__(self, **kw):
         label=kw.get('label',None)
@@ -664,6 +694,20 @@ class _PlotComponent(_StyleKeywords, _ConfAttributes):
 
         self.clear()
 
+    def __setattr__(self, name, value):
+        object.__setattr__(self, name, value)
+        if name != "device_objects":
+            self.invalidate()
+
+    def kw_set(self, key, value):
+        _StyleKeywords.kw_set(self, key, value)
+        self.invalidate()
+
+    def invalidate(self):
+        self.__dict__["_layout_key"] = None
+        self.__dict__["_layout_limits"] = None
+        self.__dict__["_generation"] = self._generation + 1
+
     def add(self, *args):
         for obj in args:
             self.device_objects.append(obj)
@@ -680,17 +724,29 @@ class _PlotComponent(_StyleKeywords, _ConfAttributes):
     def make_key(self, bbox):
         pass
 
+    def cached_limits(self):
+        if self._layout_limits is None:
+            self.__dict__["_layout_limits"] = self.limits()
+        return copy.copy(self._layout_limits)
+
+    def layout(self, context):
+        key = None
+        if self.layout_cached and hasattr(context, "layout_key"):
+            key = context.layout_key()
+        if key is None or key != self._layout_key:
+            self.clear()
+            self.make(context)
+            self.__dict__["_layout_key"] = key
+
     def bbox(self, context):
-        self.clear()
-        self.make(context)
+        self.layout(context)
         bb = BoundingBox()
         for obj in self.device_objects:
             bb.union(obj.bbox(context))
         return bb
 
     def render(self, context):
-        self.clear()
-        self.make(context)
+        self.layout(context)
         self.kw_predraw(context)
         for obj in self.device_objects:
             obj.render(context)
@@ -821,18 +877,91 @@ class Curve(_LineComponent):
         self.x = x
         self.y = y
 
+    def set_data(self, x, y):
+        """
+        Replace the points of the curve.  In a retained plot only the
+        curve is drawn again.
+        """
+        self.x = x
+        self.y = y
+
     def limits(self):
         p0 = min(self.x), min(self.y)
         p1 = max(self.x), max(self.y)
         return BoundingBox(p0, p1)
 
     def make(self, context):
+        tol = None
+        if self.decimate:
+            tol = getattr(context.draw, "resolution", None)
         segs = context.geom.geodesic(self.x, self.y)
         for seg in segs:
             x, y = context.geom.call_vec(seg[0], seg[1])
+            if tol is not None:
+                x, y = _biggles.decimate(x, y, tol)
             self.add(_PathObject(x, y))
 
 
+class StreamingCurve(Curve):
+    """
+    A curve whose points arrive over time.  The points are kept in a
+    buffer, which append() extends in amortized constant time, and
+    which keeps the limits up to date as it goes.  The curve is drawn
+    from the buffer without copying it.
+
+    parameters
+    ----------
+    x: array or sequence, optional
+            The "x" values of the initial points.
+    y: array or sequence, optional
+            The "y" values of the initial points.
+    window: int, optional
+            Keep only the last window points; by default all are kept.
+
+    **keywords
+            Style and other keywords, as for Curve.
+    """
+
+    def __init__(self, x=(), y=(), window=0, **kw):
+        _LineComponent.__init__(self, **kw)
+        self.conf_setattr("Curve")
+        self.kw_init(kw)
+        self.buffer = _biggles.RingBuffer(window)
+        self.buffer.extend(x, y)
+
+    @property
+    def x(self):
+        return self.buffer.arrays()[0]
+
+    @property
+    def y(self):
+        return self.buffer.arrays()[1]
+
+    def __len__(self):
+        return len(self.buffer)
+
+    def append(self, x, y):
+        """
+        Add a point, or sequences of points, to the end of the curve.
+        """
+        self.buffer.extend(x, y)
+        self.invalidate()
+
+    def set_data(self, x, y):
+        self.buffer.clear()
+        self.append(x, y)
+
+    def limits(self):
+        lim = self.buffer.limits()
+        if lim is None:
+            return BoundingBox()
+        return BoundingBox(lim[:2], lim[2:])
+
+    def make(self, context):
+        if len(self.buffer) > 0:
+            Curve.make(self, context)
+
+
 class DataLine(_LineComponent):
 
     def __init__(self, p, q, **kw):
@@ -1205,6 +1334,13 @@ class Points(_SymbolDataComponent):
         self.x = x
         self.y = y
 
+    def set_data(self, x, y):
+        """
+        Replace the points.  In a retained plot only the points are
+        drawn again.
+        """
+        self._set_xy(x, y)
+
     def limits(self):
         p = min(self.x), min(self.y)
         q = max(self.x), max(self.y)
@@ -1865,6 +2001,9 @@ class PlotKey(_PlotComponent):
         'valign': 'textvalign',
     }
 
+    # the key is built from the style of other components
+    layout_cached = False
+
     def __init__(self, x, y, components=None, **kw):
 
         # plot keys don't get labels
@@ -2083,6 +2222,9 @@ class _HalfAxis(_PlotComponent):
     func_subticks_default = _subticks_linear, _subticks_log
     func_subticks_num = _subticks_linear, _subticks_log
 
+    # style dicts are often updated in place, which doesn't invalidate
+    layout_cached = False
+
     _attr_map = {
         'labeloffset': 'label_offset',
         'major_ticklabels': 'ticklabels',
@@ -2104,6 +2246,19 @@ class _HalfAxis(_PlotComponent):
 
     def __setattr__(self, name, value):
         self.__dict__[self._attr_map.get(name, name)] = value
+        if name != "device_objects":
+            self.invalidate()
+
+    def state_key(self):
+        """
+        A snapshot of the attributes the axis is drawn from, including
+        style dicts updated in place; used to tell when a retained
+        FramedPlot must redraw its frame.
+        """
+        skip = ("device_objects", "_layout_key", "_layout_limits",
+                "_generation")
+        return repr(sorted((k, v) for k, v in self.__dict__.items()
+                           if k not in skip))
 
     def _ticks(self, context):
         log = self._log(context)
@@ -2335,6 +2490,9 @@ class _HalfAxisY(_HalfAxis):
 
 class _BoxLabel(_PlotComponent):
 
+    # placed relative to the device objects of another component
+    layout_cached = False
+
     kw_rename = {
         'face': 'fontface',
         'size': 'fontsize',
@@ -2396,7 +2554,10 @@ class _PlotComposite(_StyleKeywords):
     def limits(self):
         bb = BoundingBox()
         for obj in self.components:
-            bb.union(obj.limits())
+            if isinstance(obj, _PlotComponent):
+                bb.union(obj.cached_limits())
+            else:
+                bb.union(obj.limits())
         return bb
 
     def make(self, context):
@@ -2409,12 +2570,15 @@ class _PlotComposite(_StyleKeywords):
             bb.union(obj.bbox(context))
         return bb
 
-    def render(self, context):
+    def render(self, context, components=None):
+        # components: the subset of self.components to draw, in order
         self.make(context)
+        if components is None:
+            components = self.components
         self.kw_predraw(context)
         if not self.dont_clip:
             context.do_clip()
-        for obj in self.components:
+        for obj in components:
             obj.render(context)
         self.kw_postdraw(context)
 
@@ -2560,17 +2724,33 @@ class _PlotContainer(_ConfAttributes):
             style["textvalign"] = "bottom"
             _draw_text(device, (x, y), self.title, **style)
 
-    def compose(self, device, region):
-        if self.empty():
-            raise BigglesError("empty container")
+    def _interior(self, device, region):
         exterior = region.copy()
         if self.title is not None:
             offset = _size_relative(self.title_offset, exterior)
             fontsize = _fontsize_relative(
                 self.title_style["fontsize"], exterior, device)
             exterior.deform(-offset - fontsize, 0, 0, 0)
-        interior = self.interior(device, exterior)
-        self.compose_interior(device, interior)
+        return self.interior(device, exterior)
+
+    def compose(self, device, region):
+        if self.empty():
+            raise BigglesError("empty container")
+        self.compose_interior(device, self._interior(device, region))
+
+    def _layout_cell(self, device, region):
+        """
+        Lay out compose(device, region) ahead of drawing it, e.g. on a
+        tile.  Returns the bounding box drawn into, which is larger than
+        region if the plot doesn't fit, and a function drawing the plot
+        on a device.
+        """
+        if self.empty():
+            raise BigglesError("empty container")
+        interior = self._interior(device, region)
+        extent = region.copy()
+        extent.union(self.exterior(device, interior))
+        return extent, lambda dev: self.compose_interior(dev, interior)
 
     def page_compose(self, device, extra_config=None):
         device.open()
@@ -2667,7 +2847,8 @@ class _PlotContainer(_ConfAttributes):
     def write_eps(self, outfile, **kw):
         """
         write the plot to postscript. Extra keywords can be
-        sent
+        sent.  If outfile is None the postscript is returned
+        as bytes
         """
         from .libplot.renderer import PSRenderer
 
@@ -2677,6 +2858,28 @@ class _PlotContainer(_ConfAttributes):
 
         with PSRenderer(outfile, **opt) as device:
             self.page_compose(device)
+            if outfile is None:
+                return device.getvalue()
+
+    def write_svg(self, outfile, **kw):
+        """
+        write the plot to svg, with the page size of the postscript
+        writer.  If outfile is None the svg is returned as bytes.
+        The decimals, relative and merge keywords, defaulting to the
+        [svg] config section, make the path data more compact
+        """
+        from .libplot.renderer import SVGRenderer
+
+        opt = copy.copy(config.options("postscript"))
+        if 'paper' in kw:
+            opt['paper'] = kw['paper']
+        for key in ('decimals', 'relative', 'merge'):
+            opt[key] = kw.get(key, config.value('svg', key))
+
+        with SVGRenderer(outfile, **opt) as device:
+            self.page_compose(device)
+            if outfile is None:
+                return device.getvalue()
 
     def write_pdf(self, pdfname, **kw):
         """
@@ -2722,16 +2925,21 @@ class _PlotContainer(_ConfAttributes):
 
     def write(self, outfile, **kw):
         """
-        write PDF, EPS, or image files with antialiasing
+        write PDF, EPS, SVG, or image files with antialiasing
 
         parameters
         ----------
         outfile: string
             Output file name
         type: string, optional
-            File type, e.g. pdf, eps, png, jpg
+            File type, e.g. pdf, eps, svg, png, jpg
         dpi: int, optional
             Optional dpi for image output, default 100
+        antialias: int, optional
+            Supersampling factor for png output, default 4
+        threads: int, optional
+            Worker threads rasterizing the panels of a Table or
+            FramedArray for png output, default 1
         **kw: keywords
             Other keywords for the eps writer
         """
@@ -2746,9 +2954,63 @@ class _PlotContainer(_ConfAttributes):
             self.write_eps(outfile, **kw)
         elif type == 'pdf':
             self.write_pdf(outfile, **kw)
+        elif type == 'svg':
+            self.write_svg(outfile, **kw)
+        elif type == 'png':
+            self._write_img_antialiased(type, outfile, **kw)
         else:
             self._write_img_from_eps(type, outfile, **kw)
 
+    def write_bytes(self, type='png', **kw):
+        """
+        render the plot in memory and return the file contents as
+        bytes, without touching the filesystem
+
+        parameters
+        ----------
+        type: string, optional
+            File type: png, eps or svg.  Default png
+        dpi: int, optional
+            Optional dpi for png output, default 100
+        **kw: keywords
+            Other keywords for the writers
+        """
+        type = type.lower()
+        if type == 'eps':
+            return self.write_eps(None, **kw)
+        elif type == 'svg':
+            return self.write_svg(None, **kw)
+        elif type == 'png':
+            return self._write_img_antialiased(type, None, **kw)
+        else:
+            raise NotImplementedError(
+                "in-memory output supports png, eps and svg")
+
+    def _write_img_antialiased(self, type, outfile, **kw):
+        """
+        render directly with libplot's anti-aliased bitmap plotter,
+        using the same page size as the eps writer
+        """
+        from .libplot.renderer import ImageRenderer, _str_size_to_pts
+
+        default_dpi = config.value('image','dpi')
+        dpi = kw.pop('dpi', default_dpi)
+        antialias = kw.pop('antialias', config.value('image','antialias'))
+        threads = kw.pop('threads', config.value('image','threads'))
+
+        opt = config.options("postscript")
+        width = int(round(_str_size_to_pts(opt['width']) * dpi / 72.))
+        height = int(round(_str_size_to_pts(opt['height']) * dpi / 72.))
+
+        bgcolor = config.value('default','bgcolor')
+
+        with ImageRenderer(type, width, height, outfile,
+                           bgcolor=bgcolor, antialias=antialias,
+                           threads=threads) as device:
+            self.page_compose(device)
+            if outfile is None:
+                return device.getvalue()
+
     def _write_img_from_eps(self, type, outfile, **kw):
 
         default_dpi = config.value('image','dpi')
@@ -2807,22 +3069,12 @@ class _PlotContainer(_ConfAttributes):
         """
         for jupyter notebook inline display
         """
-        import subprocess
-        import time
-        import io
-
         if hasattr(self,'dpi'):
             dpi=self.dpi
         else:
             dpi=55
 
-        fname = tempfile.mktemp(suffix='_biggles.png')
-        self.write(fname,dpi=dpi)
-
-        with open(fname,'rb') as fobj:
-            data=fobj.read()
-        os.unlink(fname)
-        return data
+        return self.write_bytes('png', dpi=dpi)
 
     def write_img(self, *args, **kw):
         """
@@ -2890,18 +3142,27 @@ class _PlotContainer(_ConfAttributes):
 
     def write_back_png(self, *args):
         """
-        Saves PNG file in temporary file. Returns file contents.
+        Renders a non-antialiased PNG in memory. Returns file contents.
         """
+        from .libplot.renderer import ImageRenderer
+
         if len(args) == 2:
             width, height = args
         type = 'png'
-        file = tempfile.mktemp('_biggles.png')
-        self.write_img(type, width, height, file)
-        f = open(file, 'rb')
-        output = f.read()
-        f.close()
-        os.remove(file)
-        return output
+
+        bgcolor    = config.value('default','bgcolor')
+        sc_bgcolor = config.value('image_noaa','bgcolor')
+        if sc_bgcolor is not None:
+            bgcolor = sc_bgcolor
+
+        extra_config={}
+        color = config.value('image_noaa','color')
+        if color is not None:
+            extra_config['color'] = color
+
+        with ImageRenderer(type, width, height, None, bgcolor=bgcolor) as device:
+            self.page_compose(device, extra_config=extra_config)
+            return device.getvalue()
 
 
 def multipage(plots, filename, **kw):
@@ -2915,11 +3176,13 @@ def multipage(plots, filename, **kw):
     filename: string
         The file for the postscript file.
     **kw:
-        Extra keywords
+        Extra keywords.  streaming=False holds all the pages in memory
+        until the end, instead of writing each one out as it is done.
     """
     from .libplot.renderer import PSRenderer
 
     opt = copy.copy(config.options("postscript"))
+    opt['streaming'] = True
     opt.update(kw)
 
     with PSRenderer(filename, **opt) as device:
@@ -3010,8 +3273,11 @@ class Plot(_PlotContainer):
                                xlog=self.xlog, ylog=self.ylog)
         self.content.render(context)
 
+    def _interior(self, device, region):
+        return self.interior(device, region)
+
     def compose(self, device, region, limits=None):
-        interior = self.interior(device, region)
+        interior = self._interior(device, region)
         self.compose_interior(device, interior, limits)
 
 # FramedPlot ------------------------------------------------------------------
@@ -3055,6 +3321,13 @@ class FramedPlot(_PlotContainer):
         user can still add PlotKey instances to the plot
         as normal using .add(key)
 
+    retained: bool
+        Set True to keep the rendered frame, title and unchanged
+        components as a background image between anti-aliased image
+        renders.  Components changed since the previous render, e.g.
+        with Curve.set_data(), are then drawn over that background,
+        on top of the frame.  Other devices draw the whole plot.
+
     """
 
     def __init__(self, **kw):
@@ -3063,6 +3336,11 @@ class FramedPlot(_PlotContainer):
         self.content1 = _PlotComposite()
         self.content2 = _PlotComposite()
 
+        # retained mode state, see _compose_retained()
+        self._retained_seen = {}
+        self._retained_dynamic = set()
+        self._retained_page = None
+
         # the user can send a key, and things are added to it
         key = kw.pop('key', None)
         if key is not None:
@@ -3220,17 +3498,97 @@ class FramedPlot(_PlotContainer):
 
     def compose_interior(self, device, region):
         _PlotContainer.compose_interior(self, device, region)
+        self._compose_layers(device, region)
 
+    def _compose_layers(self, device, region,
+                        components1=None, components2=None, frame=True):
         context1 = self._context1(device, region)
         context2 = self._context2(device, region)
 
-        self.content1.render(context1)
-        self.content2.render(context2)
+        if components1 is None or components1:
+            self.content1.render(context1, components1)
+        if components2 is None or components2:
+            self.content2.render(context2, components2)
 
-        self.y2.render(context2)
-        self.x2.render(context2)
-        self.y1.render(context1)
-        self.x1.render(context1)
+        if frame:
+            self.y2.render(context2)
+            self.x2.render(context2)
+            self.y1.render(context1)
+            self.x1.render(context1)
+
+    def compose(self, device, region):
+        if self.retained and hasattr(device, "tile"):
+            self._compose_retained(device, region)
+        else:
+            _PlotContainer.compose(self, device, region)
+
+    def _retained_layers(self, composite, seen):
+        """
+        Split the components of composite into static ones, kept in the
+        background image, and dynamic ones, drawn over it on every page;
+        records what was seen of each component.
+        A component becomes dynamic once its generation changes between
+        two pages.  Components which don't track their changes are
+        always dynamic.
+        """
+        static, dynamic = [], []
+        for obj in composite.components:
+            gen = None
+            if isinstance(obj, _PlotComponent) and obj.layout_cached:
+                gen = obj._generation
+                prev = self._retained_seen.get(id(obj))
+                if prev is not None and prev[0] is obj and prev[1] != gen:
+                    self._retained_dynamic.add(id(obj))
+            else:
+                self._retained_dynamic.add(id(obj))
+            seen[id(obj)] = obj, gen
+            if id(obj) in self._retained_dynamic:
+                dynamic.append(obj)
+            else:
+                static.append((obj, gen))
+        return static, dynamic
+
+    def _compose_retained(self, device, region):
+        if self.empty():
+            raise BigglesError("empty container")
+
+        seen = {}
+        static1, dynamic1 = self._retained_layers(self.content1, seen)
+        static2, dynamic2 = self._retained_layers(self.content2, seen)
+        self._retained_seen = seen
+        self._retained_dynamic &= set(seen)
+
+        # the page layout depends on the limits of all the components,
+        # and on the axes and title
+        limits1 = self._limits1()
+        limits2 = self._limits2()
+        layout_key = (device.page_key(), region.p0, region.p1,
+                      limits1.p0, limits1.p1, limits2.p0, limits2.p1,
+                      self.x1.state_key(), self.x2.state_key(),
+                      self.y1.state_key(), self.y2.state_key(),
+                      self.title, repr(self.title_style),
+                      self.title_offset, self.aspect_ratio)
+        background_key = ([(id(obj), gen) for obj, gen in static1],
+                          [(id(obj), gen) for obj, gen in static2],
+                          [id(obj) for obj in dynamic1 + dynamic2])
+
+        page = self._retained_page
+        if page is None or page[0] != layout_key:
+            page = layout_key, self._interior(device, region), None, None
+        interior = page[1]
+
+        if page[2] != background_key:
+            tile = device.tile(device.lowerleft, device.upperright)
+            _PlotContainer.compose_interior(self, tile, interior)
+            self._compose_layers(tile, interior,
+                                 [obj for obj, gen in static1],
+                                 [obj for obj, gen in static2])
+            page = layout_key, interior, background_key, device.snapshot(tile)
+        self._retained_page = page
+
+        device.paste(page[3])
+        self._compose_layers(device, interior, dynamic1, dynamic2,
+                             frame=False)
 
 
 class OldCustomFramedPlot(FramedPlot):
@@ -3286,6 +3644,137 @@ class _Grid(object):
         q = pt_add(p, cell_dimen)
         return BoundingBox(p, q)
 
+    def tile(self, i, j, outer):
+        """
+        The part of the grid belonging to cell i,j: the cell grown to the
+        middle of the spacing around it, and out to the outer bounding box
+        along the edges of the grid.  The tiles of a grid don't overlap.
+        """
+        cell = self.cell(i, j)
+        m = 0.5 * self.cs + self.cp
+        x0, y0 = pt_sub(cell.lowerleft(), (m, m))
+        x1, y1 = pt_add(cell.upperright(), (m, m))
+        if j == 0:
+            x0 = min(x0, outer.xrange()[0])
+        if j == self.ncols - 1:
+            x1 = max(x1, outer.xrange()[1])
+        if i == self.nrows - 1:
+            y0 = min(y0, outer.yrange()[0])
+        if i == 0:
+            y1 = max(y1, outer.yrange()[1])
+        return BoundingBox((x0, y0), (x1, y1))
+
+
+def _reachable(obj):
+    """
+    ids of the plot objects reachable from obj; these may be modified
+    while obj is composed.
+    """
+    kinds = (_PlotComponent, _PlotComposite, _PlotContainer, _Inset)
+    found = set()
+    stack = [obj]
+    while stack:
+        o = stack.pop()
+        if isinstance(o, (list, tuple)):
+            stack.extend(o)
+        elif isinstance(o, dict):
+            stack.extend(o.values())
+        elif isinstance(o, kinds) and id(o) not in found:
+            found.add(id(o))
+            stack.extend(o.__dict__.values())
+    return found
+
+
+def _independent_groups(objs):
+    """
+    Partition the indices of objs into groups that share no plot objects
+    (e.g. a curve added to every panel of a FramedArray).
+    """
+    owner = {}
+    parent = list(range(len(objs)))
+
+    def find(k):
+        while parent[k] != k:
+            parent[k] = parent[parent[k]]
+            k = parent[k]
+        return k
+
+    for k, obj in enumerate(objs):
+        for oid in _reachable(obj):
+            other = owner.setdefault(oid, k)
+            parent[find(other)] = find(k)
+
+    groups = {}
+    for k in range(len(objs)):
+        groups.setdefault(find(k), []).append(k)
+    return sorted(groups.values())
+
+
+def _tiles_overlap(tiles):
+    for k, a in enumerate(tiles):
+        for b in tiles[:k]:
+            if a.lowerleft[0] < b.upperright[0] \
+                    and b.lowerleft[0] < a.upperright[0] \
+                    and a.lowerleft[1] < b.upperright[1] \
+                    and b.lowerleft[1] < a.upperright[1]:
+                return True
+    return False
+
+
+def _compose_cells(device, cells):
+    """
+    Compose the cells of a table, each a tuple (obj, extent, draw) where
+    draw(device) draws obj within the bounding box extent.
+
+    On bitmap devices with threads > 1 each cell is rasterized into its
+    own canvas by a pool of worker threads, and the tiles are then copied
+    onto the page.  Cells sharing plot objects go to the same worker.
+    If the cells overlap they are drawn on the page one after another.
+    """
+    threads = getattr(device, "threads", 1)
+    tiles = None
+    if threads > 1 and len(cells) > 1:
+        tiles = [device.tile(cell[1].lowerleft(), cell[1].upperright())
+                 for cell in cells]
+        if _tiles_overlap(tiles):
+            tiles = None
+
+    if tiles is None:
+        for obj, extent, draw in cells:
+            draw(device)
+        return
+
+    import threading
+
+    groups = _independent_groups([cell[0] for cell in cells])
+    errors = []
+    lock = threading.Lock()
+
+    def work():
+        while True:
+            with lock:
+                if not groups or errors:
+                    return
+                group = groups.pop()
+            try:
+                for k in group:
+                    cells[k][2](tiles[k])
+            except Exception as e:
+                with lock:
+                    errors.append(e)
+
+    workers = [threading.Thread(target=work)
+               for i in range(min(threads, len(groups)))]
+    for w in workers:
+        w.start()
+    for w in workers:
+        w.join()
+    if errors:
+        raise errors[0]
+
+    for tile in tiles:
+        device.blit(tile)
+
 
 class Table(_PlotContainer):
     """
@@ -3346,12 +3835,18 @@ class Table(_PlotContainer):
             col_fractions=self.col_fractions,
         )
 
+        if self.align_interiors:
+            # the cells draw outside their share of the grid
+            for key, obj in self.content.items():
+                obj.compose_interior(device, g.cell(*key))
+            return
+
+        cells = []
         for key, obj in self.content.items():
-            subregion = g.cell(*key)
-            if self.align_interiors:
-                obj.compose_interior(device, subregion)
-            else:
-                obj.compose(device, subregion)
+            extent, draw = obj._layout_cell(device, g.cell(*key))
+            extent.union(g.tile(key[0], key[1], interior))
+            cells.append((obj, extent, draw))
+        _compose_cells(device, cells)
 
 # FramedArray -----------------------------------------------------------------
 #
@@ -3612,12 +4107,18 @@ class FramedArray(_PlotContainer):
 
     def _data_draw(self, device, interior):
         g = self._grid(interior)
+        outer = self._frames_bbox(device, interior)
 
+        cells = []
         for key, obj in self.content.items():
             if self[key].visible:
                 subregion = g.cell(*key)
                 limits = self._limits(*key)
-                obj.compose_interior(device, subregion, limits)
+                cells.append((obj, g.tile(key[0], key[1], outer),
+                              lambda dev, obj=obj, subregion=subregion,
+                              limits=limits:
+                              obj.compose_interior(dev, subregion, limits)))
+        _compose_cells(device, cells)
 
     def _labels_draw(self, device, interior):
         bb = self._frames_bbox(device, interior)
@@ -3676,6 +4177,9 @@ class Text(_PlotContainer):
         if self.lines[-1] == '':
             del self.lines[-1]
 
+    def _layout_cell(self, device, region):
+        return region.copy(), lambda dev: self.compose(dev, region)
+
     def compose(self, device, region):
         device.save_state()
         context = _PlotContext(device, region, region)
@@ -62,6 +62,16 @@ height          = 640
 
 dpi = 100
 
+# supersampling factor for anti-aliased png output, rendered
+# natively by libplot; can be over-ridden through the antialias= keyword
+
+antialias = 4
+
+# worker threads rasterizing the panels of a Table or FramedArray,
+# each into its own tile; can be over-ridden through the threads= keyword
+
+threads = 1
+
 # --------------------------------------------------
 # non-antialiased images
 
@@ -91,6 +101,18 @@ paper           = letter
 width           = 7.5in
 height          = 7.5in
 
+# --------------------------------------------------
+[svg]
+
+# compact path data, e.g. for plots embedded in web pages: round
+# coordinates to this many decimal places of the page size (None
+# means full precision), write lines as relative moves, and merge
+# consecutive lines drawn in the same style into a single <path>
+
+decimals        = None
+relative        = 0
+merge           = 0
+
 # --------------------------------------------------
 # default object parameters
 #
@@ -101,6 +123,10 @@ func_linetype   = None
 func_linewidth  = None
 levels          = 10
 
+[Curve]
+# thin curves with many more points than the device has pixel columns
+decimate        = 1
+
 [FramedArray]
 cellspacing     = 0.0
 gutter          = 0.1
@@ -115,6 +141,9 @@ frame.grid_style  = {linetype: dot}
 frame.tickdir     = -1
 frame1.draw_grid  = 0
 gutter            = 0.1
+# keep the frame and unchanged components as a cached background image
+# between renders, redrawing only the components that changed
+retained          = 0
 xlog              = 0
 ylog              = 0
 
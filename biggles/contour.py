@@ -33,25 +33,6 @@ def _span(a, b, n):
     return a + float(b - a) * numpy.arange(0, n, 1, numpy.Float) / (n - 1)
 
 
-def _pop2(x, i, j):
-    if i < j:
-        b = x.pop(j)
-        a = x.pop(i)
-    elif i > j:
-        a = x.pop(i)
-        b = x.pop(j)
-    return a, b
-
-
-def _unzip(line):
-    x = []
-    y = []
-    for x0, y0 in line:
-        x.append(x0)
-        y.append(y0)
-    return x, y
-
-
 class Contour(_LineComponent):
     """
     Object representing a contour
@@ -65,6 +46,8 @@ class Contour(_LineComponent):
         self.y = y
         self.z = z
         self.z0 = z0
+        # set by Contours, which computes all of its levels at once
+        self.lines = None
 
     def limits(self):
         p = min(self.x), min(self.y)
@@ -72,65 +55,21 @@ class Contour(_LineComponent):
         return BoundingBox(p, q)
 
     def _get_contours(self):
-        segs = _biggles.contour_segments(
-            self.x, self.y, self.z, self.z0)
-        open = [[segs[0][0], segs[0][1]]]
-        closed = []
-        for a, b in segs[1:]:
-            xxx = []
-            for i in range(len(open)):
-                begin = open[i][0]
-                end = open[i][-1]
-                if a == begin:
-                    xxx.append((i, 0, b))
-                elif a == end:
-                    xxx.append((i, 1, b))
-                if b == begin:
-                    xxx.append((i, 0, a))
-                elif b == end:
-                    xxx.append((i, 1, a))
-            if len(xxx) == 0:
-                open.append([a, b])
-            elif len(xxx) == 1:
-                i, end, pt = xxx[0]
-                if end == 0:
-                    open[i].insert(0, pt)
-                else:
-                    open[i].append(pt)
-            elif len(xxx) == 2:
-                i0, end0, pt0 = xxx[0]
-                i1, end1, pt1 = xxx[1]
-                if i0 == i1:
-                    # closed
-                    l0 = open.pop(i0)
-                    l0.append(l0[0])
-                    closed.append(l0)
-                else:
-                    l0, l1 = _pop2(open, i0, i1)
-                    m = None
-                    if end0 == 1 and end1 == 0:
-                        m = l0 + l1
-                    elif end0 == 0 and end1 == 1:
-                        m = l1 + l0
-                    elif end0 == 0 and end1 == 0:
-                        l0.reverse()
-                        m = l0 + l1
-                    elif end0 == 1 and end1 == 1:
-                        l1.reverse()
-                        m = l0 + l1
-                    if m is not None:
-                        open.append(m)
-                    else:
-                        _message("contour: m is None")
-            elif len(xxx) > 2:
-                _message("contour: len(xxx) > 2")
-        return open + closed
+        """
+        Returns (verts, offsets): the contour lines are
+        verts[offsets[k]:offsets[k+1]], for each k.
+        """
+        if self.lines is not None:
+            return self.lines
+        verts, offsets, level_offsets = _biggles.contour_lines(
+            self.x, self.y, self.z, [self.z0])
+        return verts, offsets
 
     def make(self, context):
-        lines = self._get_contours()
-        for line in lines:
-            x, y = _unzip(line)
-            u, v = context.geom.call_vec(x, y)
+        verts, offsets = self._get_contours()
+        for k in range(len(offsets) - 1):
+            line = verts[offsets[k]:offsets[k + 1]]
+            u, v = context.geom.call_vec(line[:, 0], line[:, 1])
             self.add(_PathObject(u, v))
 
 
@@ -235,6 +174,9 @@ class Contours(_PlotComponent):
         if type(widthfunc) == type(""):
             widthfunc = self._named_func_linewidth[widthfunc]
 
+        verts, offsets, level_offsets = _biggles.contour_lines(
+            x, y, z, levels)
+
         nlevels = len(levels)
         for i in range(nlevels):
             kw = {}
@@ -257,6 +199,8 @@ class Contours(_PlotComponent):
                     kw["linewidth"] = linewidth
             c = Contour(x, y, z, z0, **kw)
             #c = apply( Contour, (x, y, z, z0), kw )
+            lo, hi = level_offsets[i], level_offsets[i + 1]
+            c.lines = verts, offsets[lo:hi + 1]
             self.add(c)
 
     def make_key(self, bbox):
@@ -30,6 +30,7 @@
 #
 from __future__ import print_function
 import math
+import weakref
 from biggles import \
     _series, _PlotComposite, _PlotGeometry, _PlotContainer, Geodesic, Curve
 from geometry import *
@@ -78,6 +79,12 @@ class _HammerAitoffContext(object):
         self.geom = _HammerAitoffGeometry(dev, l0, b0, rot)
         self.plot_geom = _PlotGeometry(BoundingBox((0, 0), (1, 1)), dev)
 
+    def layout_key(self):
+        # weak, like _PlotContext.layout_key
+        g = self.geom
+        return (weakref.ref(self.draw), self.dev_bbox.p0, self.dev_bbox.p1,
+                g.l0, g.b0, g.rot)
+
     def do_clip(self):
         pass
 
@@ -21,6 +21,7 @@
  */
 
 #include <Python.h>
+#include <pythread.h>
 #include <math.h>
 #include <plot.h>
 
@@ -48,6 +49,177 @@ typedef int bool_t;
 #define BGL_MIN(a,b) (((a) < (b)) ? (a) : (b))
 #define BGL_MAX(a,b) (((a) > (b)) ? (a) : (b))
 
+/*****************************************************************************
+ *  1-d input vectors
+ *
+ *  Aligned float64, float32, int32 and int64 arrays in native byte order
+ *  are read in place, following their strides, so column slices and
+ *  float32 data are drawn without a copy.  Anything else is converted to
+ *  a double array.
+ */
+
+struct BGL_Vec {
+    PyObject *arr;
+    const char *data;
+    npy_intp stride;
+    npy_intp size;
+    int type_num;
+};
+
+static int
+bgl_vec_is_native_type( int type_num )
+{
+	return type_num == NPY_FLOAT64 || type_num == NPY_FLOAT32
+	    || type_num == NPY_INT32 || type_num == NPY_INT64;
+}
+
+static int
+bgl_vec_init( struct BGL_Vec *v, PyObject *obj )
+{
+	const int flags = NPY_ARRAY_ALIGNED | NPY_ARRAY_NOTSWAPPED;
+	PyObject *arr;
+
+	arr = PyArray_FromAny( obj, NULL, 1, 1, flags, NULL );
+	if ( arr != NULL &&
+	     !bgl_vec_is_native_type(PyArray_TYPE((PyArrayObject*)arr)) )
+	{
+		Py_DECREF(arr);
+		arr = PyArray_FromAny( obj, PyArray_DescrFromType(NPY_DOUBLE),
+			1, 1, flags, NULL );
+	}
+
+	v->arr = arr;
+	if ( arr == NULL )
+		return 0;
+
+	v->data = PyArray_BYTES((PyArrayObject*)arr);
+	v->stride = PyArray_STRIDE((PyArrayObject*)arr, 0);
+	v->size = PyArray_SIZE((PyArrayObject*)arr);
+	v->type_num = PyArray_TYPE((PyArrayObject*)arr);
+	return 1;
+}
+
+static void
+bgl_vec_free( struct BGL_Vec *v )
+{
+	Py_XDECREF(v->arr);
+	v->arr = NULL;
+}
+
+static inline double
+bgl_vec_get( const struct BGL_Vec *v, npy_intp i )
+{
+	const char *p = v->data + i*v->stride;
+
+	switch ( v->type_num )
+	{
+		case NPY_FLOAT32:	return *(const npy_float32 *)p;
+		case NPY_INT32:		return *(const npy_int32 *)p;
+		case NPY_INT64:		return (double) *(const npy_int64 *)p;
+		default:		return *(const npy_float64 *)p;
+	}
+}
+
+/*
+ *  Vertices are passed to libplot in chunks of this many, converted
+ *  from the input arrays into buffers on the stack.
+ */
+#define BGL_CHUNK 1024
+
+/*
+ *  Copy m values of v, starting at index start, to out as doubles.  The
+ *  element type is looked at once, with a loop for each native type;
+ *  bgl_vec_get() is for single values.
+ */
+#define BGL_VEC_COPY_LOOP(TYPE)						\
+	for ( i = 0; i < m; i++ )					\
+		out[i] = (double) *(const TYPE *)(p + i*stride)
+
+static void
+bgl_vec_copy( const struct BGL_Vec *v, npy_intp start, npy_intp m,
+	double *out )
+{
+	const char *p = v->data + start*v->stride;
+	const npy_intp stride = v->stride;
+	npy_intp i;
+
+	switch ( v->type_num )
+	{
+		case NPY_FLOAT64:
+			if ( stride == sizeof(npy_float64) )
+				memcpy( out, p, m * sizeof(double) );
+			else
+				BGL_VEC_COPY_LOOP(npy_float64);
+			break;
+		case NPY_FLOAT32:
+			BGL_VEC_COPY_LOOP(npy_float32);
+			break;
+		case NPY_INT32:
+			BGL_VEC_COPY_LOOP(npy_int32);
+			break;
+		case NPY_INT64:
+			BGL_VEC_COPY_LOOP(npy_int64);
+			break;
+		default:
+			for ( i = 0; i < m; i++ )
+				out[i] = bgl_vec_get( v, start + i );
+			break;
+	}
+}
+
+#undef BGL_VEC_COPY_LOOP
+
+/*
+ *  Draw a polyline through contiguous double arrays, with as few
+ *  pl_fpolyline_r/pl_fpolycont_r calls as libplot's int counts allow;
+ *  each adds its vertices to libplot's path in bulk.
+ */
+static void
+_polyline( plPlotter *pl, const double *x, const double *y, npy_intp n )
+{
+	npy_intp i, m;
+
+	m = BGL_MIN( n, INT_MAX );
+	pl_fpolyline_r( pl, x, y, (int) m );
+	for ( i = m; i < n; i += m )
+	{
+		m = BGL_MIN( n - i, INT_MAX );
+		pl_fpolycont_r( pl, x + i, y + i, (int) m );
+	}
+}
+
+/*
+ *  Draw a polyline through the first n points of x and y.  Contiguous
+ *  float64 arrays are passed in place; others are converted a chunk at
+ *  a time, the path being continued from one chunk to the next.
+ */
+static void
+_polyline_vec( plPlotter *pl,
+	const struct BGL_Vec *x, const struct BGL_Vec *y, npy_intp n )
+{
+	double xbuf[BGL_CHUNK], ybuf[BGL_CHUNK];
+	npy_intp i, m;
+
+	if ( x->type_num == NPY_FLOAT64 && x->stride == sizeof(double)
+	  && y->type_num == NPY_FLOAT64 && y->stride == sizeof(double) )
+	{
+		_polyline( pl, (const double *) x->data,
+			(const double *) y->data, n );
+		return;
+	}
+
+	for ( i = 0; i < n; i += m )
+	{
+		m = BGL_MIN( n - i, BGL_CHUNK );
+		bgl_vec_copy( x, i, m, xbuf );
+		bgl_vec_copy( y, i, m, ybuf );
+		if ( i == 0 )
+			pl_fpolyline_r( pl, xbuf, ybuf, (int) m );
+		else
+			pl_fpolycont_r( pl, xbuf, ybuf, (int) m );
+	}
+}
+
 /*****************************************************************************
  *  clipping code
  */
@@ -69,6 +241,14 @@ struct PyLibPlot {
     char type[25];
     FILE* fptr; // for writing to files
     plPlotter *pl;
+
+    // in-memory output, when no filename is given
+    int in_memory;
+    char* membuf;
+    size_t membuf_size;
+
+    // held for every libplot call on pl, see BGL_LOCK below
+    PyThread_type_lock lock;
 };
 
 /*
@@ -148,6 +328,88 @@ bail:
     return status;
 }
 
+/*
+   Open a stream that collects the plotter output in memory.  Where
+   open_memstream is not available, fall back to an anonymous temporary
+   file, which is read back in get_output
+*/
+static FILE* open_output_buffer(struct PyLibPlot* self)
+{
+#if defined(_WIN32)
+    return tmpfile();
+#else
+    return open_memstream(&self->membuf, &self->membuf_size);
+#endif
+}
+
+static PyObject* read_output_buffer(struct PyLibPlot* self)
+{
+#if defined(_WIN32)
+    PyObject *bytes=NULL;
+    long size=0;
+
+    if (fseek(self->fptr, 0, SEEK_END) != 0
+            || (size = ftell(self->fptr)) < 0
+            || fseek(self->fptr, 0, SEEK_SET) != 0) {
+        PyErr_SetString(PyExc_IOError, "could not read plotter output");
+        return NULL;
+    }
+
+    bytes = PyBytes_FromStringAndSize(NULL, size);
+    if (bytes == NULL) {
+        return NULL;
+    }
+    if (fread(PyBytes_AS_STRING(bytes), 1, size, self->fptr) != (size_t) size) {
+        Py_DECREF(bytes);
+        PyErr_SetString(PyExc_IOError, "could not read plotter output");
+        return NULL;
+    }
+    return bytes;
+#else
+    // the stream owns membuf until it is closed
+    fclose(self->fptr);
+    self->fptr = NULL;
+    return PyBytes_FromStringAndSize(self->membuf, self->membuf_size);
+#endif
+}
+
+/*
+   Heavy libplot calls (curves, markers, images, page flushes, which
+   rasterize and encode bitmap output) run with the GIL released, so
+   pages drawn on different Plotters in different threads are rendered
+   in parallel.  Each Plotter has its own lock, held for every call into
+   its plPlotter, so a Plotter shared between threads is still only
+   drawn on by one of them at a time.
+*/
+static void bgl_lock(struct PyLibPlot* self)
+{
+    if (!PyThread_acquire_lock(self->lock, NOWAIT_LOCK)) {
+        Py_BEGIN_ALLOW_THREADS
+        PyThread_acquire_lock(self->lock, WAIT_LOCK);
+        Py_END_ALLOW_THREADS
+    }
+}
+
+#define BGL_LOCK(self)      bgl_lock(self)
+#define BGL_UNLOCK(self)    PyThread_release_lock((self)->lock)
+
+// code between these may not touch python objects
+#define BGL_NOGIL_BEGIN(self)                       \
+    Py_BEGIN_ALLOW_THREADS                          \
+    PyThread_acquire_lock((self)->lock, WAIT_LOCK);
+
+#define BGL_NOGIL_END(self)                         \
+    PyThread_release_lock((self)->lock);            \
+    Py_END_ALLOW_THREADS
+
+// get_output() deletes the plPlotter; drawing on it afterwards is an error
+#define BGL_CHECK_PLOTTER(self)                     \
+    if ((self)->pl == NULL) {                       \
+        PyErr_SetString( PyExc_RuntimeError,        \
+                         "plotter has been finished by get_output()" ); \
+        return NULL;                                \
+    }
+
 static int
 PyLibPlot_init(struct PyLibPlot* self, PyObject *args, PyObject *kwds)
 {
@@ -158,11 +420,22 @@ PyLibPlot_init(struct PyLibPlot* self, PyObject *args, PyObject *kwds)
 	plPlotterParams *params;
 
     self->fptr=NULL;
+    self->in_memory=0;
+    self->membuf=NULL;
+    self->membuf_size=0;
 
-	if ( !PyArg_ParseTuple( args, "sOs", &type, &params_dict, &filename) ) {
+	if ( !PyArg_ParseTuple( args, "sOz", &type, &params_dict, &filename) ) {
 		return -1;
     }
 
+    if (self->lock == NULL) {
+        self->lock = PyThread_allocate_lock();
+        if (self->lock == NULL) {
+            PyErr_NoMemory();
+            return -1;
+        }
+    }
+
     // for the repr
     snprintf(self->type, sizeof(self->type), "%s", type);
 
@@ -173,7 +446,15 @@ PyLibPlot_init(struct PyLibPlot* self, PyObject *args, PyObject *kwds)
         goto bail;
     }
 
-    if (0 != strcmp(filename, "")) {
+    if (filename == NULL) {
+        // no filename, keep the output in memory
+        self->fptr = open_output_buffer(self);
+        if (self->fptr==NULL) {
+            PyErr_SetString( PyExc_IOError, "could not open output buffer");
+            goto bail;
+        }
+        self->in_memory=1;
+    } else if (0 != strcmp(filename, "")) {
         // a filename was passed
         self->fptr = fopen(filename,"w");
         if (self->fptr==NULL) {
@@ -207,13 +488,19 @@ static void
 PyLibPlot_dealloc(struct PyLibPlot* self)
 {
     if (self->pl) {
+        BGL_NOGIL_BEGIN(self)
         pl_deletepl_r(self->pl);
+        BGL_NOGIL_END(self)
     }
 
     // must be closed *after* deleting the plPlotter
     if (self->fptr != NULL) {
         fclose(self->fptr);
     }
+    free(self->membuf);
+    if (self->lock != NULL) {
+        PyThread_free_lock(self->lock);
+    }
 
 #if ((PY_MAJOR_VERSION == 2 && PY_MINOR_VERSION >= 6) || (PY_MAJOR_VERSION == 3))
     Py_TYPE(self)->tp_free((PyObject*)self);
@@ -252,86 +539,48 @@ outcode( double x, double y,
 	return code;
 }
 
+/*
+ *  Liang-Barsky: the part of the segment (x0,y0)-(x1,y1) inside the
+ *  clip rectangle is the parameter range [t0,t1], if nonempty.
+ */
 static bool_t
-cohen_sutherland( double xmin, double xmax, double ymin, double ymax,
+liang_barsky( double xmin, double xmax, double ymin, double ymax,
 	double x0, double y0, double x1, double y1,
-	double *xc0, double *yc0, double *xc1, double *yc1 )
+	double *t0, double *t1 )
 {
-	unsigned out, out0, out1;
-	bool_t accept, done;
-	double x = 0., y = 0.;
+	double p[4], q[4], a = 0., b = 1., r;
+	int k;
 
-	out0 = outcode( x0, y0, xmin, xmax, ymin, ymax );
-	out1 = outcode( x1, y1, xmin, xmax, ymin, ymax );
+	p[0] = x0 - x1;	q[0] = x0 - xmin;
+	p[1] = x1 - x0;	q[1] = xmax - x0;
+	p[2] = y0 - y1;	q[2] = y0 - ymin;
+	p[3] = y1 - y0;	q[3] = ymax - y0;
 
-	accept = FALSE;
-	done = FALSE;
-
-	do
+	for ( k = 0; k < 4; k++ )
 	{
-		if ( (out0 == 0) && (out1 == 0) )
+		if ( p[k] == 0. )
 		{
-			/* trivially inside */
-			accept = TRUE;
-			done = TRUE;
+			/* parallel to this edge, and outside it */
+			if ( q[k] < 0. )
+				return FALSE;
+			continue;
 		}
-		else if ( (out0 & out1) != 0 )
+		r = q[k] / p[k];
+		if ( p[k] < 0. )
 		{
-			/* trivially outside */
-			done = TRUE;
+			if ( r > b ) return FALSE;
+			if ( r > a ) a = r;
 		}
 		else
 		{
-			out = ( out0 != 0 ) ? out0 : out1 ;
-
-			if ( (out & BGL_TOP) != 0 )
-			{
-				x = x0 + (x1 - x0)*(ymax - y0)/(y1 - y0);
-				y = ymax;
-			}
-			else if ( (out & BGL_BOTTOM) != 0 )
-			{
-				x = x0 + (x1 - x0)*(ymin - y0)/(y1 - y0);
-				y = ymin;
-			}
-			else if ( (out & BGL_RIGHT) != 0 )
-			{
-				y = y0 + (y1 - y0)*(xmax - x0)/(x1 - x0);
-				x = xmax;
-			}
-			else if ( (out & BGL_LEFT) != 0 )
-			{
-				y = y0 + (y1 - y0)*(xmin - x0)/(x1 - x0);
-				x = xmin;
-			}
-
-			if ( out == out0 )
-			{
-				x0 = x;
-				y0 = y;
-				out0 = outcode( x, y, xmin, xmax, ymin, ymax ); 
-			}
-			else
-			{
-				x1 = x;
-				y1 = y;
-				out1 = outcode( x, y, xmin, xmax, ymin, ymax );
-			}
+			if ( r < a ) return FALSE;
+			if ( r < b ) b = r;
 		}
 	}
-	while ( done != TRUE );
-
-	if ( accept == TRUE )
-	{
-		*xc0 = x0;
-		*yc0 = y0;
-		*xc1 = x1;
-		*yc1 = y1;
-
-		/* printf( "(%g %g) (%g %g)\n", x0, y0, x1, y1 ); */
-	}
 
-	return accept;
+	*t0 = a;
+	*t1 = b;
+	return TRUE;
 }
 
 static void
@@ -339,14 +588,145 @@ clipped_pl_fline_r( plPlotter *pl,
 	double xmin, double xmax, double ymin, double ymax,
 	double x0, double y0, double x1, double y1 )
 {
-	double xc0, yc0, xc1, yc1;
-	bool_t accept;
+	double t0, t1;
+
+	if ( !(x0 - x0 == 0. && y0 - y0 == 0. && x1 - x1 == 0. && y1 - y1 == 0.) )
+		return;		/* not finite */
+
+	if ( liang_barsky( xmin, xmax, ymin, ymax,
+			x0, y0, x1, y1, &t0, &t1 ) )
+		pl_fline_r( pl, x0 + t0*(x1 - x0), y0 + t0*(y1 - y0),
+			x0 + t1*(x1 - x0), y0 + t1*(y1 - y0) );
+}
+
+/*
+ *  The vertices of a polyline under construction, which are passed to
+ *  libplot a chunk at a time: the first with pl_fpolyline_r, the rest
+ *  with pl_fpolycont_r, which continues the path.
+ */
+struct BGL_Polyline {
+	double x[BGL_CHUNK], y[BGL_CHUNK];
+	npy_intp n;
+	bool_t started;
+};
+
+static void
+bgl_polyline_flush( plPlotter *pl, struct BGL_Polyline *p )
+{
+	if ( p->n == 0 )
+		return;
+	if ( p->started )
+		pl_fpolycont_r( pl, p->x, p->y, (int) p->n );
+	else
+		pl_fpolyline_r( pl, p->x, p->y, (int) p->n );
+	p->started = TRUE;
+	p->n = 0;
+}
+
+static void
+bgl_polyline_end( plPlotter *pl, struct BGL_Polyline *p )
+{
+	bgl_polyline_flush( pl, p );
+	p->started = FALSE;
+}
 
-	accept = cohen_sutherland( xmin, xmax, ymin, ymax,
-		x0, y0, x1, y1, &xc0, &yc0, &xc1, &yc1 );
+static void
+bgl_polyline_cont( plPlotter *pl, struct BGL_Polyline *p, double x, double y )
+{
+	if ( p->n == BGL_CHUNK )
+		bgl_polyline_flush( pl, p );
+	p->x[p->n] = x;
+	p->y[p->n] = y;
+	p->n++;
+}
 
-	if ( accept == TRUE )
-		pl_fline_r( pl, xc0, yc0, xc1, yc1 );
+static void
+bgl_polyline_move( plPlotter *pl, struct BGL_Polyline *p, double x, double y )
+{
+	bgl_polyline_end( pl, p );
+	bgl_polyline_cont( pl, p, x, y );
+}
+
+/*
+ *  Draw the part of a polyline inside the clip rectangle, as a few
+ *  polylines as possible: a path is only ended where the line leaves
+ *  the rectangle, or at a point which isn't finite. Segments with both
+ *  ends inside, the common case, are taken without clipping; the
+ *  outcode of each vertex is computed once. Each polyline is handed to
+ *  libplot in one call.
+ */
+static void
+_clipped_polyline( plPlotter *pl,
+	double xmin, double xmax, double ymin, double ymax,
+	const struct BGL_Vec *x, const struct BGL_Vec *y, npy_intp n )
+{
+	double x0, y0, x1, y1, t0, t1;
+	double xb[BGL_CHUNK], yb[BGL_CHUNK];
+	unsigned char c0, c1;
+	bool_t open = FALSE;	/* path in progress, ending at (x0,y0) */
+	bool_t ok0, ok1;
+	npy_intp i, j, m;
+	struct BGL_Polyline line;
+
+	line.n = 0;
+	line.started = FALSE;
+
+	x0 = bgl_vec_get(x,0);
+	y0 = bgl_vec_get(y,0);
+	ok0 = x0 - x0 == 0. && y0 - y0 == 0.;
+	c0 = outcode( x0, y0, xmin, xmax, ymin, ymax );
+
+	for ( i = 1; i < n; i += m )
+	{
+		m = BGL_MIN( n - i, BGL_CHUNK );
+		bgl_vec_copy( x, i, m, xb );
+		bgl_vec_copy( y, i, m, yb );
+
+		for ( j = 0; j < m;
+		      j++, x0 = x1, y0 = y1, c0 = c1, ok0 = ok1 )
+		{
+			x1 = xb[j];
+			y1 = yb[j];
+			ok1 = x1 - x1 == 0. && y1 - y1 == 0.;
+			c1 = outcode( x1, y1, xmin, xmax, ymin, ymax );
+
+			if ( !(ok0 && ok1) || (c0 & c1) != 0 )
+			{
+				/* not finite, or trivially outside */
+				open = FALSE;
+				continue;
+			}
+
+			if ( (c0 | c1) == 0 )
+			{
+				/* trivially inside */
+				if ( !open )
+					bgl_polyline_move( pl, &line, x0, y0 );
+				bgl_polyline_cont( pl, &line, x1, y1 );
+				open = TRUE;
+				continue;
+			}
+
+			if ( !liang_barsky( xmin, xmax, ymin, ymax,
+					x0, y0, x1, y1, &t0, &t1 ) )
+			{
+				open = FALSE;
+				continue;
+			}
+
+			if ( !(open && t0 == 0.) )
+				bgl_polyline_move( pl, &line,
+					x0 + t0*(x1 - x0), y0 + t0*(y1 - y0) );
+			if ( t1 == 1. )
+				bgl_polyline_cont( pl, &line, x1, y1 );
+			else
+				bgl_polyline_cont( pl, &line,
+					x0 + t1*(x1 - x0), y0 + t1*(y1 - y0) );
+			open = t1 == 1.;
+		}
+	}
+
+	bgl_polyline_end( pl, &line );
 }
 
 /******************************************************************************
@@ -361,13 +741,28 @@ clipped_pl_fline_r( plPlotter *pl,
 static PyObject *                    \
 NAME (struct PyLibPlot *self)        \
 {                                    \
+	BGL_CHECK_PLOTTER(self);         \
+	BGL_LOCK(self);                  \
 	FUNCTION(self->pl);              \
+	BGL_UNLOCK(self);                \
     Py_RETURN_NONE;                  \
 }
 
-BGL_PL_FUNC( clear, pl_erase_r )
-BGL_PL_FUNC( end_page, pl_closepl_r )
-BGL_PL_FUNC( flush, pl_flushpl_r )
+// these may write out (and encode) a whole page
+#define BGL_PL_FUNC_NOGIL(NAME,FUNCTION) \
+static PyObject *                    \
+NAME (struct PyLibPlot *self)        \
+{                                    \
+	BGL_CHECK_PLOTTER(self);         \
+	BGL_NOGIL_BEGIN(self)            \
+	FUNCTION(self->pl);              \
+	BGL_NOGIL_END(self)              \
+    Py_RETURN_NONE;                  \
+}
+
+BGL_PL_FUNC_NOGIL( clear, pl_erase_r )
+BGL_PL_FUNC_NOGIL( end_page, pl_closepl_r )
+BGL_PL_FUNC_NOGIL( flush, pl_flushpl_r )
 BGL_PL_FUNC( gsave, pl_savestate_r )
 BGL_PL_FUNC( grestore, pl_restorestate_r )
 //BGL_PL_FUNC( begin_page, pl_openpl_r )
@@ -375,7 +770,15 @@ BGL_PL_FUNC( grestore, pl_restorestate_r )
 
 static PyObject* begin_page(struct PyLibPlot *self)
 {
-    if (pl_openpl_r(self->pl) < 0) {
+    int status;
+
+    BGL_CHECK_PLOTTER(self);
+
+    BGL_NOGIL_BEGIN(self)
+    status = pl_openpl_r(self->pl);
+    BGL_NOGIL_END(self)
+
+    if (status < 0) {
         fprintf(stderr,"Couldn't open device: '%s'.  If device is X, this is an irrecoverable error\n", self->type );
         PyErr_Format( PyExc_IOError, "Couldn't open device: '%s'", self->type );
         return NULL;
@@ -384,6 +787,32 @@ static PyObject* begin_page(struct PyLibPlot *self)
     Py_RETURN_NONE;
 }
 
+/*
+   Finish the plotter and return everything it wrote to its in-memory
+   output as bytes.  Deleting the plPlotter flushes output that some
+   devices (e.g. ps) only write at deletion; the plotter can not be used
+   for drawing afterwards.
+*/
+static PyObject* get_output(struct PyLibPlot *self)
+{
+    if (!self->in_memory || self->pl == NULL) {
+        PyErr_SetString( PyExc_RuntimeError, "plotter has no in-memory output");
+        return NULL;
+    }
+
+    BGL_NOGIL_BEGIN(self)
+    pl_deletepl_r(self->pl);
+    BGL_NOGIL_END(self)
+    self->pl = NULL;
+
+    if (fflush(self->fptr) != 0) {
+        PyErr_SetString( PyExc_IOError, "could not flush plotter output");
+        return NULL;
+    }
+
+    return read_output_buffer(self);
+}
+
 /******************************************************************************
  */
 
@@ -392,11 +821,14 @@ static PyObject *                                    \
 NAME (struct PyLibPlot *self, PyObject *args)        \
 {                                                    \
 	int i0;                                          \
+	BGL_CHECK_PLOTTER(self);                         \
                                                      \
 	if ( !PyArg_ParseTuple( args, "i", &i0 ) )       \
 		return NULL;                                 \
                                                      \
+	BGL_LOCK(self);                                  \
 	FUNCTION(self->pl, i0);                          \
+	BGL_UNLOCK(self);                                \
     Py_RETURN_NONE;                                  \
 }
 
@@ -410,11 +842,14 @@ static PyObject *                                    \
 NAME (struct PyLibPlot *self, PyObject *args)        \
 {                                                    \
 	double d0;                                       \
+	BGL_CHECK_PLOTTER(self);                         \
                                                      \
 	if ( !PyArg_ParseTuple( args, "d", &d0 ) )       \
 		return NULL;                                 \
                                                      \
+	BGL_LOCK(self);                                  \
 	FUNCTION(self->pl, d0);                          \
+	BGL_UNLOCK(self);                                \
     Py_RETURN_NONE;                                  \
 }
 
@@ -423,11 +858,14 @@ static PyObject *                                    \
 NAME (struct PyLibPlot *self, PyObject *args)        \
 {                                                    \
 	double d0, d1;                                   \
+	BGL_CHECK_PLOTTER(self);                         \
                                                      \
 	if ( !PyArg_ParseTuple( args, "dd", &d0, &d1 ) ) \
 		return NULL;                                 \
                                                      \
+	BGL_LOCK(self);                                  \
 	FUNCTION(self->pl, d0, d1);                      \
+	BGL_UNLOCK(self);                                \
     Py_RETURN_NONE;                                  \
 }
 
@@ -436,11 +874,14 @@ static PyObject *                                    \
 NAME (struct PyLibPlot *self, PyObject *args)        \
 {                                                    \
 	double d0, d1, d2;                               \
+	BGL_CHECK_PLOTTER(self);                         \
                                                      \
 	if ( !PyArg_ParseTuple( args, "ddd", &d0,&d1,&d2) ) \
 		return NULL;                                 \
                                                      \
+	BGL_LOCK(self);                                  \
 	FUNCTION(self->pl, d0, d1, d2);                  \
+	BGL_UNLOCK(self);                                \
     Py_RETURN_NONE;                                  \
 }
 
@@ -449,11 +890,14 @@ static PyObject *                                    \
 NAME (struct PyLibPlot *self, PyObject *args)        \
 {                                                    \
 	double d0,d1,d2,d3;                              \
+	BGL_CHECK_PLOTTER(self);                         \
                                                      \
 	if ( !PyArg_ParseTuple( args, "dddd", &d0,&d1,&d2,&d3) ) \
 		return NULL;                                 \
                                                      \
+	BGL_LOCK(self);                                  \
 	FUNCTION(self->pl,d0,d1,d2,d3);                  \
+	BGL_UNLOCK(self);                                \
     Py_RETURN_NONE;                                  \
 }
 
@@ -462,11 +906,14 @@ static PyObject *                                    \
 NAME (struct PyLibPlot *self, PyObject *args)        \
 {                                                    \
 	double d0,d1,d2,d3,d4;                           \
+	BGL_CHECK_PLOTTER(self);                         \
                                                      \
 	if ( !PyArg_ParseTuple( args, "ddddd", &d0,&d1,&d2,&d3,&d4) ) \
 		return NULL;                                 \
                                                      \
+	BGL_LOCK(self);                                  \
 	FUNCTION(self->pl,d0,d1,d2,d3,d4);               \
+	BGL_UNLOCK(self);                                \
     Py_RETURN_NONE;                                  \
 }
 
@@ -475,11 +922,14 @@ static PyObject *                                    \
 NAME (struct PyLibPlot *self, PyObject *args)        \
 {                                                    \
 	double d0,d1,d2,d3,d4,d5;                        \
+	BGL_CHECK_PLOTTER(self);                         \
                                                      \
 	if ( !PyArg_ParseTuple( args, "dddddd", &d0,&d1,&d2,&d3,&d4,&d5) ) \
 		return NULL;                                 \
                                                      \
+	BGL_LOCK(self);                                  \
 	FUNCTION(self->pl,d0,d1,d2,d3,d4,d5);            \
+	BGL_UNLOCK(self);                                \
     Py_RETURN_NONE;                                  \
 }
 
@@ -488,11 +938,14 @@ static PyObject *                                    \
 NAME (struct PyLibPlot *self, PyObject *args)        \
 {                                                    \
 	double d0,d1,d2,d3,d4,d5,d6,d7;                  \
+	BGL_CHECK_PLOTTER(self);                         \
                                                      \
 	if ( !PyArg_ParseTuple( args, "dddddddd", &d0,&d1,&d2,&d3,&d4,&d5,&d6,&d7) ) \
 		return NULL;                                 \
                                                      \
+	BGL_LOCK(self);                                  \
 	FUNCTION(self->pl,d0,d1,d2,d3,d4,d5,d6,d7);      \
+	BGL_UNLOCK(self);                                \
     Py_RETURN_NONE;                                  \
 }
 
@@ -525,11 +978,14 @@ static PyObject *                                    \
 NAME (struct PyLibPlot *self, PyObject *args)        \
 {                                                    \
 	char* s0;                                        \
+	BGL_CHECK_PLOTTER(self);                         \
                                                      \
 	if ( !PyArg_ParseTuple( args, "s", &s0 ) )       \
 		return NULL;                                 \
                                                      \
+	BGL_LOCK(self);                                  \
 	FUNCTION(self->pl, (const char*) s0);            \
+	BGL_UNLOCK(self);                                \
     Py_RETURN_NONE;                                  \
 }
 
@@ -554,6 +1010,7 @@ NAME(struct PyLibPlot *self, PyObject *args)                   \
 {                                                              \
 	double d0, d1, d2;                                         \
 	int r, g, b;                                               \
+	BGL_CHECK_PLOTTER(self);                                   \
                                                                \
 	if ( !PyArg_ParseTuple( args, "ddd", &d0, &d1, &d2 ) )     \
 		return NULL;                                           \
@@ -562,7 +1019,9 @@ NAME(struct PyLibPlot *self, PyObject *args)                   \
 	g = (int) floor( d1*65535 );                               \
 	b = (int) floor( d2*65535 );                               \
                                                                \
+	BGL_LOCK(self);                                            \
 	FUNCTION(self->pl, r, g, b );                              \
+	BGL_UNLOCK(self);                                          \
     Py_RETURN_NONE;                                            \
 }
 
@@ -580,10 +1039,14 @@ string(struct PyLibPlot *self, PyObject *args)
 	int i0, i1;
 	char *s0;
 
+	BGL_CHECK_PLOTTER(self);
+
 	if ( !PyArg_ParseTuple( args, "iis", &i0, &i1, &s0 ) )
 		return NULL;
 
+	BGL_NOGIL_BEGIN(self)
 	pl_alabel_r(self->pl, i0, i1, s0 );
+	BGL_NOGIL_END(self)
     Py_RETURN_NONE;
 }
 
@@ -593,10 +1056,14 @@ get_string_width(struct PyLibPlot *self, PyObject *args)
 	char *s0;
 	double width;
 
+	BGL_CHECK_PLOTTER(self);
+
 	if ( !PyArg_ParseTuple( args, "s", &s0 ) )
 		return NULL;
 
+	BGL_LOCK(self);
 	width = pl_flabelwidth_r(self->pl, s0 );
+	BGL_UNLOCK(self);
 	return Py_BuildValue( "d", width );
 }
 
@@ -638,36 +1105,89 @@ _symbol_end( plPlotter *pl, int type, double size )
 		pl_restorestate_r( pl );
 }
 
+/*
+ * Marker symbols are handed to libplot in a single pl_fmarkers_r call,
+ * which lets the bitmap, PS and SVG drivers draw the marker once and
+ * repeat it.  Returns FALSE if the points should be drawn one at a time.
+ */
+static int
+_symbols_batch( plPlotter *pl, const struct BGL_Vec *x,
+	const struct BGL_Vec *y, npy_intp n, int type, double size,
+	const double *clip )
+{
+	double *bx, *by, px, py;
+	npy_intp i;
+	int m = 0;
+
+	if ( type > 31 || n < 2 || n > INT_MAX )
+		return FALSE;
+
+	bx = (double *) malloc( 2 * n * sizeof(double) );
+	if ( bx == NULL )
+		return FALSE;
+	by = bx + n;
+	bgl_vec_copy( x, 0, n, bx );
+	bgl_vec_copy( y, 0, n, by );
+
+	for ( i = 0; i < n; i++ )
+	{
+		px = bx[i];
+		py = by[i];
+
+		if ( clip != NULL &&
+		     !(px >= clip[0] && px <= clip[1] &&
+		       py >= clip[2] && py <= clip[3]) )
+			continue;
+
+		bx[m] = px;
+		by[m] = py;
+		m++;
+	}
+
+	pl_fmarkers_r( pl, bx, by, m, type, size );
+	free( bx );
+	return TRUE;
+}
+
 static PyObject *
 symbols(struct PyLibPlot *self, PyObject *args)
 {
 	PyObject *ox, *oy;
-	PyObject *x, *y;
+	struct BGL_Vec x, y;
 	double d0;
 	int i0;
     npy_intp i, n;
 
+    BGL_CHECK_PLOTTER(self);
+
 	if ( !PyArg_ParseTuple( args, "OOid", &ox, &oy, &i0, &d0 ) )
 		return NULL;
 
-	x = PyArray_ContiguousFromAny( ox, NPY_DOUBLE, 1, 1 );
-	y = PyArray_ContiguousFromAny( oy, NPY_DOUBLE, 1, 1 );
-
-	if ( x == NULL || y == NULL )
-		goto quit;
+	if ( !bgl_vec_init( &x, ox ) )
+		return NULL;
+	if ( !bgl_vec_init( &y, oy ) )
+	{
+		bgl_vec_free( &x );
+		return NULL;
+	}
 
-	n = BGL_MIN( PyArray_SIZE(x), PyArray_SIZE(y) );
+	n = BGL_MIN( x.size, y.size );
 
-	_symbol_begin( self->pl, i0, d0 );
+	BGL_NOGIL_BEGIN(self)
+	if ( !_symbols_batch( self->pl, &x, &y, n, i0, d0, NULL ) )
+	{
+		_symbol_begin( self->pl, i0, d0 );
 
-	for ( i = 0; i < n; i++ )
-		_symbol_draw( self->pl, BGL_DArray1(x,i), BGL_DArray1(y,i), i0, d0 );
+		for ( i = 0; i < n; i++ )
+			_symbol_draw( self->pl, bgl_vec_get(&x,i), bgl_vec_get(&y,i),
+				i0, d0 );
 
-	_symbol_end( self->pl, i0, d0 );
+		_symbol_end( self->pl, i0, d0 );
+	}
+	BGL_NOGIL_END(self)
 
-quit:
-	Py_XDECREF(x);
-	Py_XDECREF(y);
+	bgl_vec_free( &x );
+	bgl_vec_free( &y );
     Py_RETURN_NONE;
 }
 
@@ -675,31 +1195,41 @@ static PyObject *
 clipped_symbols(struct PyLibPlot *self, PyObject *args)
 {
 	PyObject *ox, *oy;
-	PyObject *x, *y;
-	double xmin, xmax, ymin, ymax;
+	struct BGL_Vec x, y;
+	double xmin, xmax, ymin, ymax, clip[4];
 	double d0;
 	int i0;
     npy_intp i, n;
 	double px, py;
 
+	BGL_CHECK_PLOTTER(self);
+
 	if ( !PyArg_ParseTuple( args, "OOiddddd", &ox, &oy,
 			&i0, &d0, &xmin, &xmax, &ymin, &ymax ) )
 		return NULL;
 
-	x = PyArray_ContiguousFromAny( ox, NPY_DOUBLE, 1, 1 );
-	y = PyArray_ContiguousFromAny( oy, NPY_DOUBLE, 1, 1 );
+	if ( !bgl_vec_init( &x, ox ) )
+		return NULL;
+	if ( !bgl_vec_init( &y, oy ) )
+	{
+		bgl_vec_free( &x );
+		return NULL;
+	}
 
-	if ( x == NULL || y == NULL )
-		goto quit;
+	n = BGL_MIN( x.size, y.size );
+	clip[0] = xmin; clip[1] = xmax;
+	clip[2] = ymin; clip[3] = ymax;
 
-	n = BGL_MIN( PyArray_SIZE(x), PyArray_SIZE(y) );
+	BGL_NOGIL_BEGIN(self)
+	if ( _symbols_batch( self->pl, &x, &y, n, i0, d0, clip ) )
+		n = 0;
 
 	_symbol_begin( self->pl, i0, d0 );
 
 	for ( i = 0; i < n; i++ )
 	{
-		px = BGL_DArray1(x,i);
-		py = BGL_DArray1(y,i);
+		px = bgl_vec_get(&x,i);
+		py = bgl_vec_get(&y,i);
 
 		if ( px >= xmin && px <= xmax &&
 		     py >= ymin && py <= ymax )
@@ -707,10 +1237,10 @@ clipped_symbols(struct PyLibPlot *self, PyObject *args)
 	}
 
 	_symbol_end( self->pl, i0, d0 );
+	BGL_NOGIL_END(self)
 
-quit:
-	Py_XDECREF(x);
-	Py_XDECREF(y);
+	bgl_vec_free( &x );
+	bgl_vec_free( &y );
     Py_RETURN_NONE;
 }
 
@@ -718,7 +1248,8 @@ static PyObject *
 clipped_colored_symbols(struct PyLibPlot *self, PyObject *args)
 {
 	PyObject *ox, *oy, *oc;
-	PyObject *x, *y, *c;
+	struct BGL_Vec x, y;
+	PyObject *c = NULL;
 	double xmin, xmax, ymin, ymax;
 	double d0;
 	int i0;
@@ -726,26 +1257,30 @@ clipped_colored_symbols(struct PyLibPlot *self, PyObject *args)
 	double px, py;
 	int r, g, b;
 
+	BGL_CHECK_PLOTTER(self);
+
 	if ( !PyArg_ParseTuple( args, "OOOiddddd", &ox, &oy, &oc,
 			&i0, &d0, &xmin, &xmax, &ymin, &ymax ) )
 		return NULL;
 
-	x = PyArray_ContiguousFromAny( ox, NPY_DOUBLE, 1, 1 );
-	y = PyArray_ContiguousFromAny( oy, NPY_DOUBLE, 1, 1 );
-	c = PyArray_ContiguousFromAny( oc, NPY_DOUBLE, 2, 2 );
+	x.arr = y.arr = NULL;
+	if ( !bgl_vec_init( &x, ox ) || !bgl_vec_init( &y, oy ) )
+		goto quit;
 
-	if ( x == NULL || y == NULL || c == NULL )
+	c = PyArray_ContiguousFromAny( oc, NPY_DOUBLE, 2, 2 );
+	if ( c == NULL )
 		goto quit;
 
-	n = BGL_MIN( PyArray_SIZE(x), PyArray_SIZE(y) );
-	n = BGL_MIN( n, PyArray_SIZE(c) );
-	
+	n = BGL_MIN( x.size, y.size );
+	n = BGL_MIN( n, PyArray_DIM(c,0) );
+
+	BGL_NOGIL_BEGIN(self)
 	_symbol_begin( self->pl, i0, d0 );
 
 	for ( i = 0; i < n; i++ )
 	{
-		px = BGL_DArray1(x,i);
-		py = BGL_DArray1(y,i);
+		px = bgl_vec_get(&x,i);
+		py = bgl_vec_get(&y,i);
 
 		if ( px >= xmin && px <= xmax &&
 		     py >= ymin && py <= ymax ) {
@@ -760,11 +1295,14 @@ clipped_colored_symbols(struct PyLibPlot *self, PyObject *args)
 	}
 
 	_symbol_end( self->pl, i0, d0 );
+	BGL_NOGIL_END(self)
 
 quit:
-	Py_XDECREF(x);
-	Py_XDECREF(y);
+	bgl_vec_free( &x );
+	bgl_vec_free( &y );
 	Py_XDECREF(c);
+	if ( PyErr_Occurred() )
+		return NULL;
     Py_RETURN_NONE;
 }
 
@@ -774,30 +1312,34 @@ static PyObject *
 curve(struct PyLibPlot *self, PyObject *args)
 {
 	PyObject *ox, *oy;
-	PyObject *x, *y;
-	npy_intp i, n;
+	struct BGL_Vec x, y;
+	npy_intp n;
+
+	BGL_CHECK_PLOTTER(self);
 
 	if ( !PyArg_ParseTuple( args, "OO", &ox, &oy ) )
 		return NULL;
 
-	x = PyArray_ContiguousFromAny( ox, NPY_DOUBLE, 1, 1 );
-	y = PyArray_ContiguousFromAny( oy, NPY_DOUBLE, 1, 1 );
-
-	if ( x == NULL || y == NULL )
-		goto quit;
+	if ( !bgl_vec_init( &x, ox ) )
+		return NULL;
+	if ( !bgl_vec_init( &y, oy ) )
+	{
+		bgl_vec_free( &x );
+		return NULL;
+	}
 
-	n = BGL_MIN( PyArray_SIZE(x), PyArray_SIZE(y) );
+	n = BGL_MIN( x.size, y.size );
 	if ( n <= 0 )
 		goto quit;
 
-	pl_fmove_r( self->pl, BGL_DArray1(x,0), BGL_DArray1(y,0) );
-	for ( i = 1; i < n; i++ )
-		pl_fcont_r( self->pl, BGL_DArray1(x,i), BGL_DArray1(y,i) );
+	BGL_NOGIL_BEGIN(self)
+	_polyline_vec( self->pl, &x, &y, n );
 	pl_endpath_r( self->pl );
+	BGL_NOGIL_END(self)
 
 quit:
-	Py_XDECREF(x);
-	Py_XDECREF(y);
+	bgl_vec_free( &x );
+	bgl_vec_free( &y );
     Py_RETURN_NONE;
 }
 
@@ -805,36 +1347,36 @@ static PyObject *
 clipped_curve(struct PyLibPlot *self, PyObject *args)
 {
 	PyObject *ox, *oy;
-	PyObject *x, *y;
+	struct BGL_Vec x, y;
 	double xmin, xmax, ymin, ymax;
-	npy_intp i, n;
+	npy_intp n;
+
+	BGL_CHECK_PLOTTER(self);
 
 	if ( !PyArg_ParseTuple( args, "OOdddd", &ox, &oy,
 			&xmin, &xmax, &ymin, &ymax ) )
 		return NULL;
 
-	x = PyArray_ContiguousFromAny( ox, NPY_DOUBLE, 1, 1 );
-	y = PyArray_ContiguousFromAny( oy, NPY_DOUBLE, 1, 1 );
-
-	if ( x == NULL || y == NULL )
-		goto quit;
+	if ( !bgl_vec_init( &x, ox ) )
+		return NULL;
+	if ( !bgl_vec_init( &y, oy ) )
+	{
+		bgl_vec_free( &x );
+		return NULL;
+	}
 
-	n = BGL_MIN( PyArray_SIZE(x), PyArray_SIZE(y) );
+	n = BGL_MIN( x.size, y.size );
 	if ( n <= 0 )
 		goto quit;
 
-	for ( i = 0; i < n-1; i++ )
-	{
-		clipped_pl_fline_r( self->pl,
-			xmin, xmax, ymin, ymax,
-			BGL_DArray1(x,i), BGL_DArray1(y,i),
-			BGL_DArray1(x,i+1), BGL_DArray1(y,i+1) );
-	}
+	BGL_NOGIL_BEGIN(self)
+	_clipped_polyline( self->pl, xmin, xmax, ymin, ymax, &x, &y, n );
 	pl_endpath_r( self->pl );
+	BGL_NOGIL_END(self)
 
 quit:
-	Py_XDECREF(x);
-	Py_XDECREF(y);
+	bgl_vec_free( &x );
+	bgl_vec_free( &y );
     Py_RETURN_NONE;
 }
 
@@ -846,16 +1388,73 @@ quit:
  *
  */
 
+/*
+ * Density grids are drawn as a single libplot image.  grid[xi][yi] is the
+ * cell at column xi, counting from xmin, and row yi, counting from ymin;
+ * image rows run from the top (ymax) down.
+ */
+
+static unsigned char
+_density_byte( double v )
+{
+	int c;
+
+	if ( !(v > 0.) )
+		return 0;
+	if ( v >= 1. )
+		return 255;
+	c = (int) floor( v*65535 );
+	return (unsigned char) (c >> 8);
+}
+
+/* called without the GIL; returns FALSE if out of memory */
+static int
+_density_image( plPlotter *pl, PyObject *grid, int ncolors,
+	double xmin, double xmax, double ymin, double ymax )
+{
+	npy_intp xi, yi, xn, yn;
+	unsigned char *rgb, *p;
+	int k;
+
+	xn = PyArray_DIM(grid, 0);
+	yn = PyArray_DIM(grid, 1);
+	if ( xn <= 0 || yn <= 0 || xn > INT_MAX || yn > INT_MAX )
+		return TRUE;
+	if ( ncolors == 3 && PyArray_DIM(grid, 2) < 3 )
+		return TRUE;
+
+	rgb = (unsigned char *) malloc( 3 * xn * yn );
+	if ( rgb == NULL )
+		return FALSE;
+
+	for ( yi = 0; yi < yn; yi++ )
+	{
+		p = rgb + 3 * (yn - 1 - yi) * xn;
+		for ( xi = 0; xi < xn; xi++, p += 3 )
+		{
+			if ( ncolors == 1 )
+				p[0] = p[1] = p[2] =
+					_density_byte( BGL_DArray2(grid,xi,yi) );
+			else
+				for ( k = 0; k < 3; k++ )
+					p[k] = _density_byte( BGL_DArray3(grid,xi,yi,k) );
+		}
+	}
+
+	pl_fimage_r( pl, xmin, ymin, xmax, ymax, (int) xn, (int) yn, rgb );
+	free( rgb );
+	return TRUE;
+}
+
 static PyObject *
 density_plot(struct PyLibPlot *self, PyObject *args)
 {
 	PyObject *ogrid;
 	PyObject *grid;
 	double xmin, xmax, ymin, ymax;
-	
-	double px, py, dx, dy;
-	npy_intp xi, yi, xn, yn;
-	int    r, g, b;
+	int ok;
+
+	BGL_CHECK_PLOTTER(self);
 
 	if ( !PyArg_ParseTuple( args, "Odddd", &ogrid,
 				&xmin, &xmax, &ymin, &ymax ) )
@@ -870,25 +1469,17 @@ density_plot(struct PyLibPlot *self, PyObject *args)
 		printf("Expect a NxM array for densgrid");
 		goto quit;
 	}
-	
-	xn = PyArray_DIM(grid, 0);
-	yn = PyArray_DIM(grid, 1);
-	dx = (xmax - xmin) / xn;
-	dy = (ymax - ymin) / yn;
-	
-	for   ( xi=0, px=xmin; xi < xn; xi++, px+=dx ) {
-	  for ( yi=0, py=ymin; yi < yn; yi++, py+=dy ) {
-	    r=g=b = (int) floor( BGL_DArray2(grid,xi,yi)*65535 );
-	    pl_filltype_r ( self->pl, 1.0 );
-	    pl_fillcolor_r( self->pl, r, g, b );
-	    pl_pencolor_r ( self->pl, r, g, b );
-
-	    pl_fbox_r( self->pl, px, py, px+dx, py+dy );
-	  }
-	}
+
+	BGL_NOGIL_BEGIN(self)
+	ok = _density_image( self->pl, grid, 1, xmin, xmax, ymin, ymax );
+	BGL_NOGIL_END(self)
+	if ( !ok )
+		PyErr_NoMemory();
 
 quit:
 	Py_XDECREF(grid);
+	if ( PyErr_Occurred() )
+		return NULL;
     Py_RETURN_NONE;
 }
 
@@ -898,10 +1489,9 @@ color_density_plot(struct PyLibPlot *self, PyObject *args)
 	PyObject *ogrid;
 	PyObject *grid;
 	double xmin, xmax, ymin, ymax;
-	
-	double px, py, dx, dy;
-	npy_intp xi, yi, xn, yn;
-	int    r, g, b;
+	int ok;
+
+	BGL_CHECK_PLOTTER(self);
 
 	if ( !PyArg_ParseTuple( args, "Odddd", &ogrid,
 				&xmin, &xmax, &ymin, &ymax ) )
@@ -916,30 +1506,89 @@ color_density_plot(struct PyLibPlot *self, PyObject *args)
 		printf("Expect a NxMx3 array for color densgrid");
 		goto quit;
 	}
-	
-	xn = PyArray_DIM(grid, 0);
-	yn = PyArray_DIM(grid, 1);
-	dx = (xmax - xmin) / xn;
-	dy = (ymax - ymin) / yn;
-	
-	for   ( xi=0, px=xmin; xi < xn; xi++, px+=dx ) {
-	  for ( yi=0, py=ymin; yi < yn; yi++, py+=dy ) {
-	    r = (int) floor( BGL_DArray3(grid,xi,yi,0)*65535 );
-	    g = (int) floor( BGL_DArray3(grid,xi,yi,1)*65535 );
-	    b = (int) floor( BGL_DArray3(grid,xi,yi,2)*65535 );
-	    pl_filltype_r ( self->pl, 1.0 );
-	    pl_fillcolor_r( self->pl, r, g, b );
-	    pl_pencolor_r ( self->pl, r, g, b );
-
-	    pl_fbox_r( self->pl, px, py, px+dx, py+dy );
-	  }
-	}
+
+	BGL_NOGIL_BEGIN(self)
+	ok = _density_image( self->pl, grid, 3, xmin, xmax, ymin, ymax );
+	BGL_NOGIL_END(self)
+	if ( !ok )
+		PyErr_NoMemory();
 
 quit:
 	Py_XDECREF(grid);
+	if ( PyErr_Occurred() )
+		return NULL;
+    Py_RETURN_NONE;
+}
+
+/*
+ * An 8-bit RGB image, row-major with the first row along the y1 edge,
+ * e.g. a tile rendered by another bitmap plotter.
+ */
+
+static PyObject *
+image(struct PyLibPlot *self, PyObject *args)
+{
+	double x0, y0, x1, y1;
+	int width, height;
+	Py_buffer rgb;
+
+	BGL_CHECK_PLOTTER(self);
+
+	if ( !PyArg_ParseTuple( args, "ddddiis*", &x0, &y0, &x1, &y1,
+				&width, &height, &rgb ) )
+		return NULL;
+
+	if ( width <= 0 || height <= 0
+			|| rgb.len / 3 / width < height ) {
+		PyBuffer_Release( &rgb );
+		PyErr_SetString( PyExc_ValueError, "image data is too short" );
+		return NULL;
+	}
+
+	BGL_NOGIL_BEGIN(self)
+	pl_fimage_r( self->pl, x0, y0, x1, y1, width, height,
+			(const unsigned char *) rgb.buf );
+	BGL_NOGIL_END(self)
+	PyBuffer_Release( &rgb );
     Py_RETURN_NONE;
 }
 
+/*
+ * The canvas of a bitmap plotter, as (width, height, rgb) in the layout
+ * image() takes; anti-aliased canvases are returned supersampled.
+ */
+
+static PyObject *
+get_image(struct PyLibPlot *self)
+{
+	int width, height;
+	PyObject *rgb;
+
+	BGL_CHECK_PLOTTER(self);
+
+	// hold the lock throughout, so the canvas can't change size
+	BGL_LOCK(self);
+	if ( pl_getimage_r( self->pl, &width, &height, NULL ) < 0 ) {
+		BGL_UNLOCK(self);
+		PyErr_SetString( PyExc_RuntimeError, "plotter has no canvas" );
+		return NULL;
+	}
+
+	rgb = PyBytes_FromStringAndSize( NULL, 3 * (Py_ssize_t) width * height );
+	if ( rgb == NULL ) {
+		BGL_UNLOCK(self);
+		return NULL;
+	}
+
+	Py_BEGIN_ALLOW_THREADS
+	pl_getimage_r( self->pl, &width, &height,
+			(unsigned char *) PyBytes_AS_STRING(rgb) );
+	Py_END_ALLOW_THREADS
+	BGL_UNLOCK(self);
+
+	return Py_BuildValue( "iiN", width, height, rgb );
+}
+
 /*****************************************************************************
  *  module init
  */
@@ -953,6 +1602,7 @@ static PyMethodDef PyLibPlot_methods[] = {
 	{ "gsave", (PyCFunction)gsave, METH_NOARGS ,""},
 	{ "grestore", (PyCFunction)grestore, METH_NOARGS ,""},
 	{ "begin_page", (PyCFunction)begin_page, METH_NOARGS, "open page on device" },
+	{ "get_output", (PyCFunction)get_output, METH_NOARGS, "finish plotter, return in-memory output as bytes" },
 
 	// (i)
 	{ "set_fill_level", (PyCFunction)set_fill_level, METH_VARARGS ,""},
@@ -1012,6 +1662,8 @@ static PyMethodDef PyLibPlot_methods[] = {
 
 	{ "density_plot",	(PyCFunction)density_plot,		METH_VARARGS ,""},
 	{ "color_density_plot", (PyCFunction)color_density_plot,	METH_VARARGS ,""},
+	{ "image",		(PyCFunction)image,			METH_VARARGS ,""},
+	{ "get_image",		(PyCFunction)get_image,		METH_NOARGS ,""},
 
     {NULL}  /* Sentinel */
 };
@@ -20,6 +20,8 @@
 #
 
 import math
+import re
+import warnings
 from ._libplot_pywrap import Plotter
 
 from .tex2libplot import tex2libplot
@@ -88,6 +90,12 @@ class RendererState(object):
     def restore(self):
         self.current = self.saved.pop(0)
 
+    def items(self):
+        merged = {}
+        for d in self.saved[::-1] + [self.current]:
+            merged.update(d)
+        return merged.items()
+
 
 def _hexcolor(hextriplet, scale=1):
     s = float(scale) / 0xff
@@ -143,15 +151,16 @@ def _set_line_type(pl, type):
 
 class LibplotRenderer(Plotter):
 
-    def __init__(self, ll, ur, type='X', parameters=None, file=None):
-        if file is None:
-            filename = ""
-        else:
-            filename = file
+    # size of a device pixel in user coordinates, used to decimate
+    # curves; None turns decimation off
+    resolution = None
 
+    def __init__(self, ll, ur, type='X', parameters=None, file=None):
+        # file=None keeps the output in memory, see getvalue();
+        # file="" means the device writes no output stream (e.g. X)
         self.lowerleft = ll
         self.upperright = ur
-        super(LibplotRenderer, self).__init__(type, parameters, filename)
+        super(LibplotRenderer, self).__init__(type, parameters, file)
 
     def open(self):
         self.state = RendererState()
@@ -163,6 +172,13 @@ class LibplotRenderer(Plotter):
     def close(self):
         self.end_page()
 
+    def getvalue(self):
+        """
+        Return the output of a renderer created with file=None, as bytes.
+        The renderer can not be drawn to afterwards.
+        """
+        return self.get_output()
+
     def __enter__(self):
         return self
 
@@ -364,6 +380,8 @@ class LibplotRenderer(Plotter):
 
 class ScreenRenderer(LibplotRenderer):
 
+    resolution = 1.
+
     def __init__(self, width=640, height=640, bgcolor="white"):
         ll = 0, 0
         ur = width, height
@@ -377,6 +395,7 @@ class ScreenRenderer(LibplotRenderer):
             ur,
             "X",
             parameters,
+            "",
         )
 
     def __exit__(self, exception_type, exception_value, traceback):
@@ -396,23 +415,148 @@ def _str_size_to_pts(str):
 
 class PSRenderer(LibplotRenderer):
 
-    def __init__(self, filename, paper="", width="", height="", **kw):
+    # points; fine enough for 720 dpi printers
+    resolution = 0.1
+
+    def __init__(self, filename=None, paper="", width="", height="",
+                 streaming=False, **kw):
         ll = 0, 0
         ur = _str_size_to_pts(width), _str_size_to_pts(height)
         pagesize = "%s,xsize=%s,ysize=%s" % (paper, width, height)
         for key, val in kw.items():
             pagesize = pagesize + "," + key + "=" + val
         parameters = {"PAGESIZE": pagesize}
+        # write each page out as soon as it is closed, instead of
+        # holding every page in memory until the document is finished
+        if streaming:
+            parameters["PS_STREAMING"] = "yes"
         super(PSRenderer, self).__init__(ll, ur, "ps", parameters, filename)
 
 
+class SVGRenderer(LibplotRenderer):
+
+    resolution = 0.1
+
+    def __init__(self, filename=None, paper="", width="", height="",
+                 decimals=None, relative=False, merge=False, **kw):
+        ll = 0, 0
+        ur = _str_size_to_pts(width), _str_size_to_pts(height)
+        pagesize = "%s,xsize=%s,ysize=%s" % (paper, width, height)
+        for key, val in kw.items():
+            pagesize = pagesize + "," + key + "=" + val
+        parameters = {"PAGESIZE": pagesize}
+        # compact path data: coordinates rounded to this many decimals
+        # of the page size, relative moves, and runs of lines drawn in
+        # the same style merged into a single <path>
+        if decimals is not None:
+            parameters["SVG_DECIMALS"] = str(int(decimals))
+        if relative:
+            parameters["SVG_RELATIVE"] = "yes"
+        if merge:
+            parameters["SVG_MERGE_PATHS"] = "yes"
+        super(SVGRenderer, self).__init__(ll, ur, "svg", parameters, filename)
+
+
+def _antialias_factor(antialias):
+    """
+    The supersampling factor libplot uses for an ANTIALIAS value: "no"
+    is 1, "yes" is 4, and an integer is clamped to 1..8.  libplot
+    ignores anything else, drawing without anti-aliasing.
+    """
+    value = str(antialias).strip().lower()
+    if value == "no":
+        return 1
+    if value == "yes":
+        return 4
+    match = re.match(r"[+-]?\d+", value)
+    if match is None:
+        warnings.warn("ignoring ANTIALIAS value %r" % (antialias,))
+        return 1
+    return min(max(int(match.group()), 1), 8)
+
+
 class ImageRenderer(LibplotRenderer):
 
-    def __init__(self, type, width, height, file, bgcolor="white"):
+    def __init__(self, type, width, height, file=None, bgcolor="white",
+                 antialias=None, threads=1):
         ll = 0, 0
         ur = width, height
+        self.bgcolor = bgcolor
+        self.antialias = antialias
+        # worker threads for rasterizing independent panels, see tile()
+        self.threads = threads
         parameters = {
             "BITMAPSIZE": "%dx%d" % (width, height),
             "BG_COLOR":bgcolor,
         }
+        self.resolution = 1.
+        if antialias is not None:
+            # supersampling factor, or "yes"/"no"
+            parameters["ANTIALIAS"] = str(antialias)
+            self.resolution = 1. / _antialias_factor(antialias)
         super(ImageRenderer, self).__init__(ll, ur, type, parameters, file)
+
+    def tile(self, ll, ur):
+        """
+        Return a renderer for the part of the page between ll and ur,
+        rounded to whole pixels, with the current drawing state.  It
+        rasterizes into its own canvas and can be used from another
+        thread; hand it back to blit() when done.
+        """
+        w, h = self.upperright
+        x0 = min(max(int(round(ll[0])), 0), w)
+        y0 = min(max(int(round(ll[1])), 0), h)
+        x1 = min(max(int(round(ur[0])), x0 + 1), w)
+        y1 = min(max(int(round(ur[1])), y0 + 1), h)
+        tile = _TileRenderer(self, (x0, y0), (x1, y1))
+        tile.open()
+        tile.bbox = self.bbox
+        if self.resolution < 1.:
+            # anti-aliased lines are 1/850 of the display size by default
+            tile.set_line_size(max(w, h) / 850.)
+        for key, val in self.state.items():
+            tile.set(key, val)
+        return tile
+
+    def blit(self, tile):
+        """
+        Copy the pixels of a renderer returned by tile() onto the page.
+        """
+        self.paste(self.snapshot(tile))
+
+    def snapshot(self, tile):
+        """
+        Finish a renderer returned by tile(), returning its pixels in a
+        form paste() can copy onto this or a later page of the same size.
+        """
+        width, height, rgb = tile.get_image()
+        tile.close()
+        return tile.lowerleft + tile.upperright + (width, height, rgb)
+
+    def paste(self, snapshot):
+        self.image(*snapshot)
+
+    def page_key(self):
+        """
+        A key telling whether snapshots of tiles taken on another page
+        can be pasted onto this one: same size, resolution and state.
+        """
+        return (self.lowerleft, self.upperright, self.bgcolor,
+                self.antialias, repr(sorted(self.state.items())))
+
+
+class _TileRenderer(LibplotRenderer):
+
+    def __init__(self, page, ll, ur):
+        # the canvas is read with get_image() and the tile writes nothing;
+        # closing it needn't resolve a supersampled canvas either
+        parameters = {
+            "BITMAPSIZE": "%dx%d" % (ur[0] - ll[0], ur[1] - ll[1]),
+            "BG_COLOR": page.bgcolor,
+            "ANTIALIAS_RESOLVE": "no",
+        }
+        if page.antialias is not None:
+            parameters["ANTIALIAS"] = str(page.antialias)
+        self.resolution = page.resolution
+        super(_TileRenderer, self).__init__(ll, ur, "pnm", parameters, "")
+
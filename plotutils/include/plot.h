@@ -182,10 +182,15 @@ int pl_flinerel_r (plPlotter *plotter, double dx0, double dy0, double dx1, doubl
 int pl_flinewidth_r (plPlotter *plotter, double size);
 int pl_fmarker_r (plPlotter *plotter, double x, double y, int type, double size);
 int pl_fmarkerrel_r (plPlotter *plotter, double dx, double dy, int type, double size);
+int pl_fmarkers_r (plPlotter *plotter, const double *x, const double *y, int n, int type, double size);
+int pl_fimage_r (plPlotter *plotter, double x0, double y0, double x1, double y1, int width, int height, const unsigned char *rgb);
+int pl_getimage_r (plPlotter *plotter, int *width, int *height, unsigned char *rgb);
 int pl_fmove_r (plPlotter *plotter, double x, double y);
 int pl_fmoverel_r (plPlotter *plotter, double dx, double dy);
 int pl_fpoint_r (plPlotter *plotter, double x, double y);
 int pl_fpointrel_r (plPlotter *plotter, double dx, double dy);
+int pl_fpolyline_r (plPlotter *plotter, const double *x, const double *y, int n);
+int pl_fpolycont_r (plPlotter *plotter, const double *x, const double *y, int n);
 int pl_fspace_r (plPlotter *plotter, double x0, double y0, double x1, double y1);
 int pl_fspace2_r (plPlotter *plotter, double x0, double y0, double x1, double y1, double x2, double y2);
 
@@ -108,10 +108,12 @@ typedef struct
    "boxes" (rectangles aligned with the coordinate axes).
 
    A simple path that is a sequence of segments is represented internally
-   as a list of plPathSegments.  Each contains a single endpoint (x,y), and
+   as a list of segments.  Each contains a single endpoint (x,y), and
    specifies how to get there (e.g., via a pen-up motion, which is used for
    the first point in a path, or via a line segment, or a curve defined by
-   control points).
+   control points).  In a plPath the endpoints, types and control points
+   of the segments are stored in separate arrays; a plPathSegment bundles
+   them, for code that handles one segment at a time.
    
    A well-formed simple path of this `segment list' type has the form:
    { moveto { line | arc | ellarc | quad | cubic }* { closepath }? } */
@@ -131,6 +133,16 @@ typedef struct
   plPoint pd;			/* additional control point (S_CUBIC only) */
 } plPathSegment;
 
+/* Control points of a curved path segment.  In a plPath these are kept
+   in a side table parallel to the endpoints, which is allocated only once
+   the path acquires a segment that is not a line, so that a polyline costs
+   little more than its vertices. */
+typedef struct
+{
+  plPoint pc;			/* intermediate control point */
+  plPoint pd;			/* additional control point (S_CUBIC only) */
+} plPathControls;
+
 /* Allowed values for the path type field in a plPath (see below). */
 typedef enum 
 { 
@@ -151,9 +163,11 @@ typedef struct
   plPathType type;	/* PATH_{SEGMENT_LIST,CIRCLE,ELLIPSE,BOX} */
   double llx, lly, urx, ury;    /* bounding box */
   /* simple path of segment list type */
-  plPathSegment *segments;	/* list of path segments */
+  plPoint *points;		/* endpoints of path segments */
+  unsigned char *types;		/* segment types (plPathSegmentType values) */
+  plPathControls *controls;	/* control points, or NULL if no curves */
   int num_segments;		/* number of segments in list */
-  int segments_len;		/* length of buffer for list storage (bytes) */
+  int segments_len;		/* length of buffers for list storage */
   bool primitive;		/* advisory (see above; some Plotters use it)*/
   /* simple path of built-in primitive type (circle/ellipse/box) */
   plPoint pc;			/* CIRCLE/ELLIPSE: center */
@@ -176,6 +190,21 @@ typedef struct
   double angle;			/* subtended angle (for S_ARC, if used) */
 } plIntPathSegment;
 
+/* A Plotter's pool of released paths and drawing states.  While a page is
+   open, a path that has been painted, or a drawing state that has been
+   popped off the stack, is kept here for reuse rather than freed; paths
+   keep their segment buffers.  The pool is emptied when the page is
+   closed or erased. */
+
+#define PL_PATH_POOL_SIZE 16
+
+typedef struct
+{
+  plPath *paths[PL_PATH_POOL_SIZE]; /* empty paths */
+  int num_paths;		/* number of paths in pool */
+  struct plDrawStateStruct *drawstates;	/* free list, via `previous' */
+} plPool;
+
 /* Values for the parameters `allowed_{arc|ellarc|quad|cubic}_scaling' of
    any Plotter.  Those parameters specify which sorts of user frame ->
    device frame affine transformation are allowed, if an arc or Bezier that
@@ -245,6 +274,13 @@ typedef struct
 #define MI_PIXEL_INDEX_TYPE 0
 #define MI_PIXEL_RGB_TYPE 1
 
+/* A miPixel is MI_PIXEL_SIZE bytes: the `type' field followed by the
+   color index, or by the red, green and blue bytes.  The rows of a canvas
+   are contiguous arrays of miPixels, so the PNM, PNG and GIF writers read
+   them as bytes (see _pl_canvas_rgb_row() etc. in b_closepl.c). */
+#define MI_PIXEL_SIZE 4
+#define MI_PIXEL_COLOR_OFFSET 1
+
 #define MI_SAME_PIXEL(pixel1,pixel2) \
   (((pixel1).type == MI_PIXEL_INDEX_TYPE \
     && (pixel2).type == MI_PIXEL_INDEX_TYPE \
@@ -527,6 +563,34 @@ typedef struct
   plCachedColorNameInfo *cached_colors;	/* head of linked list */
 } plColorNameCache;
 
+/* A Plotter's cache of Hershey glyphs, as drawn by the Hershey text
+   routines in g_alab_her.c.  Each entry holds the strokes of a glyph,
+   already decoded, sheared, scaled and rotated into user-frame offsets, so
+   that drawing the glyph again (e.g., the digits in a plot's tick labels)
+   needn't decode it.  The cache is direct-mapped, by glyph number. */
+
+#define PL_HERSHEY_GLYPH_CACHE_SIZE 256
+
+typedef struct
+{
+  const unsigned char *glyph;	/* glyph in Hershey array, or NULL if unused */
+  double charsize;		/* relative size */
+  double shear;			/* obliquing */
+  double font_size;		/* font size, user units */
+  double rotation;		/* text rotation, degrees */
+  plPoint *offsets;		/* strokes, as offsets in the user frame */
+  unsigned char *pendown;	/* stroke drawn, rather than a move? */
+  int num_strokes;		/* number of strokes */
+  int strokes_len;		/* length of stroke arrays */
+} plCachedHersheyGlyph;
+
+typedef struct
+{
+  plCachedHersheyGlyph glyphs[PL_HERSHEY_GLYPH_CACHE_SIZE];
+  double *x, *y;		/* scratch vertex arrays, for drawing */
+  int xy_len;			/* length of scratch arrays */
+} plHersheyGlyphCache;
+
 #ifndef X_DISPLAY_MISSING
 /* Each X DrawablePlotter (or X Plotter) keeps track of which fonts have
    been request from an X server, in any connection, by constructing a
@@ -567,7 +631,7 @@ typedef struct plColorRecordStruct
    Plotter class (should be moved elsewhere if possible). */
 
 /* Number of recognized Plotter parameters (see g_params2.c). */
-#define NUM_PLOTTER_PARAMETERS 33
+#define NUM_PLOTTER_PARAMETERS 43
 
 /* Maximum number of pens, or logical pens, for an HP-GL/2 device.  Some
    such devices permit as many as 256, but all should permit at least 32.
@@ -736,6 +800,9 @@ typedef struct
   /* cache of previously retrieved color names (used for speed) */
   plColorNameCache *color_name_cache;/* pointer to color name cache */
 
+  /* cache of previously drawn Hershey glyphs (also used for speed) */
+  plHersheyGlyphCache *hershey_glyph_cache; /* created when first needed */
+
   /* info on the device coordinate frame (ranges for viewport in terms of
      native device coordinates, etc.; note that if flipped_y=true, then
      jmax<jmin or ymax<ymin) */
@@ -777,6 +844,9 @@ typedef struct
   plOutbuf *page;		/* D: output buffer for current page */
   plOutbuf *first_page;		/* D: first page (if a linked list is kept) */
 
+  /* recycled paths and drawing states, for the current page */
+  plPool pool;			/* D: see g_subpaths.c, g_savestate.c */
+
 } plPlotterData;
 
 /* The macro Q___ is used for declaring Plotter methods (as function
@@ -977,6 +1047,9 @@ typedef struct plPlotterStruct	/* this tag is used only by libplot */
   int flushpl (void);
   int fmarker (double x, double y, int type, double size);
   int fmarkerrel (double dx, double dy, int type, double size);
+  int fmarkers (const double *x, const double *y, int n, int type, double size);
+  int fimage (double x0, double y0, double x1, double y1, int width, int height, const unsigned char *rgb);
+  int getimage (int *width, int *height, unsigned char *rgb);
   int fmiterlimit (double limit);
   int fmove (double x, double y);
   int fmoverel (double dx, double dy);
@@ -984,6 +1057,8 @@ typedef struct plPlotterStruct	/* this tag is used only by libplot */
   int fontsize (int size);
   int fpoint (double x, double y);
   int fpointrel (double dx, double dy);
+  int fpolyline (const double *x, const double *y, int n);
+  int fpolycont (const double *x, const double *y, int n);
   int frotate (double theta);
   int fscale (double x, double y);
   int fsetmatrix (double m0, double m1, double m2, double m3, double m4, double m5);
@@ -1104,11 +1179,30 @@ typedef struct plPlotterStruct	/* this tag is used only by libplot */
      but returns `false'. */
   Q___(bool,paint_marker) (R___(struct plPlotterStruct *_plotter) int type, double size);
 
+  /* Internal `draw markers' method, called when the API method markers()
+     is invoked to draw many identical markers at once.  Return value
+     indicates whether the markers were drawn; `false' means that they
+     should be drawn one at a time by marker().  Plotters that can reuse
+     a single rendering of the marker (a stamped raster, or a PS or SVG
+     definition) override it.  The generic version returns `false'. */
+  Q___(bool,paint_markers) (R___(struct plPlotterStruct *_plotter) const double *x, const double *y, int n, int type, double size);
+
   /* Internal `draw point' method, called when the API method point() is
      invoked.  There's no standard definition of a `point', so Plotters are
      free to implement this as they see fit. */
   Q___(void,paint_point) (S___(struct plPlotterStruct *_plotter));
 
+  /* Internal `draw image' method, called when the API method image() is
+     invoked.  Return value indicates whether the image was drawn; `false'
+     means that image() should draw each pixel as a filled box.  The
+     generic version returns `false'. */
+  Q___(bool,paint_image) (R___(struct plPlotterStruct *_plotter) double x0, double y0, double x1, double y1, int width, int height, const unsigned char *rgb);
+
+  /* Internal `read image' method, called when the API method getimage()
+     is invoked.  Return value indicates whether the Plotter has a canvas
+     that could be read.  The generic version returns `false'. */
+  Q___(bool,read_image) (R___(struct plPlotterStruct *_plotter) int *width, int *height, unsigned char *rgb);
+
   /* Internal, Plotter-specific versions of the `alabel' and `flabelwidth'
      methods, which are applied to single-line text strings in a single
      font (no escape sequences, etc.).  The API methods alabel and
@@ -1189,8 +1283,13 @@ typedef struct plPlotterStruct	/* this tag is used only by libplot */
   /* data members specific to Bitmap Plotters */
   void * b_arc_cache_data;	/* pointer to cache (used by miPolyArc_r) */
   int b_xn, b_yn;		/* bitmap dimensions */
+  int b_antialias;		/* supersampling factor (1 = aliased) */
   void * b_painted_set;	/* D: libxmi's canvas (a (miPaintedSet *)) */
   void * b_canvas;		/* D: libxmi's canvas (a (miCanvas *)) */
+  void * b_marker_stamp;	/* D: last rasterized marker, see b_point.c */
+  int b_image_type;		/* D: 0/1/2 = mono/grey/color, as painted */
+  plColor b_palette[256];	/* D: colors painted (24-bit RGB) */
+  int b_num_palette_colors;	/* D: number of colors painted, -1 if >256 */
   /* data members specific to Metafile Plotters */
   /* 0. parameters */
   bool meta_portable_output;	/* portable, not binary output format? */
@@ -1334,6 +1433,12 @@ typedef struct plPlotterStruct	/* this tag is used only by libplot */
   int cgm_charset_lower;	/* D: lower charset (index into defined list)*/
   int cgm_charset_upper;	/* D: upper charset (index into defined list)*/
   int cgm_restricted_text_type;	/* D: one of CGM_RESTRICTED_TEXT_TYPE_* */
+/* data members specific to PS Plotters */
+  bool ps_streaming;		/* write each page out when it is closed? */
+  double ps_doc_xmin, ps_doc_xmax; /* bounding box of pages written so far */
+  double ps_doc_ymin, ps_doc_ymax;
+  bool ps_font_used_in_doc[NUM_PS_FONTS]; /* PS fonts used so far */
+  bool pcl_font_used_in_doc[NUM_PCL_FONTS]; /* PCL fonts used so far */
 /* data members specific to Illustrator Plotters */
   int ai_version;		/* AI version 3 or AI version 5? */
   double ai_pen_cyan;		/* D: pen color (in CMYK space) */
@@ -1360,6 +1465,14 @@ typedef struct plPlotterStruct	/* this tag is used only by libplot */
   bool s_matrix_is_bogus;	/* D: matrix has been set, but is bogus? */
   plColor s_bgcolor;		/* D: background color (RGB) */
   bool s_bgcolor_suppressed;	/* D: background color suppressed? */
+  int s_decimals;		/* decimals kept in device coordinates, or -1 */
+  bool s_relative;		/* write line paths with relative commands? */
+  bool s_merge_paths;		/* merge consecutive like-styled line paths? */
+  bool s_path_mergeable;	/* D: last element written may be merged into? */
+  unsigned long s_path_start;	/* D: offsets in page of that <path> element, */
+  unsigned long s_path_data_start; /* D: of its path data, */
+  unsigned long s_path_data_end; /* D: of the end of its path data, */
+  unsigned long s_path_end;	/* D: and of its end */
 /* data members specific to PNM Plotters (derived from Bitmap Plotters) */
   bool n_portable_output;	/* portable, not binary output format? */
 #ifdef INCLUDE_PNG_SUPPORT
@@ -1367,14 +1480,18 @@ typedef struct plPlotterStruct	/* this tag is used only by libplot */
   bool z_interlace;		/* interlaced PNG? */
   bool z_transparent;		/* transparent PNG? */
   plColor z_transparent_color;	/* if so, transparent color (24-bit RGB) */
+  int z_compression_level;	/* zlib level 0..9, or -1 for zlib's default */
+  int z_filters;		/* PNG_FILTER_* mask, or 0 for libpng's default */
+  bool z_palette;		/* write indexed PNG if <=256 colors painted? */
 #endif /* INCLUDE_PNG_SUPPORT */
 /* data members specific to GIF Plotters */
   int i_xn, i_yn;		/* bitmap dimensions */
-  int i_num_pixels;		/* total pixels (used by scanner) */
+  int i_num_pixels;		/* total pixels */
   bool i_animation;		/* animated (multi-image) GIF? */
   int i_iterations;		/* number of times GIF should be looped */
   int i_delay;			/* delay after image, in 1/100 sec units */
   bool i_interlace;		/* interlaced GIF? */
+  bool i_lzw;			/* LZW-compressed GIF (else miGIF RLE)? */
   bool i_transparent;		/* transparent GIF? */
   plColor i_transparent_color;	/* if so, transparent color (24-bit RGB) */
   void * i_arc_cache_data;	/* pointer to cache (used by miPolyArc_r) */
@@ -1385,11 +1502,9 @@ typedef struct plPlotterStruct	/* this tag is used only by libplot */
   int i_num_color_indices;	/* D: number of color indices allocated */
   bool i_frame_nonempty;	/* D: something drawn in current frame? */
   int i_bit_depth;		/* D: bit depth (ceil(log2(num_indices))) */
-  int i_pixels_scanned;		/* D: number that scanner has scanned */
-  int i_pass;			/* D: scanner pass (used if interlacing) */
-  plIntPoint i_hot;		/* D: scanner hot spot */
   plColor i_global_colormap[256]; /* D: colormap for first frame (stashed) */
   int i_num_global_color_indices;/* D: number of indices in global colormap */
+  int i_global_bit_depth;	/* D: bit depth of global colormap */
   bool i_header_written;	/* D: GIF header written yet? */
 #ifndef X_DISPLAY_MISSING
 /* data members specific to X Drawable Plotters and X Plotters */
@@ -1407,6 +1522,11 @@ typedef struct plPlotterStruct	/* this tag is used only by libplot */
   bool x_colormap_warning_issued; /* D: issued warning on colormap filling up*/
   bool x_bg_color_warning_issued; /* D: issued warning on bg color */
   int x_paint_pixel_count;	/* D: times point() is invoked to set a pixel*/
+  int x_damage_xmin, x_damage_ymin; /* D: region painted in current frame, */
+  int x_damage_xmax, x_damage_ymax; /*    empty if xmin > xmax */
+  int x_shown_xmin, x_shown_ymin; /* D: region painted in frame on display */
+  int x_shown_xmax, x_shown_ymax;
+  unsigned long x_damage_bg;	/* D: bg pixel value outside those regions */
 /* additional data members specific to X Plotters */
   XtAppContext y_app_con;	/* application context */
   Widget y_toplevel;		/* toplevel widget */
@@ -1575,6 +1695,9 @@ class BitmapPlotter : public Plotter
   bool begin_page (void);
   bool erase_page (void);
   bool end_page (void);
+  bool paint_markers (const double *x, const double *y, int n, int type, double size);
+  bool paint_image (double x0, double y0, double x1, double y1, int width, int height, const unsigned char *rgb);
+  bool read_image (int *width, int *height, unsigned char *rgb);
   void paint_point (void);
   void initialize (void);
   void terminate (void);
@@ -1584,15 +1707,24 @@ class BitmapPlotter : public Plotter
   virtual int _maybe_output_image (void);
   /* BitmapPlotter-specific internal functions */
   void _b_delete_image (void);
+  void _b_delete_marker_stamp (void);
   void _b_draw_elliptic_arc (plPoint p0, plPoint p1, plPoint pc);
   void _b_draw_elliptic_arc_2 (plPoint p0, plPoint p1, plPoint pc);
   void _b_draw_elliptic_arc_internal (int xorigin, int yorigin, unsigned int squaresize_x, unsigned int squaresize_y, int startangle, int anglerange);
   void _b_new_image (void);
+  void * _b_new_marker_stamp (double x, double y, int type, double size);
+  void _b_note_color (int red, int green, int blue);
+  void _b_resolve_coverage (void);
   /* BitmapPlotter-specific data members */
   void * b_arc_cache_data;	/* pointer to cache (used by miPolyArc_r) */
   int b_xn, b_yn;		/* bitmap dimensions */
+  int b_antialias;		/* supersampling factor (1 = aliased) */
   void * b_painted_set;	/* D: libxmi's canvas (a (miPaintedSet *)) */
   void * b_canvas;		/* D: libxmi's canvas (a (miCanvas *)) */
+  void * b_marker_stamp;	/* D: last rasterized marker, see b_point.c */
+  int b_image_type;		/* D: 0/1/2 = mono/grey/color, as painted */
+  plColor b_palette[256];	/* D: colors painted (24-bit RGB) */
+  int b_num_palette_colors;	/* D: number of colors painted, -1 if >256 */
 };
 
 /* The TekPlotter class, which produces Tektronix output */
@@ -1987,6 +2119,8 @@ class PSPlotter : public Plotter
   bool begin_page (void);
   bool erase_page (void);
   bool end_page (void);
+  bool paint_markers (const double *x, const double *y, int n, int type, double size);
+  bool paint_image (double x0, double y0, double x1, double y1, int width, int height, const unsigned char *rgb);
   void paint_point (void);
   void initialize (void);
   void terminate (void);
@@ -1999,6 +2133,13 @@ class PSPlotter : public Plotter
   void _p_fellipse_internal (double x, double y, double rx, double ry, double angle, bool circlep);
   void _p_set_fill_color (void);
   void _p_set_pen_color (void);
+  void _p_stream_page (void);
+  /* PSPlotter-specific data members */
+  bool ps_streaming;		/* write each page out when it is closed? */
+  double ps_doc_xmin, ps_doc_xmax; /* bounding box of pages written so far */
+  double ps_doc_ymin, ps_doc_ymax;
+  bool ps_font_used_in_doc[NUM_PS_FONTS]; /* PS fonts used so far */
+  bool pcl_font_used_in_doc[NUM_PCL_FONTS]; /* PCL fonts used so far */
 };
 
 /* The AIPlotter class, which produces output editable by Adobe Illustrator */
@@ -2087,6 +2228,8 @@ class SVGPlotter : public Plotter
   bool begin_page (void);
   bool erase_page (void);
   bool end_page (void);
+  bool paint_markers (const double *x, const double *y, int n, int type, double size);
+  bool paint_image (double x0, double y0, double x1, double y1, int width, int height, const unsigned char *rgb);
   void paint_point (void);
   void initialize (void);
   void terminate (void);
@@ -2101,6 +2244,14 @@ class SVGPlotter : public Plotter
   bool s_matrix_is_bogus;	/* D: matrix has been set, but is bogus? */
   plColor s_bgcolor;		/* D: background color (RGB) */
   bool s_bgcolor_suppressed;	/* D: background color suppressed? */
+  int s_decimals;		/* decimals kept in device coordinates, or -1 */
+  bool s_relative;		/* write line paths with relative commands? */
+  bool s_merge_paths;		/* merge consecutive like-styled line paths? */
+  bool s_path_mergeable;	/* D: last element written may be merged into? */
+  unsigned long s_path_start;	/* D: offsets in page of that <path> element, */
+  unsigned long s_path_data_start; /* D: of its path data, */
+  unsigned long s_path_data_end; /* D: of the end of its path data, */
+  unsigned long s_path_end;	/* D: and of its end */
 };
 
 /* The PNMPlotter class, which produces PBM/PGM/PPM output; derived from
@@ -2175,6 +2326,9 @@ class PNGPlotter : public BitmapPlotter
   bool z_interlace;		/* interlaced PNG? */
   bool z_transparent;		/* transparent PNG? */
   plColor z_transparent_color;	/* if so, transparent color (24-bit RGB) */
+  int z_compression_level;	/* zlib level 0..9, or -1 for zlib's default */
+  int z_filters;		/* PNG_FILTER_* mask, or 0 for libpng's default */
+  bool z_palette;		/* write indexed PNG if <=256 colors painted? */
 };
 #endif /* INCLUDE_PNG_SUPPORT */
 
@@ -2212,7 +2366,6 @@ class GIFPlotter : public Plotter
   bool paint_paths (void);
   /* GIFPlotter-specific internal functions */
   unsigned char _i_new_color_index (int red, int green, int blue);
-  int _i_scan_pixel (void);
   void _i_delete_image (void);
   void _i_draw_elliptic_arc (plPoint p0, plPoint p1, plPoint pc);
   void _i_draw_elliptic_arc_2 (plPoint p0, plPoint p1, plPoint pc);
@@ -2221,18 +2374,18 @@ class GIFPlotter : public Plotter
   void _i_set_bg_color (void);
   void _i_set_fill_color (void);
   void _i_set_pen_color (void);
-  void _i_start_scan (void);
   void _i_write_gif_header (void);
   void _i_write_gif_image (void);
   void _i_write_gif_trailer (void);
   void _i_write_short_int (unsigned int i);
   /* GIFPlotter-specific data members */
   int i_xn, i_yn;		/* bitmap dimensions */
-  int i_num_pixels;		/* total pixels (used by scanner) */
+  int i_num_pixels;		/* total pixels */
   bool i_animation;		/* animated (multi-image) GIF? */
   int i_iterations;		/* number of times GIF should be looped */
   int i_delay;			/* delay after image, in 1/100 sec units */
   bool i_interlace;		/* interlaced GIF? */
+  bool i_lzw;			/* LZW-compressed GIF (else miGIF RLE)? */
   bool i_transparent;		/* transparent GIF? */
   plColor i_transparent_color;	/* if so, transparent color (24-bit RGB) */
   void * i_arc_cache_data;	/* pointer to cache (used by miPolyArc_r) */
@@ -2243,11 +2396,9 @@ class GIFPlotter : public Plotter
   int i_num_color_indices;	/* D: number of color indices allocated */
   bool i_frame_nonempty;	/* D: something drawn in current frame? */
   int i_bit_depth;		/* D: bit depth (ceil(log2(num_indices))) */
-  int i_pixels_scanned;		/* D: number that scanner has scanned */
-  int i_pass;			/* D: scanner pass (used if interlacing) */
-  plIntPoint i_hot;		/* D: scanner hot spot */
   plColor i_global_colormap[256]; /* D: colormap for first frame (stashed) */
   int i_num_global_color_indices;/* D: number of indices in global colormap */
+  int i_global_bit_depth;	/* D: bit depth of global colormap */
   bool i_header_written;	/* D: GIF header written yet? */
 };
 
@@ -2301,6 +2452,9 @@ class XDrawablePlotter : public Plotter
   bool _x_select_xlfd_font_carefully (const char *x_name, const char *x_name_alt, const char *x_name_alt2, const char *x_name_alt3);
   void _x_add_gcs_to_first_drawing_state (void);
   void _x_delete_gcs_from_first_drawing_state (void);
+  void _x_add_damage (int xmin, int ymin, int xmax, int ymax);
+  bool _x_damage_rect (bool include_shown, int *x, int *y, unsigned int *width, unsigned int *height);
+  void _x_set_full_damage (void);
   void _x_draw_elliptic_arc (plPoint p0, plPoint p1, plPoint pc);
   void _x_draw_elliptic_arc_2 (plPoint p0, plPoint p1, plPoint pc);
   void _x_draw_elliptic_arc_internal (int xorigin, int yorigin, unsigned int squaresize_x, unsigned int squaresize_y, int startangle, int anglerange);
@@ -2323,6 +2477,11 @@ class XDrawablePlotter : public Plotter
   bool x_colormap_warning_issued; /* D: issued warning on colormap filling up*/
   bool x_bg_color_warning_issued; /* D: issued warning on bg color */
   int x_paint_pixel_count;	/* D: times point() is invoked to set a pixel*/
+  int x_damage_xmin, x_damage_ymin; /* D: region painted in current frame, */
+  int x_damage_xmax, x_damage_ymax; /*    empty if xmin > xmax */
+  int x_shown_xmin, x_shown_ymin; /* D: region painted in frame on display */
+  int x_shown_xmax, x_shown_ymax;
+  unsigned long x_damage_bg;	/* D: bg pixel value outside those regions */
 };
 
 /* The XPlotter class, which pops up a window and draws into it */
@@ -38,7 +38,9 @@ const Plotter _pl_a_default_plotter =
   /* internal path-painting methods (endpath() is a wrapper for the first) */
   _pl_a_paint_path, _pl_a_paint_paths, _pl_g_path_is_flushable, _pl_g_maybe_prepaint_segments,
   /* internal methods for drawing of markers and points */
-  _pl_g_paint_marker, _pl_a_paint_point,
+  _pl_g_paint_marker, _pl_g_paint_markers, _pl_a_paint_point,
+  /* internal methods for drawing and reading of raster images */
+  _pl_g_paint_image, _pl_g_read_image,
   /* internal methods that plot strings in Hershey, non-Hershey fonts */
   _pl_g_paint_text_string_with_escapes, _pl_a_paint_text_string,
   _pl_g_get_text_width,
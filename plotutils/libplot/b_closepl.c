@@ -24,6 +24,20 @@ bool
 _pl_b_end_page (S___(Plotter *_plotter))
 {
   int retval;
+  int xn = _plotter->b_xn, yn = _plotter->b_yn;
+
+  /* if the canvas is supersampled, replace it by an anti-aliased canvas of
+     the requested bitmap size, unless the user asked for the supersampled
+     canvas itself */
+  if (_plotter->b_antialias > 1)
+    {
+      const char *resolve_s;
+
+      resolve_s = (const char *)_get_plot_param (_plotter->data, 
+						  "ANTIALIAS_RESOLVE");
+      if (resolve_s == NULL || strcasecmp (resolve_s, "no") != 0)
+	_pl_b_resolve_coverage (S___(_plotter));
+    }
 
   /* Possibly output the page's bitmap.  In the base BitmapPlotter class
      this is a no-op (see below), but it may do something in derived
@@ -33,9 +47,71 @@ _pl_b_end_page (S___(Plotter *_plotter))
   /* tear down */
   _pl_b_delete_image (S___(_plotter));
 
+  /* restore supersampled dimensions, for the next page */
+  _plotter->b_xn = xn;
+  _plotter->b_yn = yn;
+
   return (retval < 0 ? false : true);
 }
 
+/* Downsample the supersampled canvas to the requested bitmap size.  Each
+   output pixel is the average of the b_antialias x b_antialias block of
+   canvas pixels that it covers, i.e. libxmi's aliased scan conversion at
+   subpixel resolution is turned into coverage-based anti-aliasing.  On
+   return, b_canvas and b_xn, b_yn refer to the downsampled canvas. */
+void
+_pl_b_resolve_coverage (S___(Plotter *_plotter))
+{
+  int factor = _plotter->b_antialias;
+  int area = factor * factor;
+  int xn = _plotter->b_xn / factor, yn = _plotter->b_yn / factor;
+  int i, j, ii, jj;
+  miCanvas *canvas = (miCanvas *)_plotter->b_canvas;
+  miCanvas *resolved_canvas;
+  miPixel **src, **dest;
+  miPixel pixel;
+
+  pixel.type = MI_PIXEL_RGB_TYPE;
+  pixel.u.rgb[0] = pixel.u.rgb[1] = pixel.u.rgb[2] = 0;
+  resolved_canvas = miNewCanvas ((unsigned int)xn, (unsigned int)yn, pixel);
+
+  /* the averaged colors replace the painted ones */
+  _plotter->b_image_type = 0;
+  _plotter->b_num_palette_colors = 0;
+
+  src = canvas->drawable->pixmap;
+  dest = resolved_canvas->drawable->pixmap;
+  for (j = 0; j < yn; j++)
+    for (i = 0; i < xn; i++)
+      {
+	unsigned int red = 0, green = 0, blue = 0;
+
+	for (jj = 0; jj < factor; jj++)
+	  {
+	    const miPixel *row = src[j * factor + jj] + i * factor;
+
+	    for (ii = 0; ii < factor; ii++)
+	      {
+		red += row[ii].u.rgb[0];
+		green += row[ii].u.rgb[1];
+		blue += row[ii].u.rgb[2];
+	      }
+	  }
+	dest[j][i].type = MI_PIXEL_RGB_TYPE;
+	dest[j][i].u.rgb[0] = (unsigned char)((red + area / 2) / area);
+	dest[j][i].u.rgb[1] = (unsigned char)((green + area / 2) / area);
+	dest[j][i].u.rgb[2] = (unsigned char)((blue + area / 2) / area);
+	if (i == 0 || !MI_SAME_PIXEL(dest[j][i], dest[j][i - 1]))
+	  _pl_b_note_color (R___(_plotter) dest[j][i].u.rgb[0], 
+			    dest[j][i].u.rgb[1], dest[j][i].u.rgb[2]);
+      }
+
+  miDeleteCanvas (canvas);
+  _plotter->b_canvas = (void *)resolved_canvas;
+  _plotter->b_xn = xn;
+  _plotter->b_yn = yn;
+}
+
 /* tear down image, i.e. deallocate libxmi canvas */
 void
 _pl_b_delete_image (S___(Plotter *_plotter))
@@ -47,6 +123,33 @@ _pl_b_delete_image (S___(Plotter *_plotter))
   _plotter->b_painted_set = (void *)NULL;
 }
 
+/* The canvas row readers below step through a row of miPixels as bytes. */
+typedef char _pl_mi_pixel_size_check[sizeof (miPixel) == MI_PIXEL_SIZE ? 1 : -1];
+
+/* Copy the colors of one row of a canvas into buf: the red, green and
+   blue bytes of each pixel if ncomponents is 3, or only the first byte
+   (the gray level of a gray pixel, or the color index of a GIF pixel) if
+   ncomponents is 1. */
+void
+_pl_canvas_row (const void *canvas, int row, int ncomponents, unsigned char *buf)
+{
+  const miPixmap *drawable = ((const miCanvas *)canvas)->drawable;
+  const unsigned char *p;
+  int i, width = (int)drawable->width;
+
+  p = (const unsigned char *)drawable->pixmap[row] + MI_PIXEL_COLOR_OFFSET;
+  if (ncomponents == 1)
+    for (i = 0; i < width; i++, p += MI_PIXEL_SIZE)
+      buf[i] = p[0];
+  else
+    for (i = 0; i < width; i++, p += MI_PIXEL_SIZE, buf += 3)
+      {
+	buf[0] = p[0];
+	buf[1] = p[1];
+	buf[2] = p[2];
+      }
+}
+
 /* This is the BitmapPlotter-specific version of the _maybe_output_image()
    method, which is invoked when a page is finished.  It's a no-op; in
    derived classes such as the PNMPlotter and PNGPlotter classes, it's
@@ -27,6 +27,7 @@
 
 /* forward references */
 static bool parse_bitmap_size (const char *bitmap_size_s, int *width, int *height);
+static int parse_antialias (const char *antialias_s);
 
 #ifndef LIBPLOTTER
 /* In libplot, this is the initialization for the function-pointer part of
@@ -42,7 +43,9 @@ const Plotter _pl_b_default_plotter =
   /* internal path-painting methods (endpath() is a wrapper for the first) */
   _pl_b_paint_path, _pl_b_paint_paths, _pl_g_path_is_flushable, _pl_g_maybe_prepaint_segments,
   /* internal methods for drawing of markers and points */
-  _pl_g_paint_marker, _pl_b_paint_point,
+  _pl_g_paint_marker, _pl_b_paint_markers, _pl_b_paint_point,
+  /* internal methods for drawing and reading of raster images */
+  _pl_b_paint_image, _pl_b_read_image,
   /* internal methods that plot strings in Hershey, non-Hershey fonts */
   _pl_g_paint_text_string_with_escapes, _pl_g_paint_text_string,
   _pl_g_get_text_width,
@@ -133,13 +136,28 @@ _pl_b_initialize (S___(Plotter *_plotter))
   /* initialize data members specific to this derived class */
   _plotter->b_xn = _plotter->data->imax + 1;
   _plotter->b_yn = _plotter->data->jmin + 1;
+  _plotter->b_antialias = 1;
   _plotter->b_painted_set = (void *)NULL;
   _plotter->b_canvas = (void *)NULL;
+  _plotter->b_marker_stamp = (void *)NULL;
+  _plotter->b_image_type = 0;
+  _plotter->b_num_palette_colors = 0;
 
   /* initialize storage used by libxmi's reentrant miDrawArcs_r() function
      for cacheing rasterized ellipses */
   _plotter->b_arc_cache_data = (void *)miNewEllipseCache ();
 
+  /* should we render anti-aliased output?  If so, libxmi scan-converts
+     onto a canvas that is b_antialias times larger in each dimension, and
+     each output pixel is later computed from the coverage of its
+     subpixels (see b_closepl.c). */
+  {
+    const char *antialias_s;
+
+    antialias_s = (const char *)_get_plot_param (_plotter->data, "ANTIALIAS");
+    _plotter->b_antialias = parse_antialias (antialias_s);
+  }
+
   /* determine the range of device coordinates over which the graphics
      display will extend (and hence the transformation from user to device
      coordinates). */
@@ -160,6 +178,20 @@ _pl_b_initialize (S___(Plotter *_plotter))
       }
   }
 
+  if (_plotter->b_antialias > 1)
+    /* scan-convert onto a supersampled canvas */
+    {
+      _plotter->b_xn *= _plotter->b_antialias;
+      _plotter->b_yn *= _plotter->b_antialias;
+      _plotter->data->imax = _plotter->b_xn - 1;
+      _plotter->data->jmin = _plotter->b_yn - 1;
+
+      /* a Bresenham line would be only one subpixel wide, so use nonzero
+	 default line widths, as real-coordinate Plotters do */
+      _plotter->data->display_coors_type = 
+	(int)DISP_DEVICE_COORS_INTEGER_NON_LIBXMI;
+    }
+
   /* compute the NDC to device-frame affine map, set it in Plotter */
   _compute_ndc_to_device_map (_plotter->data);
 
@@ -186,6 +218,24 @@ parse_bitmap_size (const char *bitmap_size_s, int *width, int *height)
     return false;
 }
 
+/* Parse the ANTIALIAS parameter: "no" means an ordinary aliased canvas,
+   "yes" means the default supersampling factor, and an integer specifies
+   the factor explicitly. */
+static int
+parse_antialias (const char *antialias_s)
+{
+  int factor;
+
+  if (antialias_s == NULL || strcasecmp (antialias_s, "no") == 0)
+    return 1;
+  if (strcasecmp (antialias_s, "yes") == 0)
+    return PL_DEFAULT_ANTIALIAS_FACTOR;
+  if (sscanf (antialias_s, "%d", &factor) != 1 || factor < 1)
+    return 1;
+
+  return IMIN(factor, PL_MAX_ANTIALIAS_FACTOR);
+}
+
 /* The private `terminate' method, which is invoked when a Plotter is
    deleted.  It may do such things as write to an output stream from
    internal storage, deallocate storage, etc.  When this is invoked,
@@ -198,6 +248,9 @@ _pl_b_terminate (S___(Plotter *_plotter))
   /* free storage used by libxmi's reentrant miDrawArcs_r() function */
   miDeleteEllipseCache ((miEllipseCache *)_plotter->b_arc_cache_data);
 
+  /* free the cached marker raster used by paint_markers() */
+  _pl_b_delete_marker_stamp (S___(_plotter));
+
 #ifndef LIBPLOTTER
   /* in libplot, manually invoke superclass termination method */
   _pl_g_terminate (S___(_plotter));
@@ -49,4 +49,47 @@ _pl_b_new_image (S___(Plotter *_plotter))
   /* create libxmi miPaintedSet and miCanvas structs */
   _plotter->b_painted_set = (void *)miNewPaintedSet ();
   _plotter->b_canvas = (void *)miNewCanvas ((unsigned int)_plotter->b_xn, (unsigned int)_plotter->b_yn, pixel);
+
+  /* start recording the colors painted on the canvas */
+  _plotter->b_image_type = 0;
+  _plotter->b_num_palette_colors = 0;
+  _pl_b_note_color (R___(_plotter) red, green, blue);
+}
+
+/* Record a 24-bit color that is about to be painted on the canvas.  This
+   maintains the best type for writing out the canvas (0=mono, 1=grey,
+   2=color), and the palette of painted colors, or -1 as the palette size
+   once more than 256 colors have been painted.  Since colors may be
+   painted over, both are upper bounds, so the image writers can rely on
+   them without scanning the canvas. */
+void
+_pl_b_note_color (R___(Plotter *_plotter) int red, int green, int blue)
+{
+  plColor *palette = _plotter->b_palette;
+  int i, n = _plotter->b_num_palette_colors;
+
+  if (n < 0 && _plotter->b_image_type == 2)
+    return;			/* nothing more to learn */
+
+  if (red != green || red != blue)
+    _plotter->b_image_type = 2;	/* need color */
+  else if (_plotter->b_image_type == 0 && red != 0 && red != 255)
+    _plotter->b_image_type = 1;	/* need grey */
+
+  if (n < 0)
+    return;
+  /* search most recently added colors first */
+  for (i = n - 1; i >= 0; i--)
+    if (palette[i].red == red && palette[i].green == green
+	&& palette[i].blue == blue)
+      return;
+  if (n == 256)
+    {
+      _plotter->b_num_palette_colors = -1;
+      return;
+    }
+  palette[n].red = red;
+  palette[n].green = green;
+  palette[n].blue = blue;
+  _plotter->b_num_palette_colors = n + 1;
 }
@@ -63,12 +63,12 @@ _pl_b_paint_path (S___(Plotter *_plotter))
 	  break;
 
 	if (_plotter->drawstate->path->num_segments == 2
-	    && _plotter->drawstate->path->segments[1].type == S_ARC)
+	    && _plotter->drawstate->path->types[1] == S_ARC)
 	  /* segment buffer contains a single circular arc, not a polyline */
 	  {
-	    p0 = _plotter->drawstate->path->segments[0].p;
-	    p1 = _plotter->drawstate->path->segments[1].p;
-	    pc = _plotter->drawstate->path->segments[1].pc;
+	    p0 = _plotter->drawstate->path->points[0];
+	    p1 = _plotter->drawstate->path->points[1];
+	    pc = _plotter->drawstate->path->controls[1].pc;
 	    
 	    /* use libxmi rendering */
 	    _pl_b_draw_elliptic_arc (R___(_plotter) p0, p1, pc);
@@ -77,12 +77,12 @@ _pl_b_paint_path (S___(Plotter *_plotter))
 	  }
 
 	if (_plotter->drawstate->path->num_segments == 2
-	    && _plotter->drawstate->path->segments[1].type == S_ELLARC)
+	    && _plotter->drawstate->path->types[1] == S_ELLARC)
 	  /* segment buffer contains a single elliptic arc, not a polyline */
 	  {
-	    p0 = _plotter->drawstate->path->segments[0].p;
-	    p1 = _plotter->drawstate->path->segments[1].p;
-	    pc = _plotter->drawstate->path->segments[1].pc;
+	    p0 = _plotter->drawstate->path->points[0];
+	    p1 = _plotter->drawstate->path->points[1];
+	    pc = _plotter->drawstate->path->controls[1].pc;
 	    
 	    /* use libxmi rendering */
 	    _pl_b_draw_elliptic_arc_2 (R___(_plotter) p0, p1, pc);
@@ -106,8 +106,8 @@ _pl_b_paint_path (S___(Plotter *_plotter))
 	    double xu, yu;
 	    int device_x, device_y;
 	    
-	    xu = _plotter->drawstate->path->segments[i].p.x;
-	    yu = _plotter->drawstate->path->segments[i].p.y;
+	    xu = _plotter->drawstate->path->points[i].x;
+	    yu = _plotter->drawstate->path->points[i].y;
 	    if (i > 0 && (xu != xu_last || yu != yu_last))
 	      /* in user space, not all points are the same */
 	      identical_user_coordinates = false;	
@@ -158,6 +158,7 @@ _pl_b_paint_path (S___(Plotter *_plotter))
 	    pixels[0] = bgPixel;
 	    pixels[1] = fgPixel;
 	    miSetGCPixels (pGC, 2, pixels);
+	    _pl_b_note_color (R___(_plotter) red, green, blue);
 	    
 	    /* do the filling */
 
@@ -189,6 +190,7 @@ _pl_b_paint_path (S___(Plotter *_plotter))
 	    pixels[0] = bgPixel;
 	    pixels[1] = fgPixel;
 	    miSetGCPixels (pGC, 2, pixels);
+	    _pl_b_note_color (R___(_plotter) red, green, blue);
 	    
 	    if (polyline_len == 1)
 	      /* Special case: all user-space points in the polyline were
@@ -545,6 +547,7 @@ _pl_b_draw_elliptic_arc_internal (R___(Plotter *_plotter) int xorigin, int yorig
       pixels[0] = bgPixel;
       pixels[1] = fgPixel;
       miSetGCPixels (pGC, 2, pixels);
+      _pl_b_note_color (R___(_plotter) red, green, blue);
       
       /* fill the arc */
       if (squaresize_x <= 1 || squaresize_y <= 1)
@@ -580,6 +583,7 @@ _pl_b_draw_elliptic_arc_internal (R___(Plotter *_plotter) int xorigin, int yorig
       pixels[0] = bgPixel;
       pixels[1] = fgPixel;
       miSetGCPixels (pGC, 2, pixels);
+      _pl_b_note_color (R___(_plotter) red, green, blue);
       
       if (squaresize_x <= 1 || squaresize_y <= 1)
 	/* Won't call miDrawArcs in the usual way, because it performs
@@ -650,3 +654,157 @@ _pl_b_paint_paths (S___(Plotter *_plotter))
 {
   return false;
 }
+
+/* The BitmapPlotter-specific version of the paint_image method.  Each
+   canvas pixel whose center lies inside the image is set to the color of
+   the image pixel that contains it, so the cost is proportional to the
+   number of canvas pixels covered, rather than to the number of image
+   pixels.  The map from the user frame to the device frame may be any
+   nonsingular affine map. */
+
+bool
+_pl_b_paint_image (R___(Plotter *_plotter) double x0, double y0, double x1, double y1, int width, int height, const unsigned char *rgb)
+{
+  miCanvas *canvas = (miCanvas *)_plotter->b_canvas;
+  double local[6], m[6], inverse[6];
+  double xmin, xmax, ymin, ymax;
+  int imin, imax, jmin, jmax, i, j, k;
+
+  if (canvas == (miCanvas *)NULL)
+    return false;
+
+  /* map from the image frame, in which the image pixel in row j and
+     column i is the unit square with lower left corner (i,j), to the
+     device frame */
+  local[0] = (x1 - x0) / width;
+  local[1] = 0.0;
+  local[2] = 0.0;
+  local[3] = (y0 - y1) / height;
+  local[4] = x0;
+  local[5] = y1;
+  _matrix_product (local, _plotter->drawstate->transform.m, m);
+  if (m[0] * m[3] - m[1] * m[2] == 0.0)
+    return true;		/* image is degenerate, nothing to draw */
+  _matrix_inverse (m, inverse);
+
+  /* compute bounding box of image in the device frame */
+  xmin = ymin = DBL_MAX;
+  xmax = ymax = -(DBL_MAX);
+  for (k = 0; k < 4; k++)
+    {
+      double u = (k & 1) ? (double)width : 0.0;
+      double v = (k & 2) ? (double)height : 0.0;
+      double xx = m[4] + u * m[0] + v * m[2];
+      double yy = m[5] + u * m[1] + v * m[3];
+
+      xmin = DMIN(xmin, xx);
+      xmax = DMAX(xmax, xx);
+      ymin = DMIN(ymin, yy);
+      ymax = DMAX(ymax, yy);
+    }
+
+  /* clip to canvas; the center of canvas pixel (i,j) is the point (i,j) of
+     the device frame */
+  xmin = DMAX(xmin, 0.0);
+  xmax = DMIN(xmax, (double)canvas->drawable->width - 1.0);
+  ymin = DMAX(ymin, 0.0);
+  ymax = DMIN(ymax, (double)canvas->drawable->height - 1.0);
+  if (!(xmin <= xmax && ymin <= ymax))
+    return true;		/* image is off the canvas (or NaN) */
+  imin = (int)ceil (xmin);
+  imax = (int)floor (xmax);
+  jmin = (int)ceil (ymin);
+  jmax = (int)floor (ymax);
+
+  for (k = 0; k < width * height; k++)
+    /* skip runs of pixels of one color, e.g. a snapshot's background */
+    if (k == 0 || rgb[3 * k] != rgb[3 * k - 3] 
+	|| rgb[3 * k + 1] != rgb[3 * k - 2] || rgb[3 * k + 2] != rgb[3 * k - 1])
+      _pl_b_note_color (R___(_plotter) rgb[3 * k], rgb[3 * k + 1], rgb[3 * k + 2]);
+
+  if (inverse[1] == 0.0 && inverse[2] == 0.0)
+    {
+      /* axis-aligned, e.g. a tile read with getimage(): the image column
+	 of each canvas column, and the image row of each canvas row, can
+	 be worked out once */
+      int *columns = (int *)_pl_xmalloc ((imax - imin + 1) * sizeof(int));
+
+      for (i = imin; i <= imax; i++)
+	{
+	  double u = inverse[4] + i * inverse[0];
+
+	  columns[i - imin] = (u >= 0.0 && u < width) ? (int)u : -1;
+	}
+      for (j = jmin; j <= jmax; j++)
+	{
+	  miPixel *row = canvas->drawable->pixmap[j];
+	  double v = inverse[5] + j * inverse[3];
+	  const unsigned char *source;
+
+	  if (!(v >= 0.0 && v < height))
+	    continue;
+	  source = rgb + 3 * ((long)v * width);
+	  for (i = imin; i <= imax; i++)
+	    {
+	      const unsigned char *pixel;
+
+	      if (columns[i - imin] < 0)
+		continue;
+	      pixel = source + 3 * columns[i - imin];
+	      row[i].type = MI_PIXEL_RGB_TYPE;
+	      row[i].u.rgb[0] = pixel[0];
+	      row[i].u.rgb[1] = pixel[1];
+	      row[i].u.rgb[2] = pixel[2];
+	    }
+	}
+      free (columns);
+      return true;
+    }
+
+  for (j = jmin; j <= jmax; j++)
+    {
+      miPixel *row = canvas->drawable->pixmap[j];
+      double u0 = inverse[4] + j * inverse[2];
+      double v0 = inverse[5] + j * inverse[3];
+
+      for (i = imin; i <= imax; i++)
+	{
+	  double u = u0 + i * inverse[0];
+	  double v = v0 + i * inverse[1];
+	  const unsigned char *pixel;
+
+	  if (!(u >= 0.0 && u < width && v >= 0.0 && v < height))
+	    continue;
+	  pixel = rgb + 3 * ((long)v * width + (long)u);
+	  row[i].type = MI_PIXEL_RGB_TYPE;
+	  row[i].u.rgb[0] = pixel[0];
+	  row[i].u.rgb[1] = pixel[1];
+	  row[i].u.rgb[2] = pixel[2];
+	}
+    }
+
+  return true;
+}
+
+/* The BitmapPlotter-specific version of the read_image method.  It copies
+   the canvas as it is, i.e. an anti-aliased canvas at its supersampled
+   size, so it can be drawn onto another canvas of the same resolution with
+   image() and come out the same as if it had been drawn there. */
+
+bool
+_pl_b_read_image (R___(Plotter *_plotter) int *width, int *height, unsigned char *rgb)
+{
+  miCanvas *canvas = (miCanvas *)_plotter->b_canvas;
+  int j;
+
+  if (canvas == (miCanvas *)NULL)
+    return false;
+
+  *width = (int)canvas->drawable->width;
+  *height = (int)canvas->drawable->height;
+  if (rgb != (unsigned char *)NULL)
+    for (j = 0; j < *height; j++)
+      _pl_canvas_row ((const void *)canvas, j, 3, rgb + 3 * (long)j * *width);
+
+  return true;
+}
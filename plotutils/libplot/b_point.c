@@ -62,16 +62,32 @@ _pl_b_paint_point (S___(Plotter *_plotter))
       fgPixel.u.rgb[2] = blue;
       pixels[0] = bgPixel;
       pixels[1] = fgPixel;
+      _pl_b_note_color (R___(_plotter) red, green, blue);
       
       /* construct an miGC (graphics context for the libxmi module); copy
 	 attributes from the Plotter's GC to it */
       pGC = miNewGC (2, pixels);
       _set_common_mi_attributes (_plotter->drawstate, (void *)pGC);
       
-      point.x = ixx;
-      point.y = iyy;
-      miDrawPoints ((miPaintedSet *)_plotter->b_painted_set, 
-		    pGC, MI_COORD_MODE_ORIGIN, 1, &point);
+      if (_plotter->b_antialias > 1)
+	/* on a supersampled canvas, a point covers one output pixel */
+	{
+	  miRectangle rect;
+
+	  rect.x = ixx - _plotter->b_antialias / 2;
+	  rect.y = iyy - _plotter->b_antialias / 2;
+	  rect.width = (unsigned int)_plotter->b_antialias;
+	  rect.height = (unsigned int)_plotter->b_antialias;
+	  miFillRectangles ((miPaintedSet *)_plotter->b_painted_set, 
+			    pGC, 1, &rect);
+	}
+      else
+	{
+	  point.x = ixx;
+	  point.y = iyy;
+	  miDrawPoints ((miPaintedSet *)_plotter->b_painted_set, 
+			pGC, MI_COORD_MODE_ORIGIN, 1, &point);
+	}
       
       /* deallocate miGC */
       miDeleteGC (pGC);
@@ -85,3 +101,245 @@ _pl_b_paint_point (S___(Plotter *_plotter))
       miClearPaintedSet ((miPaintedSet *)_plotter->b_painted_set);
     }
 }
+
+/* The BitmapPlotter-specific version of the paint_markers method, which
+   draws n identical marker symbols.  Instead of scan-converting every
+   marker, we scan-convert a single one onto a small scratch canvas and
+   record the pixels it painted as a `stamp', i.e. a list of horizontal
+   runs relative to the marker's center.  Since marker() always centers a
+   marker on integer device coordinates, copying the stamp to each
+   position paints the same pixels as marker() would.  The most recent
+   stamp is cached, so that later batches of the same marker reuse it. */
+
+/* scratch canvases larger than this (in pixels, per side) aren't worth it */
+#define MAX_MARKER_STAMP_SIZE 1024
+
+typedef struct
+{
+  /* the drawing state the marker was scan-converted with */
+  int type;
+  double size;
+  double m[4];			/* linear part of user->device map */
+  plColor fgcolor;
+  int fill_rule_type;
+  double miter_limit;
+  /* the stamp itself */
+  int radius;			/* runs lie within this distance of center */
+  int num_runs;
+  int *runs;			/* (dy, dx, length) triples */
+  miPixel *pixels;		/* pixels of all runs, concatenated */
+} plMarkerStamp;
+
+static bool marker_stamp_matches (const plMarkerStamp *stamp, const plDrawState *drawstate, int type, double size);
+
+bool
+_pl_b_paint_markers (R___(Plotter *_plotter) const double *x, const double *y, int n, int type, double size)
+{
+  plMarkerStamp *stamp;
+  miCanvas *canvas;
+  int width, height, i, k;
+
+  if (_plotter->b_canvas == NULL)
+    return false;
+
+  stamp = (plMarkerStamp *)_plotter->b_marker_stamp;
+  if (stamp == NULL 
+      || !marker_stamp_matches (stamp, _plotter->drawstate, type, size))
+    {
+      _pl_b_delete_marker_stamp (S___(_plotter));
+      stamp = (plMarkerStamp *)_pl_b_new_marker_stamp (R___(_plotter) x[0], y[0], type, size);
+      if (stamp == NULL)
+	return false;
+      _plotter->b_marker_stamp = (void *)stamp;
+    }
+  _pl_b_note_color (R___(_plotter)
+		    ((unsigned int)stamp->fgcolor.red >> 8) & 0xff,
+		    ((unsigned int)stamp->fgcolor.green >> 8) & 0xff,
+		    ((unsigned int)stamp->fgcolor.blue >> 8) & 0xff);
+
+  canvas = (miCanvas *)_plotter->b_canvas;
+  width = (int)canvas->drawable->width;
+  height = (int)canvas->drawable->height;
+
+  for (i = 0; i < n; i++)
+    {
+      double xx, yy;
+      int ixx, iyy;
+      const int *run = stamp->runs;
+      const miPixel *pixel = stamp->pixels;
+
+      xx = XD(x[i], y[i]);
+      yy = YD(x[i], y[i]);
+
+      /* skip markers that can't touch the canvas (also NaNs) */
+      if (!(xx > -stamp->radius - 1 && xx < width + stamp->radius
+	    && yy > -stamp->radius - 1 && yy < height + stamp->radius))
+	continue;
+
+      ixx = IROUND(xx);
+      iyy = IROUND(yy);
+
+      for (k = 0; k < stamp->num_runs; k++, run += 3)
+	{
+	  int row = iyy + run[0];
+	  int col = ixx + run[1];
+	  int len = run[2];
+	  const miPixel *p = pixel;
+
+	  pixel += len;
+	  if (row < 0 || row >= height)
+	    continue;
+	  if (col < 0)
+	    {
+	      p -= col;
+	      len += col;
+	      col = 0;
+	    }
+	  if (col + len > width)
+	    len = width - col;
+	  if (len > 0)
+	    memcpy (&canvas->drawable->pixmap[row][col], p, 
+		    len * sizeof (miPixel));
+	}
+    }
+
+  return true;
+}
+
+/* free the cached stamp, if any */
+void
+_pl_b_delete_marker_stamp (S___(Plotter *_plotter))
+{
+  plMarkerStamp *stamp = (plMarkerStamp *)_plotter->b_marker_stamp;
+
+  if (stamp)
+    {
+      free (stamp->runs);
+      free (stamp->pixels);
+      free (stamp);
+    }
+  _plotter->b_marker_stamp = (void *)NULL;
+}
+
+static bool
+marker_stamp_matches (const plMarkerStamp *stamp, const plDrawState *drawstate, int type, double size)
+{
+  int i;
+
+  if (stamp->type != type || stamp->size != size
+      || stamp->fgcolor.red != drawstate->fgcolor.red
+      || stamp->fgcolor.green != drawstate->fgcolor.green
+      || stamp->fgcolor.blue != drawstate->fgcolor.blue
+      || stamp->fill_rule_type != drawstate->fill_rule_type
+      || stamp->miter_limit != drawstate->miter_limit)
+    return false;
+  for (i = 0; i < 4; i++)
+    if (stamp->m[i] != drawstate->transform.m[i])
+      return false;
+  return true;
+}
+
+/* Scan-convert a marker, centered on a scratch canvas.  It is drawn
+   twice, on canvases with different background colors; the pixels that
+   agree are the ones the marker painted.  Returns a (plMarkerStamp *),
+   or NULL if the marker is too large to be stamped. */
+void *
+_pl_b_new_marker_stamp (R___(Plotter *_plotter) double x, double y, int type, double size)
+{
+  plMarkerStamp *stamp;
+  miCanvas *scratch[2], *saved_canvas;
+  miPixel bg[2];
+  double xx, yy, ux, uy;
+  int radius, side, i, j, k, num_runs, num_pixels;
+
+  radius = (int)(FABS(size) * _matrix_norm (_plotter->drawstate->transform.m)) + 2;
+  side = 2 * radius + 1;
+  if (side > MAX_MARKER_STAMP_SIZE 
+      || side > _plotter->b_xn || side > _plotter->b_yn)
+    return (plMarkerStamp *)NULL;
+
+  /* user coordinates of the center of the scratch canvas, found by
+     displacing the first marker position */
+  xx = XD(x, y);
+  yy = YD(x, y);
+  if (!(xx == xx && yy == yy))
+    return (plMarkerStamp *)NULL;
+  ux = x + XUV(radius - xx, radius - yy);
+  uy = y + YUV(radius - xx, radius - yy);
+
+  for (k = 0; k < 2; k++)
+    {
+      bg[k].type = MI_PIXEL_RGB_TYPE;
+      bg[k].u.rgb[0] = bg[k].u.rgb[1] = bg[k].u.rgb[2] = (k == 0 ? 0x00 : 0xff);
+      scratch[k] = miNewCanvas ((unsigned int)side, (unsigned int)side, bg[k]);
+    }
+
+  saved_canvas = (miCanvas *)_plotter->b_canvas;
+  for (k = 0; k < 2; k++)
+    {
+      _plotter->b_canvas = (void *)scratch[k];
+      _API_fmarker (R___(_plotter) ux, uy, type, size);
+    }
+  _plotter->b_canvas = (void *)saved_canvas;
+
+  /* count runs and pixels */
+  num_runs = num_pixels = 0;
+  for (j = 0; j < side; j++)
+    {
+      bool in_run = false;
+
+      for (i = 0; i < side; i++)
+	{
+	  bool painted = MI_SAME_PIXEL(scratch[0]->drawable->pixmap[j][i],
+				       scratch[1]->drawable->pixmap[j][i]);
+	  if (painted)
+	    {
+	      num_pixels++;
+	      if (!in_run)
+		num_runs++;
+	    }
+	  in_run = painted;
+	}
+    }
+
+  stamp = (plMarkerStamp *)_pl_xmalloc (sizeof (plMarkerStamp));
+  stamp->type = type;
+  stamp->size = size;
+  for (i = 0; i < 4; i++)
+    stamp->m[i] = _plotter->drawstate->transform.m[i];
+  stamp->fgcolor = _plotter->drawstate->fgcolor;
+  stamp->fill_rule_type = _plotter->drawstate->fill_rule_type;
+  stamp->miter_limit = _plotter->drawstate->miter_limit;
+  stamp->radius = radius;
+  stamp->num_runs = num_runs;
+  stamp->runs = (int *)_pl_xmalloc ((3 * num_runs + 1) * sizeof (int));
+  stamp->pixels = (miPixel *)_pl_xmalloc ((num_pixels + 1) * sizeof (miPixel));
+
+  /* record them */
+  num_runs = num_pixels = 0;
+  for (j = 0; j < side; j++)
+    for (i = 0; i < side; i++)
+      {
+	miPixel pixel = scratch[0]->drawable->pixmap[j][i];
+
+	if (!MI_SAME_PIXEL(pixel, scratch[1]->drawable->pixmap[j][i]))
+	  continue;
+	if (i == 0 
+	    || !MI_SAME_PIXEL(scratch[0]->drawable->pixmap[j][i - 1],
+			      scratch[1]->drawable->pixmap[j][i - 1]))
+	  /* start a new run */
+	  {
+	    stamp->runs[3 * num_runs] = j - radius;
+	    stamp->runs[3 * num_runs + 1] = i - radius;
+	    stamp->runs[3 * num_runs + 2] = 0;
+	    num_runs++;
+	  }
+	stamp->runs[3 * num_runs - 1]++;
+	stamp->pixels[num_pixels++] = pixel;
+      }
+
+  for (k = 0; k < 2; k++)
+    miDeleteCanvas (scratch[k]);
+
+  return stamp;
+}
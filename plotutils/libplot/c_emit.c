@@ -416,8 +416,11 @@ _cgm_emit_point (plOutbuf *outbuf, bool no_partitioning, int cgm_encoding, int x
       break;
 
     case CGM_ENCODING_CLEAR_TEXT:
-      sprintf (outbuf->point, " (%d, %d)", x, y);
-      _update_buffer (outbuf);
+      _append_to_outbuf (outbuf, " (", 2);
+      _append_integer (outbuf, x);
+      _append_to_outbuf (outbuf, ", ", 2);
+      _append_integer (outbuf, y);
+      _append_to_outbuf (outbuf, ")", 1);
       break;
     }
 }
@@ -435,6 +438,8 @@ _cgm_emit_points (plOutbuf *outbuf, bool no_partitioning, int cgm_encoding, cons
     {
     case CGM_ENCODING_BINARY:
     default:
+      _reserve_outbuf (outbuf, 
+		       (unsigned long)npoints * 2 * (CGM_BINARY_BYTES_PER_INTEGER + 1));
       for (j = 0; j < npoints; j++)
 	{
 	  int_to_cgm_int (x[j], cgm_int, CGM_BINARY_BYTES_PER_INTEGER);
@@ -468,10 +473,14 @@ _cgm_emit_points (plOutbuf *outbuf, bool no_partitioning, int cgm_encoding, cons
       break;
       
     case CGM_ENCODING_CLEAR_TEXT:
+      _reserve_outbuf (outbuf, (unsigned long)npoints * 28);
       for (i = 0; i < npoints; i++)
 	{
-	  sprintf (outbuf->point, " (%d, %d)", x[i], y[i]);
-	  _update_buffer (outbuf);
+	  _append_to_outbuf (outbuf, " (", 2);
+	  _append_integer (outbuf, x[i]);
+	  _append_to_outbuf (outbuf, ", ", 2);
+	  _append_integer (outbuf, y[i]);
+	  _append_to_outbuf (outbuf, ")", 1);
 	}
       break;
     }
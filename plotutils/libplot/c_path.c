@@ -77,8 +77,8 @@ _pl_c_paint_path (S___(Plotter *_plotter))
 
 	/* check for closure */
 	if ((_plotter->drawstate->path->num_segments >= 3)
-	    && (_plotter->drawstate->path->segments[_plotter->drawstate->path->num_segments - 1].p.x == _plotter->drawstate->path->segments[0].p.x)
-	    && (_plotter->drawstate->path->segments[_plotter->drawstate->path->num_segments - 1].p.y == _plotter->drawstate->path->segments[0].p.y))
+	    && (_plotter->drawstate->path->points[_plotter->drawstate->path->num_segments - 1].x == _plotter->drawstate->path->points[0].x)
+	    && (_plotter->drawstate->path->points[_plotter->drawstate->path->num_segments - 1].y == _plotter->drawstate->path->points[0].y))
 	  closed = true;
 	else
 	  closed = false;		/* 2-point ones should be open */
@@ -101,10 +101,10 @@ _pl_c_paint_path (S___(Plotter *_plotter))
 	xarray = (plIntPathSegment *)_pl_xmalloc (_plotter->drawstate->path->num_segments * sizeof(plIntPathSegment));
       
 	/* add first point of path to xarray[] (a moveto, presumably) */
-	xarray[0].p.x = IROUND(XD(_plotter->drawstate->path->segments[0].p.x, 
-				  _plotter->drawstate->path->segments[0].p.y));
-	xarray[0].p.y = IROUND(YD(_plotter->drawstate->path->segments[0].p.x, 
-				  _plotter->drawstate->path->segments[0].p.y));
+	xarray[0].p.x = IROUND(XD(_plotter->drawstate->path->points[0].x, 
+				  _plotter->drawstate->path->points[0].y));
+	xarray[0].p.y = IROUND(YD(_plotter->drawstate->path->points[0].x, 
+				  _plotter->drawstate->path->points[0].y));
 	polyline_len = 1;
       
 	/* convert to integer CGM coordinates (unlike the HP-GL case [see
@@ -113,13 +113,13 @@ _pl_c_paint_path (S___(Plotter *_plotter))
       
 	for (i = 1; i < _plotter->drawstate->path->num_segments; i++)
 	  {
-	    plPathSegment datapoint;
+	    plPoint datapoint;
 	    double xuser, yuser, xdev, ydev;
 	    int device_x, device_y;
 	    
-	    datapoint = _plotter->drawstate->path->segments[i];
-	    xuser = datapoint.p.x;
-	    yuser = datapoint.p.y;
+	    datapoint = _plotter->drawstate->path->points[i];
+	    xuser = datapoint.x;
+	    yuser = datapoint.y;
 	    xdev = XD(xuser, yuser);
 	    ydev = YD(xuser, yuser);
 	    device_x = IROUND(xdev);
@@ -127,32 +127,35 @@ _pl_c_paint_path (S___(Plotter *_plotter))
 	    
 	    {
 	      plPathSegmentType element_type;
+	      const plPathControls *controls;
 	      int device_xc, device_yc;
 	      
 	      xarray[polyline_len].p.x = device_x;
 	      xarray[polyline_len].p.y = device_y;
-	      element_type = datapoint.type;
+	      element_type = (plPathSegmentType)_plotter->drawstate->path->types[i];
 	      xarray[polyline_len].type = element_type;
 	      
 	      if (element_type == S_ARC || element_type == S_ELLARC)
 		/* an arc or elliptic arc element, so compute center too */
 		{
-		  device_xc = IROUND(XD(datapoint.pc.x, datapoint.pc.y));
-		  device_yc = IROUND(YD(datapoint.pc.x, datapoint.pc.y));
+		  controls = &_plotter->drawstate->path->controls[i];
+		  device_xc = IROUND(XD(controls->pc.x, controls->pc.y));
+		  device_yc = IROUND(YD(controls->pc.x, controls->pc.y));
 		  xarray[polyline_len].pc.x = device_xc;
 		  xarray[polyline_len].pc.y = device_yc;
 		}
 	      else if (element_type == S_CUBIC)
 		/* a cubic Bezier element, so compute control points too */
 		{
+		  controls = &_plotter->drawstate->path->controls[i];
 		  xarray[polyline_len].pc.x 
-		    = IROUND(XD(datapoint.pc.x, datapoint.pc.y));
+		    = IROUND(XD(controls->pc.x, controls->pc.y));
 		  xarray[polyline_len].pc.y 
-		    = IROUND(YD(datapoint.pc.x, datapoint.pc.y));
+		    = IROUND(YD(controls->pc.x, controls->pc.y));
 		  xarray[polyline_len].pd.x
-		    = IROUND(XD(datapoint.pd.x, datapoint.pd.y));
+		    = IROUND(XD(controls->pd.x, controls->pd.y));
 		  xarray[polyline_len].pd.y
-		    = IROUND(YD(datapoint.pd.x, datapoint.pd.y));
+		    = IROUND(YD(controls->pd.x, controls->pd.y));
 		}
 	      
 	      polyline_len++;
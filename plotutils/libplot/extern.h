@@ -500,6 +500,13 @@ enum { DISP_DEVICE_COORS_REAL, DISP_DEVICE_COORS_INTEGER_LIBXMI, DISP_DEVICE_COO
 #define PL_MAX_UNFILLED_PATH_LENGTH 500
 #define PL_MAX_UNFILLED_PATH_LENGTH_STRING "500"
 
+/* Supersampling factor used by Bitmap Plotters (PNM, PNG) when the
+   ANTIALIAS parameter is "yes", and the largest factor that may be
+   requested explicitly.  Each output pixel is the coverage-weighted
+   average of a factor x factor block of libxmi canvas pixels. */
+#define PL_DEFAULT_ANTIALIAS_FACTOR 4
+#define PL_MAX_ANTIALIAS_FACTOR 8
+
 
 /************************************************************************/
 /* DEFINITIONS & EXTERNALS SPECIFIC TO INDIVIDUAL DEVICE DRIVERS */
@@ -1208,9 +1215,13 @@ extern void _add_ellipse_as_bezier3s (plPath *path, plPoint pc, double rx, doubl
 extern void _add_ellipse_as_ellarcs (plPath *path, plPoint pc, double rx, double ry, double angle, bool clockwise);
 extern void _add_ellipse_as_lines (plPath *path, plPoint pc, double rx, double ry, double angle, bool clockwise);
 extern void _add_line (plPath *path, plPoint p);
+extern void _add_lines (plPath *path, const double *x, const double *y, int n);
 extern void _add_moveto (plPath *path, plPoint p);
 extern void _delete_plPath (plPath *path);
 extern void _reset_plPath (plPath *path);
+extern plPath * _new_pooled_plPath (plPool *pool);
+extern void _release_plPath (plPool *pool, plPath *path);
+extern void _clear_plPool (plPool *pool);
 
 /* plOutbuf methods (see g_outbuf.c) */
 extern plOutbuf * _new_outbuf (void);
@@ -1222,6 +1233,13 @@ extern void _reset_outbuf (plOutbuf *outbuf);
 extern void _update_bbox (plOutbuf *bufp, double x, double y);
 extern void _update_buffer (plOutbuf *outbuf);
 extern void _update_buffer_by_added_bytes (plOutbuf *outbuf, int additional);
+extern void _reserve_outbuf (plOutbuf *outbuf, unsigned long additional);
+extern void _append_to_outbuf (plOutbuf *outbuf, const char *s, int n);
+extern void _append_string (plOutbuf *outbuf, const char *s);
+extern void _append_integer (plOutbuf *outbuf, int i);
+extern void _append_double (plOutbuf *outbuf, double x, int precision);
+extern void _append_fixed (plOutbuf *outbuf, double x, int decimals);
+extern int _pl_format_double (char *s, double x, int precision);
 
 /* functions that update a device-frame bounding box for a page, as stored
    in a plOutbuf */
@@ -1249,12 +1267,22 @@ extern void _cgm_emit_command_terminator (plOutbuf *outbuf, int cgm_encoding, in
 
 /* SVGPlotter-related functions */
 extern const char * _libplot_color_to_svg_color (plColor color_48, char charbuf[8]);
+extern void _write_svg_number (plOutbuf *page, double x, int decimals);
+extern int _svg_frame_decimals (const double m[6], int device_decimals);
+
+/* function that reads the rows of a libxmi canvas (a (miCanvas *)) as
+   bytes, for the PNM, PNG and GIF writers (see b_closepl.c) */
+extern void _pl_canvas_row (const void *canvas, int row, int ncomponents, unsigned char *buf);
 
 /* plColorNameCache methods */
 extern bool _string_to_color (const char *name, plColor *color_p, plColorNameCache *color_name_cache);
 extern plColorNameCache * _create_color_name_cache (void);
 extern void _delete_color_name_cache (plColorNameCache *color_cache);
 
+/* plHersheyGlyphCache methods (see g_alab_her.c) */
+extern plHersheyGlyphCache * _create_hershey_glyph_cache (void);
+extern void _delete_hershey_glyph_cache (plHersheyGlyphCache *glyph_cache);
+
 /* Renaming of the global symbols in the libxmi scan conversion library,
    which we include in libplot/libplotter as a rendering module.  We
    prepend each name with "_pl".  Doing this keeps the user-level namespace
@@ -1453,6 +1481,9 @@ extern void _maybe_handle_x_events (Plotter *_plotter);
 #define _API_flushpl pl_flushpl_r
 #define _API_fmarker pl_fmarker_r
 #define _API_fmarkerrel pl_fmarkerrel_r
+#define _API_fmarkers pl_fmarkers_r
+#define _API_fimage pl_fimage_r
+#define _API_getimage pl_getimage_r
 #define _API_fmiterlimit pl_fmiterlimit_r
 #define _API_fmove pl_fmove_r
 #define _API_fmoverel pl_fmoverel_r
@@ -1460,6 +1491,8 @@ extern void _maybe_handle_x_events (Plotter *_plotter);
 #define _API_fontsize pl_fontsize_r
 #define _API_fpoint pl_fpoint_r
 #define _API_fpointrel pl_fpointrel_r
+#define _API_fpolycont pl_fpolycont_r
+#define _API_fpolyline pl_fpolyline_r
 #define _API_frotate pl_frotate_r
 #define _API_fscale pl_fscale_r
 #define _API_fsetmatrix pl_fsetmatrix_r
@@ -1554,6 +1587,9 @@ extern int _API_flinewidth (Plotter *_plotter, double size);
 extern int _API_flushpl (Plotter *_plotter);
 extern int _API_fmarker (Plotter *_plotter, double x, double y, int type, double size);
 extern int _API_fmarkerrel (Plotter *_plotter, double dx, double dy, int type, double size);
+extern int _API_fmarkers (Plotter *_plotter, const double *x, const double *y, int n, int type, double size);
+extern int _API_fimage (Plotter *_plotter, double x0, double y0, double x1, double y1, int width, int height, const unsigned char *rgb);
+extern int _API_getimage (Plotter *_plotter, int *width, int *height, unsigned char *rgb);
 extern int _API_fmiterlimit (Plotter *_plotter, double limit);
 extern int _API_fmove (Plotter *_plotter, double x, double y);
 extern int _API_fmoverel (Plotter *_plotter, double x, double y);
@@ -1561,6 +1597,8 @@ extern int _API_fontname (Plotter *_plotter, const char *s);
 extern int _API_fontsize (Plotter *_plotter, int size);
 extern int _API_fpoint (Plotter *_plotter, double x, double y);
 extern int _API_fpointrel (Plotter *_plotter, double dx, double dy);
+extern int _API_fpolycont (Plotter *_plotter, const double *x, const double *y, int n);
+extern int _API_fpolyline (Plotter *_plotter, const double *x, const double *y, int n);
 extern int _API_frotate (Plotter *_plotter, double theta);
 extern int _API_fscale (Plotter *_plotter, double x, double y);
 extern int _API_fsetmatrix (Plotter *_plotter, double m0, double m1, double m2, double m3, double m4, double m5);
@@ -1598,6 +1636,9 @@ extern bool _pl_g_end_page (Plotter *_plotter);
 extern bool _pl_g_erase_page (Plotter *_plotter);
 extern bool _pl_g_flush_output (Plotter *_plotter);
 extern bool _pl_g_paint_marker (Plotter *_plotter, int type, double size);
+extern bool _pl_g_paint_markers (Plotter *_plotter, const double *x, const double *y, int n, int type, double size);
+extern bool _pl_g_paint_image (Plotter *_plotter, double x0, double y0, double x1, double y1, int width, int height, const unsigned char *rgb);
+extern bool _pl_g_read_image (Plotter *_plotter, int *width, int *height, unsigned char *rgb);
 extern bool _pl_g_paint_paths (Plotter *_plotter);
 extern bool _pl_g_path_is_flushable (Plotter *_plotter);
 extern bool _pl_g_retrieve_font (Plotter *_plotter);
@@ -1702,6 +1743,9 @@ ___END_DECLS
 #define _API_flushpl Plotter::flushpl
 #define _API_fmarker Plotter::fmarker
 #define _API_fmarkerrel Plotter::fmarkerrel
+#define _API_fmarkers Plotter::fmarkers
+#define _API_fimage Plotter::fimage
+#define _API_getimage Plotter::getimage
 #define _API_fmiterlimit Plotter::fmiterlimit
 #define _API_fmove Plotter::fmove
 #define _API_fmoverel Plotter::fmoverel
@@ -1709,6 +1753,8 @@ ___END_DECLS
 #define _API_fontsize Plotter::fontsize
 #define _API_fpoint Plotter::fpoint
 #define _API_fpointrel Plotter::fpointrel
+#define _API_fpolycont Plotter::fpolycont
+#define _API_fpolyline Plotter::fpolyline
 #define _API_frotate Plotter::frotate
 #define _API_fscale Plotter::fscale
 #define _API_fsetmatrix Plotter::fsetmatrix
@@ -1755,6 +1801,9 @@ ___END_DECLS
 #define _pl_g_path_is_flushable Plotter::path_is_flushable
 #define _pl_g_maybe_prepaint_segments Plotter::maybe_prepaint_segments
 #define _pl_g_paint_marker Plotter::paint_marker
+#define _pl_g_paint_markers Plotter::paint_markers
+#define _pl_g_paint_image Plotter::paint_image
+#define _pl_g_read_image Plotter::read_image
 #define _pl_g_paint_path Plotter::paint_path
 #define _pl_g_paint_paths Plotter::paint_paths
 #define _pl_g_paint_point Plotter::paint_point
@@ -1845,6 +1894,9 @@ ___BEGIN_DECLS
 extern bool _pl_b_begin_page (Plotter *_plotter);
 extern bool _pl_b_end_page (Plotter *_plotter);
 extern bool _pl_b_erase_page (Plotter *_plotter);
+extern bool _pl_b_paint_markers (Plotter *_plotter, const double *x, const double *y, int n, int type, double size);
+extern bool _pl_b_paint_image (Plotter *_plotter, double x0, double y0, double x1, double y1, int width, int height, const unsigned char *rgb);
+extern bool _pl_b_read_image (Plotter *_plotter, int *width, int *height, unsigned char *rgb);
 extern bool _pl_b_paint_paths (Plotter *_plotter);
 extern void _pl_b_initialize (Plotter *_plotter);
 extern void _pl_b_paint_path (Plotter *_plotter);
@@ -1854,10 +1906,14 @@ extern void _pl_b_terminate (Plotter *_plotter);
 extern int _pl_b_maybe_output_image (Plotter *_plotter);
 /* other BitmapPlotter internal functions, for libplot */
 extern void _pl_b_delete_image (Plotter *_plotter);
+extern void _pl_b_delete_marker_stamp (Plotter *_plotter);
 extern void _pl_b_draw_elliptic_arc (Plotter *_plotter, plPoint p0, plPoint p1, plPoint pc);
 extern void _pl_b_draw_elliptic_arc_2 (Plotter *_plotter, plPoint p0, plPoint p1, plPoint pc);
 extern void _pl_b_draw_elliptic_arc_internal (Plotter *_plotter, int xorigin, int yorigin, unsigned int squaresize_x, unsigned int squaresize_y, int startangle, int anglerange);
 extern void _pl_b_new_image (Plotter *_plotter);
+extern void * _pl_b_new_marker_stamp (Plotter *_plotter, double x, double y, int type, double size);
+extern void _pl_b_note_color (Plotter *_plotter, int red, int green, int blue);
+extern void _pl_b_resolve_coverage (Plotter *_plotter);
 ___END_DECLS
 #else  /* LIBPLOTTER */
 /* BitmapPlotter protected methods, for libplotter */
@@ -1865,6 +1921,9 @@ ___END_DECLS
 #define _pl_b_end_page BitmapPlotter::end_page
 #define _pl_b_erase_page BitmapPlotter::erase_page
 #define _pl_b_initialize BitmapPlotter::initialize
+#define _pl_b_paint_markers BitmapPlotter::paint_markers
+#define _pl_b_paint_image BitmapPlotter::paint_image
+#define _pl_b_read_image BitmapPlotter::read_image
 #define _pl_b_paint_path BitmapPlotter::paint_path
 #define _pl_b_paint_paths BitmapPlotter::paint_paths
 #define _pl_b_paint_point BitmapPlotter::paint_point
@@ -1873,10 +1932,14 @@ ___END_DECLS
 #define _pl_b_maybe_output_image BitmapPlotter::_maybe_output_image
 /* other BitmapPlotter internal functions, for libplotter */
 #define _pl_b_delete_image BitmapPlotter::_b_delete_image
+#define _pl_b_delete_marker_stamp BitmapPlotter::_b_delete_marker_stamp
 #define _pl_b_draw_elliptic_arc BitmapPlotter::_b_draw_elliptic_arc
 #define _pl_b_draw_elliptic_arc_2 BitmapPlotter::_b_draw_elliptic_arc_2
 #define _pl_b_draw_elliptic_arc_internal BitmapPlotter::_b_draw_elliptic_arc_internal
 #define _pl_b_new_image BitmapPlotter::_b_new_image 
+#define _pl_b_new_marker_stamp BitmapPlotter::_b_new_marker_stamp
+#define _pl_b_note_color BitmapPlotter::_b_note_color
+#define _pl_b_resolve_coverage BitmapPlotter::_b_resolve_coverage
 #endif /* LIBPLOTTER */
 
 #ifndef LIBPLOTTER
@@ -2121,6 +2184,8 @@ ___BEGIN_DECLS
 extern bool _pl_p_begin_page (Plotter *_plotter);
 extern bool _pl_p_end_page (Plotter *_plotter);
 extern bool _pl_p_erase_page (Plotter *_plotter);
+extern bool _pl_p_paint_markers (Plotter *_plotter, const double *x, const double *y, int n, int type, double size);
+extern bool _pl_p_paint_image (Plotter *_plotter, double x0, double y0, double x1, double y1, int width, int height, const unsigned char *rgb);
 extern bool _pl_p_paint_paths (Plotter *_plotter);
 extern double _pl_p_paint_text_string (Plotter *_plotter, const unsigned char *s, int h_just, int v_just);
 extern void _pl_p_initialize (Plotter *_plotter);
@@ -2133,6 +2198,7 @@ extern void _pl_p_compute_idraw_bgcolor (Plotter *_plotter);
 extern void _pl_p_fellipse_internal (Plotter *_plotter, double x, double y, double rx, double ry, double angle, bool circlep);
 extern void _pl_p_set_fill_color (Plotter *_plotter);
 extern void _pl_p_set_pen_color (Plotter *_plotter);
+extern void _pl_p_stream_page (Plotter *_plotter);
 ___END_DECLS
 #else  /* LIBPLOTTER */
 /* PSPlotter protected methods, for libplotter */
@@ -2142,6 +2208,8 @@ ___END_DECLS
 #define _pl_p_paint_text_string PSPlotter::paint_text_string
 #define _pl_p_initialize PSPlotter::initialize
 #define _pl_p_paint_path PSPlotter::paint_path
+#define _pl_p_paint_markers PSPlotter::paint_markers
+#define _pl_p_paint_image PSPlotter::paint_image
 #define _pl_p_paint_paths PSPlotter::paint_paths
 #define _pl_p_paint_point PSPlotter::paint_point
 #define _pl_p_terminate PSPlotter::terminate
@@ -2151,6 +2219,7 @@ ___END_DECLS
 #define _pl_p_fellipse_internal PSPlotter::_p_fellipse_internal
 #define _pl_p_set_fill_color PSPlotter::_p_set_fill_color
 #define _pl_p_set_pen_color PSPlotter::_p_set_pen_color
+#define _pl_p_stream_page PSPlotter::_p_stream_page
 #endif /* LIBPLOTTER */
 
 #ifndef LIBPLOTTER
@@ -2193,6 +2262,8 @@ ___BEGIN_DECLS
 extern bool _pl_s_begin_page (Plotter *_plotter);
 extern bool _pl_s_end_page (Plotter *_plotter);
 extern bool _pl_s_erase_page (Plotter *_plotter);
+extern bool _pl_s_paint_markers (Plotter *_plotter, const double *x, const double *y, int n, int type, double size);
+extern bool _pl_s_paint_image (Plotter *_plotter, double x0, double y0, double x1, double y1, int width, int height, const unsigned char *rgb);
 extern bool _pl_s_paint_paths (Plotter *_plotter);
 extern double _pl_s_paint_text_string (Plotter *_plotter, const unsigned char *s, int h_just, int v_just);
 extern void _pl_s_initialize (Plotter *_plotter);
@@ -2210,6 +2281,8 @@ ___END_DECLS
 #define _pl_s_paint_text_string SVGPlotter::paint_text_string
 #define _pl_s_initialize SVGPlotter::initialize
 #define _pl_s_paint_path SVGPlotter::paint_path
+#define _pl_s_paint_markers SVGPlotter::paint_markers
+#define _pl_s_paint_image SVGPlotter::paint_image
 #define _pl_s_paint_paths SVGPlotter::paint_paths
 #define _pl_s_paint_point SVGPlotter::paint_point
 #define _pl_s_terminate SVGPlotter::terminate
@@ -2273,7 +2346,6 @@ extern void _pl_i_paint_path (Plotter *_plotter);
 extern void _pl_i_paint_point (Plotter *_plotter);
 extern void _pl_i_terminate (Plotter *_plotter);
 /* GIFPlotter internal functions, for libplot */
-extern int _pl_i_scan_pixel (Plotter *_plotter);
 extern unsigned char _pl_i_new_color_index (Plotter *_plotter, int red, int green, int blue);
 extern void _pl_i_delete_image (Plotter *_plotter);
 extern void _pl_i_draw_elliptic_arc (Plotter *_plotter, plPoint p0, plPoint p1, plPoint pc);
@@ -2283,7 +2355,6 @@ extern void _pl_i_new_image (Plotter *_plotter);
 extern void _pl_i_set_bg_color (Plotter *_plotter);
 extern void _pl_i_set_fill_color (Plotter *_plotter);
 extern void _pl_i_set_pen_color (Plotter *_plotter);
-extern void _pl_i_start_scan (Plotter *_plotter);
 extern void _pl_i_write_gif_header (Plotter *_plotter);
 extern void _pl_i_write_gif_image (Plotter *_plotter);
 extern void _pl_i_write_gif_trailer (Plotter *_plotter);
@@ -2300,7 +2371,6 @@ ___END_DECLS
 #define _pl_i_paint_point GIFPlotter::paint_point
 #define _pl_i_terminate GIFPlotter::terminate
 /* GIFPlotter internal functions, for libplotter */
-#define _pl_i_scan_pixel GIFPlotter::_i_scan_pixel
 #define _pl_i_new_color_index GIFPlotter::_i_new_color_index
 #define _pl_i_delete_image GIFPlotter::_i_delete_image
 #define _pl_i_draw_elliptic_arc GIFPlotter::_i_draw_elliptic_arc
@@ -2310,7 +2380,6 @@ ___END_DECLS
 #define _pl_i_set_bg_color GIFPlotter::_i_set_bg_color
 #define _pl_i_set_fill_color GIFPlotter::_i_set_fill_color
 #define _pl_i_set_pen_color GIFPlotter::_i_set_pen_color
-#define _pl_i_start_scan GIFPlotter::_i_start_scan
 #define _pl_i_write_gif_header GIFPlotter::_i_write_gif_header
 #define _pl_i_write_gif_image GIFPlotter::_i_write_gif_image
 #define _pl_i_write_gif_trailer GIFPlotter::_i_write_gif_trailer
@@ -2343,6 +2412,9 @@ extern bool _pl_x_select_font_carefully (Plotter *_plotter, const char *name, co
 extern bool _pl_x_select_xlfd_font_carefully (Plotter *_plotter, const char *x_name, const char *x_name_alt, const char *x_name_alt2, const char *x_name_alt3);
 extern void _pl_x_add_gcs_to_first_drawing_state (Plotter *_plotter);
 extern void _pl_x_delete_gcs_from_first_drawing_state (Plotter *_plotter);
+extern void _pl_x_add_damage (Plotter *_plotter, int xmin, int ymin, int xmax, int ymax);
+extern bool _pl_x_damage_rect (Plotter *_plotter, bool include_shown, int *x, int *y, unsigned int *width, unsigned int *height);
+extern void _pl_x_set_full_damage (Plotter *_plotter);
 extern void _pl_x_draw_elliptic_arc (Plotter *_plotter, plPoint p0, plPoint p1, plPoint pc);
 extern void _pl_x_draw_elliptic_arc_2 (Plotter *_plotter, plPoint p0, plPoint p1, plPoint pc);
 extern void _pl_x_draw_elliptic_arc_internal (Plotter *_plotter, int xorigin, int yorigin, unsigned int squaresize_x, unsigned int squaresize_y, int startangle, int anglerange);
@@ -2393,6 +2465,9 @@ ___END_DECLS
 /* XDrawablePlotter/XPlotter internal functions, for libplotter */
 #define _pl_x_add_gcs_to_first_drawing_state XDrawablePlotter::_x_add_gcs_to_first_drawing_state
 #define _pl_x_delete_gcs_from_first_drawing_state XDrawablePlotter::_x_delete_gcs_from_first_drawing_state
+#define _pl_x_add_damage XDrawablePlotter::_x_add_damage
+#define _pl_x_damage_rect XDrawablePlotter::_x_damage_rect
+#define _pl_x_set_full_damage XDrawablePlotter::_x_set_full_damage
 #define _pl_x_draw_elliptic_arc XDrawablePlotter::_x_draw_elliptic_arc
 #define _pl_x_draw_elliptic_arc_2 XDrawablePlotter::_x_draw_elliptic_arc_2
 #define _pl_x_draw_elliptic_arc_internal XDrawablePlotter::_x_draw_elliptic_arc_internal
@@ -81,23 +81,23 @@ _pl_f_paint_path (S___(Plotter *_plotter))
 	  break;
       
 	if (_plotter->drawstate->path->num_segments == 2
-	    && _plotter->drawstate->path->segments[1].type == S_ARC)
+	    && _plotter->drawstate->path->types[1] == S_ARC)
 	  /* segment buffer contains a single arc, not a polyline */
 	  {
-	    double x0 = _plotter->drawstate->path->segments[0].p.x;
-	    double y0 = _plotter->drawstate->path->segments[0].p.y;      
-	    double x1 = _plotter->drawstate->path->segments[1].p.x;
-	    double y1 = _plotter->drawstate->path->segments[1].p.y;      
-	    double xc = _plotter->drawstate->path->segments[1].pc.x;
-	    double yc = _plotter->drawstate->path->segments[1].pc.y;      
+	    double x0 = _plotter->drawstate->path->points[0].x;
+	    double y0 = _plotter->drawstate->path->points[0].y;      
+	    double x1 = _plotter->drawstate->path->points[1].x;
+	    double y1 = _plotter->drawstate->path->points[1].y;      
+	    double xc = _plotter->drawstate->path->controls[1].pc.x;
+	    double yc = _plotter->drawstate->path->controls[1].pc.y;      
 	    
 	    _pl_f_draw_arc_internal (R___(_plotter) xc, yc, x0, y0, x1, y1);
 	    break;
 	  }
 	
 	if ((_plotter->drawstate->path->num_segments >= 3)/*check for closure*/
-	    && (_plotter->drawstate->path->segments[_plotter->drawstate->path->num_segments - 1].p.x == _plotter->drawstate->path->segments[0].p.x)
-	    && (_plotter->drawstate->path->segments[_plotter->drawstate->path->num_segments - 1].p.y == _plotter->drawstate->path->segments[0].p.y))
+	    && (_plotter->drawstate->path->points[_plotter->drawstate->path->num_segments - 1].x == _plotter->drawstate->path->points[0].x)
+	    && (_plotter->drawstate->path->points[_plotter->drawstate->path->num_segments - 1].y == _plotter->drawstate->path->points[0].y))
 	  closed = true;
 	else
 	  closed = false;		/* 2-point ones should be open */
@@ -184,13 +184,13 @@ _pl_f_paint_path (S___(Plotter *_plotter))
 	
 	for (i=0; i<_plotter->drawstate->path->num_segments; i++)
 	  {
-	    plPathSegment datapoint;
+	    plPoint datapoint;
 	    double xu, yu, xd, yd;
 	    int device_x, device_y;
 	    
-	    datapoint = _plotter->drawstate->path->segments[i];
-	    xu = datapoint.p.x;
-	    yu = datapoint.p.y;
+	    datapoint = _plotter->drawstate->path->points[i];
+	    xu = datapoint.x;
+	    yu = datapoint.y;
 	    xd = XD(xu, yu);
 	    yd = YD(xu, yu);
 	    device_x = IROUND(xd);
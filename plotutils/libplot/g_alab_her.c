@@ -67,6 +67,8 @@
 /* forward references */
 static bool composite_char (unsigned char *composite, unsigned char *character, unsigned char *accent);
 static double label_width_hershey (const unsigned short *label);
+static void hershey_to_user_offset (double deltax, double deltay, double font_size, double rotation, double *dx, double *dy);
+static void cache_hershey_glyph (plCachedHersheyGlyph *cached, const unsigned char *glyph, double charsize, double shear, double font_size, double rotation);
 
 /* An version of the alabel() method that is specific to the case when the
    current Plotter font is a Hershey font.  It handles escape sequences for
@@ -238,14 +240,11 @@ _pl_g_flabelwidth_hershey (R___(Plotter *_plotter) const unsigned char *s)
 void
 _pl_g_draw_hershey_stroke (R___(Plotter *_plotter) bool pendown, double deltax, double deltay)
 {
-  double theta = M_PI * _plotter->drawstate->text_rotation / 180.0;
   double dx, dy;
 
-  deltax = HERSHEY_UNITS_TO_USER_UNITS (deltax);
-  deltay = HERSHEY_UNITS_TO_USER_UNITS (deltay);
-
-  dx = cos(theta) * deltax - sin(theta) * deltay;
-  dy = sin(theta) * deltax + cos(theta) * deltay;
+  hershey_to_user_offset (deltax, deltay, 
+			  _plotter->drawstate->true_font_size,
+			  _plotter->drawstate->text_rotation, &dx, &dy);
 
   if (pendown)
     _API_fcontrel (R___(_plotter) dx, dy);
@@ -444,18 +443,39 @@ _pl_g_draw_hershey_penup_stroke(R___(Plotter *_plotter) double dx, double dy, do
 			     charsize * dy);
 }
 
+/* hershey_to_user_offset() converts a stroke in Hershey units to an
+   offset in the user frame, given the font size in user units and the
+   angle in user space at which the label should be plotted.  (Cf. the
+   HERSHEY_UNITS_TO_USER_UNITS macro.) */
+
+static void
+hershey_to_user_offset (double deltax, double deltay, double font_size, double rotation, double *dx, double *dy)
+{
+  double theta = M_PI * rotation / 180.0;
+
+  deltax = deltax * font_size / HERSHEY_EM;
+  deltay = deltay * font_size / HERSHEY_EM;
+
+  *dx = cos(theta) * deltax - sin(theta) * deltay;
+  *dy = sin(theta) * deltax + cos(theta) * deltay;
+}
+
 /* _pl_g_draw_hershey_glyph() invokes move() and cont() to draw a raw
    Hershey glyph, specified by index in the occidental or oriental glyph
-   arrays.  Size scaling and obliquing (true/false) are specified. */
+   arrays.  Size scaling and obliquing (true/false) are specified.
+
+   The strokes of the glyph, as offsets in the user frame, are kept in the
+   Plotter's glyph cache, so that a glyph drawn repeatedly at the same
+   size and angle is decoded only once.  Each run of pen-down strokes is
+   drawn as a single polyline, with fpolyline(). */
 void
 _pl_g_draw_hershey_glyph (R___(Plotter *_plotter) int glyphnum, double charsize, int type, bool oblique)
 {
-  double xcurr, ycurr;
-  double xfinal, yfinal;
-  bool pendown = false;
   const unsigned char *glyph;
-  double dx, dy;
   double shear;
+  plHersheyGlyphCache *cache;
+  plCachedHersheyGlyph *cached;
+  int i;
   
   shear = oblique ? (SHEAR) : 0.0;
   switch (type)
@@ -469,44 +489,176 @@ _pl_g_draw_hershey_glyph (R___(Plotter *_plotter) int glyphnum, double charsize,
       break;
     }
 
-  if (*glyph != '\0')	/* nonempty glyph */
+  if (*glyph == '\0')		/* empty glyph */
+    return;
+
+  if (_plotter->data->hershey_glyph_cache == (plHersheyGlyphCache *)NULL)
+    _plotter->data->hershey_glyph_cache = _create_hershey_glyph_cache ();
+  cache = _plotter->data->hershey_glyph_cache;
+
+  /* look up glyph in cache; if it's not there at this size, obliquing,
+     font size and angle, decode it into the cache */
+  cached = &(cache->glyphs[(2 * glyphnum + type) % PL_HERSHEY_GLYPH_CACHE_SIZE]);
+  if (cached->glyph != glyph
+      || cached->charsize != charsize
+      || cached->shear != shear
+      || cached->font_size != _plotter->drawstate->true_font_size
+      || cached->rotation != _plotter->drawstate->text_rotation)
+    cache_hershey_glyph (cached, glyph, charsize, shear, 
+			 _plotter->drawstate->true_font_size,
+			 _plotter->drawstate->text_rotation);
+
+  /* make sure scratch arrays can hold the longest polyline */
+  if (cache->xy_len < cached->num_strokes + 1)
+    {
+      cache->xy_len = cached->num_strokes + 1;
+      cache->x = (double *)_pl_xrealloc (cache->x, cache->xy_len * sizeof(double));
+      cache->y = (double *)_pl_xrealloc (cache->y, cache->xy_len * sizeof(double));
+    }
+
+  /* draw the glyph: move for each pen-up stroke, and draw a polyline for
+     each run of pen-down strokes, from the current point */
+  i = 0;
+  while (i < cached->num_strokes)
     {
-      xcurr = charsize * (double)glyph[0];
-      xfinal = charsize * (double)glyph[1];
-      ycurr = yfinal = 0.0;
-      glyph += 2;
-      while (*glyph)
+      int n;
+
+      if (!cached->pendown[i])
 	{
-	  int xnewint;
-	  
-	  xnewint = (int)glyph[0];
-	  
-	  if (xnewint == (int)' ')
-	    pendown = false;
-	  else
-	    {
-	      double xnew, ynew;
-
-	      xnew = (double)charsize * xnewint;
-	      ynew = (double)charsize 
-		* ((int)'R' 
-		   - ((int)glyph[1] + (double)HERSHEY_BASELINE));
-	      dx = xnew - xcurr;
-	      dy = ynew - ycurr;
-	      _pl_g_draw_hershey_stroke (R___(_plotter) 
-					 pendown, dx + shear * dy, dy);
-	      xcurr = xnew, ycurr = ynew;
-	      pendown = true;
-	    }
-	  
-	  glyph +=2;	/* on to next pair */
+	  _API_fmoverel (R___(_plotter) 
+			 cached->offsets[i].x, cached->offsets[i].y);
+	  i++;
+	  continue;
+	}
+
+      cache->x[0] = _plotter->drawstate->pos.x;
+      cache->y[0] = _plotter->drawstate->pos.y;
+      for (n = 1; i < cached->num_strokes && cached->pendown[i]; n++, i++)
+	{
+	  cache->x[n] = cache->x[n - 1] + cached->offsets[i].x;
+	  cache->y[n] = cache->y[n - 1] + cached->offsets[i].y;
+	}
+      _API_fpolyline (R___(_plotter) cache->x, cache->y, n);
+    }
+}
+
+/* cache_hershey_glyph() decodes a nonempty Hershey glyph into a glyph
+   cache entry, as a sequence of strokes in the user frame.  The final
+   stroke is a pen-up one, to the point where the glyph should end. */
+static void
+cache_hershey_glyph (plCachedHersheyGlyph *cached, const unsigned char *glyph, double charsize, double shear, double font_size, double rotation)
+{
+  double xcurr, ycurr;
+  double xfinal, yfinal;
+  bool pendown = false;
+  double dx, dy;
+  int max_strokes;
+
+  /* glyph is a pair of bounds, followed by a pair of chars per stroke */
+  max_strokes = (int)(strlen ((const char *)glyph) - 2) / 2 + 1;
+  if (cached->strokes_len < max_strokes)
+    {
+      if (cached->strokes_len > 0)
+	{
+	  free (cached->offsets);
+	  free (cached->pendown);
 	}
+      cached->offsets = (plPoint *)_pl_xmalloc (max_strokes * sizeof(plPoint));
+      cached->pendown = (unsigned char *)_pl_xmalloc (max_strokes * sizeof(unsigned char));
+      cached->strokes_len = max_strokes;
+    }
+  cached->glyph = glyph;
+  cached->charsize = charsize;
+  cached->shear = shear;
+  cached->font_size = font_size;
+  cached->rotation = rotation;
+  cached->num_strokes = 0;
+
+  xcurr = charsize * (double)glyph[0];
+  xfinal = charsize * (double)glyph[1];
+  ycurr = yfinal = 0.0;
+  glyph += 2;
+  while (*glyph)
+    {
+      int xnewint;
+      
+      xnewint = (int)glyph[0];
       
-      /* final penup stroke, to end where we should */
-      dx = xfinal - xcurr;
-      dy = yfinal - ycurr;
-      _pl_g_draw_hershey_stroke (R___(_plotter) false, dx + shear * dy, dy);
+      if (xnewint == (int)' ')
+	pendown = false;
+      else
+	{
+	  double xnew, ynew;
+	  plPoint *offset = &(cached->offsets[cached->num_strokes]);
+
+	  xnew = (double)charsize * xnewint;
+	  ynew = (double)charsize 
+	    * ((int)'R' 
+	       - ((int)glyph[1] + (double)HERSHEY_BASELINE));
+	  dx = xnew - xcurr;
+	  dy = ynew - ycurr;
+	  hershey_to_user_offset (dx + shear * dy, dy, font_size, rotation,
+				  &(offset->x), &(offset->y));
+	  cached->pendown[cached->num_strokes] = (pendown ? 1 : 0);
+	  cached->num_strokes++;
+	  xcurr = xnew, ycurr = ynew;
+	  pendown = true;
+	}
+      
+      glyph +=2;	/* on to next pair */
+    }
+      
+  /* final penup stroke, to end where we should */
+  dx = xfinal - xcurr;
+  dy = yfinal - ycurr;
+  hershey_to_user_offset (dx + shear * dy, dy, font_size, rotation,
+			  &(cached->offsets[cached->num_strokes].x), 
+			  &(cached->offsets[cached->num_strokes].y));
+  cached->pendown[cached->num_strokes] = 0;
+  cached->num_strokes++;
+}
+
+/* ctor and dtor for a Plotter's cache of Hershey glyphs */
+plHersheyGlyphCache *
+_create_hershey_glyph_cache (void)
+{
+  plHersheyGlyphCache *glyph_cache;
+  int i;
+  
+  glyph_cache = 
+    (plHersheyGlyphCache *)_pl_xmalloc (sizeof(plHersheyGlyphCache));
+  for (i = 0; i < PL_HERSHEY_GLYPH_CACHE_SIZE; i++)
+    {
+      glyph_cache->glyphs[i].glyph = (const unsigned char *)NULL;
+      glyph_cache->glyphs[i].offsets = (plPoint *)NULL;
+      glyph_cache->glyphs[i].pendown = (unsigned char *)NULL;
+      glyph_cache->glyphs[i].num_strokes = 0;
+      glyph_cache->glyphs[i].strokes_len = 0;
+    }
+  glyph_cache->x = (double *)NULL;
+  glyph_cache->y = (double *)NULL;
+  glyph_cache->xy_len = 0;
+
+  return glyph_cache;
+}
+
+void
+_delete_hershey_glyph_cache (plHersheyGlyphCache *glyph_cache)
+{
+  int i;
+  
+  for (i = 0; i < PL_HERSHEY_GLYPH_CACHE_SIZE; i++)
+    if (glyph_cache->glyphs[i].strokes_len > 0)
+      {
+	free (glyph_cache->glyphs[i].offsets);
+	free (glyph_cache->glyphs[i].pendown);
+      }
+  if (glyph_cache->xy_len > 0)
+    {
+      free (glyph_cache->x);
+      free (glyph_cache->y);
     }
+  free (glyph_cache);
 }
 
 /* _pl_g_draw_hershey_string() strokes a string beginning at present
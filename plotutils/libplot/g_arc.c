@@ -90,7 +90,7 @@ _API_farc (R___(Plotter *_plotter) double xc, double yc, double x0, double y0, d
   if (_plotter->drawstate->path == (plPath *)NULL)
     /* begin a new path, of segment list type */
     {
-      _plotter->drawstate->path = _new_plPath ();
+      _plotter->drawstate->path = _new_pooled_plPath (&_plotter->data->pool);
       prev_num_segments = 0;
       _add_moveto (_plotter->drawstate->path, p0);
     }
@@ -208,7 +208,7 @@ _API_fellarc (R___(Plotter *_plotter) double xc, double yc, double x0, double y0
   if (_plotter->drawstate->path == (plPath *)NULL)
     /* begin a new path, of segment list type */
     {
-      _plotter->drawstate->path = _new_plPath ();
+      _plotter->drawstate->path = _new_pooled_plPath (&_plotter->data->pool);
       prev_num_segments = 0;
       _add_moveto (_plotter->drawstate->path, p0);
     }
@@ -19,7 +19,10 @@
 /* This file contains the box method, which is a standard part of libplot.
    It draws an object: a box, or upright rectangle with diagonal corners
    x0,y0 and x1,y1.  Boxes are one of the three types of primitive closed
-   path that libplot supports, along with circles and ellipses. */
+   path that libplot supports, along with circles and ellipses.
+
+   This file also contains the image method, which fills a box with a
+   raster image. */
 
 /* Most Plotters obviously require that the map from the user frame to the
    device frame preserve coordinate axes, in order to draw a box as a
@@ -52,7 +55,7 @@ _API_fbox (R___(Plotter *_plotter) double x0, double y0, double x1, double y1)
     _API_endpath (S___(_plotter));
 
   /* begin a new path */
-  _plotter->drawstate->path = _new_plPath ();
+  _plotter->drawstate->path = _new_pooled_plPath (&_plotter->data->pool);
 
   p0.x = x0; 
   p0.y = y0;
@@ -109,3 +112,116 @@ _API_fbox (R___(Plotter *_plotter) double x0, double y0, double x1, double y1)
 
   return 0;
 }
+
+/* The image method, which draws a raster image of width x height pixels
+   into the box with diagonal corners x0,y0 and x1,y1.  `rgb' holds three
+   bytes (red, green, blue) per pixel, row by row.  The first row lies
+   along the y1 edge of the box, and the first pixel of each row along the
+   x0 edge.  Plotters that support raster images draw it as a single
+   object (see the paint_image method); on other Plotters each pixel is
+   drawn as a filled box. */
+
+int
+_API_fimage (R___(Plotter *_plotter) double x0, double y0, double x1, double y1, int width, int height, const unsigned char *rgb)
+{
+  if (!_plotter->data->open)
+    {
+      _plotter->error (R___(_plotter) 
+		       "fimage: invalid operation");
+      return -1;
+    }
+
+  if (width <= 0 || height <= 0)
+    return 0;
+
+  if (_plotter->drawstate->path)
+    _API_endpath (S___(_plotter)); /* flush path if any */
+
+  if (_plotter->paint_image (R___(_plotter) 
+			     x0, y0, x1, y1, width, height, rgb) == false)
+    {
+      double dx = (x1 - x0) / width, dy = (y1 - y0) / height;
+      int i, j;
+
+      _API_savestate (S___(_plotter));
+      _API_filltype (R___(_plotter) 1);
+      for (j = 0; j < height; j++)
+	for (i = 0; i < width; i++)
+	  {
+	    const unsigned char *pixel = rgb + 3 * ((long)j * width + i);
+	    int red = 0x101 * pixel[0];
+	    int green = 0x101 * pixel[1];
+	    int blue = 0x101 * pixel[2];
+
+	    _API_fillcolor (R___(_plotter) red, green, blue);
+	    _API_pencolor (R___(_plotter) red, green, blue);
+	    _API_fbox (R___(_plotter) 
+		       x0 + i * dx, y1 - (j + 1) * dy, 
+		       x0 + (i + 1) * dx, y1 - j * dy);
+	  }
+      _API_restorestate (S___(_plotter));
+    }
+
+  /* move to center (libplot convention) */
+  _plotter->drawstate->pos.x = 0.5 * (x0 + x1);
+  _plotter->drawstate->pos.y = 0.5 * (y0 + y1);
+
+  return 0;
+}
+
+/* The getimage method, the converse of image(), which reads the canvas of
+   a Plotter that has one.  The canvas size in pixels is stored in *width
+   and *height, which for an anti-aliased Plotter is the supersampled size.
+   If rgb is non-NULL, it is filled with three bytes per pixel, in the
+   layout image() takes: row by row, starting with the top row.  The path
+   under construction, if any, is drawn first. */
+
+int
+_API_getimage (R___(Plotter *_plotter) int *width, int *height, unsigned char *rgb)
+{
+  if (!_plotter->data->open)
+    {
+      _plotter->error (R___(_plotter) 
+		       "getimage: invalid operation");
+      return -1;
+    }
+
+  if (_plotter->drawstate->path)
+    _API_endpath (S___(_plotter)); /* flush path if any */
+
+  if (_plotter->read_image (R___(_plotter) width, height, rgb) == false)
+    {
+      _plotter->error (R___(_plotter) 
+		       "getimage: this Plotter has no canvas");
+      return -1;
+    }
+
+  return 0;
+}
+
+/* The paint_image method, which is an internal function that is called
+   when the image() method is invoked.  It draws a raster image, and
+   returns `true' if it did so.  If this returns `false', image() draws
+   each pixel as a filled box. */
+
+/* Most Plotters use this version, which does nothing but returns
+   `false'. */
+
+bool
+_pl_g_paint_image (R___(Plotter *_plotter) double x0, double y0, double x1, double y1, int width, int height, const unsigned char *rgb)
+{
+  return false;
+}
+
+/* The read_image method, which is an internal function that is called
+   when the getimage() method is invoked.  It returns `false' if the
+   Plotter has no canvas. */
+
+/* Most Plotters use this version, which does nothing but returns
+   `false'. */
+
+bool
+_pl_g_read_image (R___(Plotter *_plotter) int *width, int *height, unsigned char *rgb)
+{
+  return false;
+}
@@ -58,7 +58,7 @@ _API_fcircle (R___(Plotter *_plotter) double x, double y, double r)
       bool clockwise;
 
       /* begin a new path */
-      _plotter->drawstate->path = _new_plPath ();
+      _plotter->drawstate->path = _new_pooled_plPath (&_plotter->data->pool);
 
       /* place circle in path buffer */
 
@@ -57,6 +57,9 @@ _API_closepl (S___(Plotter *_plotter))
   /* remove first drawing state too, so we can start afresh */
   _pl_g_delete_first_drawing_state (S___(_plotter));
 
+  /* free the paths and drawing states recycled during the page */
+  _clear_plPool (&_plotter->data->pool);
+
   switch ((int)_plotter->data->output_model)
     {
     case (int)PL_OUTPUT_NONE:
@@ -84,7 +84,9 @@ const Plotter _pl_g_default_plotter =
   /* internal path-painting methods (endpath() is a wrapper for the first) */
   _pl_g_paint_path, _pl_g_paint_paths, _pl_g_path_is_flushable, _pl_g_maybe_prepaint_segments,
   /* internal methods for drawing of markers and points */
-  _pl_g_paint_marker, _pl_g_paint_point,
+  _pl_g_paint_marker, _pl_g_paint_markers, _pl_g_paint_point,
+  /* internal methods for drawing and reading of raster images */
+  _pl_g_paint_image, _pl_g_read_image,
   /* internal methods that plot strings in Hershey, non-Hershey fonts */
   _pl_g_paint_text_string_with_escapes, _pl_g_paint_text_string,
   _pl_g_get_text_width,
@@ -171,6 +173,8 @@ _pl_g_initialize (S___(Plotter *_plotter))
   /* I/O, will not differ in derived classes */
   _plotter->data->page = (plOutbuf *)NULL;
   _plotter->data->first_page = (plOutbuf *)NULL;  
+  _plotter->data->pool.num_paths = 0;
+  _plotter->data->pool.drawstates = (plDrawState *)NULL;
 
   /* basic data members, will not differ in derived classes */
   _plotter->data->open = false;
@@ -244,6 +248,9 @@ _pl_g_initialize (S___(Plotter *_plotter))
   /* create, initialize cache of color name -> RGB correspondences */
   _plotter->data->color_name_cache = _create_color_name_cache ();
 
+  /* cache of Hershey glyphs is created when the first one is drawn */
+  _plotter->data->hershey_glyph_cache = (plHersheyGlyphCache *)NULL;
+
   /* initialize certain data members from values of relevant device
      driver parameters */
 
@@ -330,6 +337,10 @@ _pl_g_terminate (S___(Plotter *_plotter))
   /* free color name cache */
   _delete_color_name_cache (_plotter->data->color_name_cache);
 
+  /* free Hershey glyph cache, if any */
+  if (_plotter->data->hershey_glyph_cache)
+    _delete_hershey_glyph_cache (_plotter->data->hershey_glyph_cache);
+
   /* remove Plotter from sparse Plotter array */
 
 #ifdef PTHREAD_SUPPORT
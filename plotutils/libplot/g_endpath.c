@@ -113,10 +113,10 @@ _API_endpath (S___(Plotter *_plotter))
 
 	      /* check for closure */
 	      if ((path->num_segments >= 3)
-		  && (path->segments[path->num_segments - 1].p.x == 
-		      path->segments[0].p.x)
-		  && (path->segments[path->num_segments - 1].p.y == 
-		      path->segments[0].p.y))
+		  && (path->points[path->num_segments - 1].x == 
+		      path->points[0].x)
+		  && (path->points[path->num_segments - 1].y == 
+		      path->points[0].y))
 		closed = true;
 	      else
 		closed = false;		/* 2-point ones should be open */
@@ -124,12 +124,12 @@ _API_endpath (S___(Plotter *_plotter))
 	      /* draw each point as a filled circle, diameter = line width */
 	      for (j = 0; j < path->num_segments - (closed ? 1 : 0); j++)
 		_API_fcircle (R___(_plotter)
-			      path->segments[j].p.x, 
-			      path->segments[j].p.y, 
+			      path->points[j].x, 
+			      path->points[j].y, 
 			      radius);
 	      if (closed)
 		/* restore graphics cursor */
-		_plotter->drawstate->pos = path->segments[0].p;
+		_plotter->drawstate->pos = path->points[0];
 	    }
 	  
 	  /* Restore graphics state.  This will first do a recursive
@@ -196,8 +196,9 @@ _API_endpath (S___(Plotter *_plotter))
 		      _plotter->drawstate->path = merged_paths[i];
 		      _plotter->paint_path (S___(_plotter));
 		      if (merged_paths[i] != _plotter->drawstate->paths[i])
-			_delete_plPath (merged_paths[i]);
+			_release_plPath (&_plotter->data->pool, merged_paths[i]);
 		    }
+		  free (merged_paths);
 		  _plotter->drawstate->path = (plPath *)NULL;
 		}
 	      
@@ -222,9 +223,10 @@ _API_endpath (S___(Plotter *_plotter))
 	}
     }
   
-  /* compound path is now painted, so remove it from paths buffer */
+  /* compound path is now painted, so remove it from paths buffer (the
+     simple paths go back to the Plotter's pool, for reuse) */
   for (i = 0; i < _plotter->drawstate->num_paths; i++)
-    _delete_plPath (_plotter->drawstate->paths[i]);
+    _release_plPath (&_plotter->data->pool, _plotter->drawstate->paths[i]);
   free (_plotter->drawstate->paths);
   _plotter->drawstate->paths = (plPath **)NULL;
   _plotter->drawstate->num_paths = 0;
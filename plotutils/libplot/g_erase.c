@@ -42,6 +42,9 @@ _API_erase (S___(Plotter *_plotter))
 
   _API_endpath (S___(_plotter)); /* flush path if any */
 
+  /* free the paths and drawing states recycled so far */
+  _clear_plPool (&_plotter->data->pool);
+
   switch ((int)_plotter->data->output_model)
     {
     case (int)PL_OUTPUT_NONE:
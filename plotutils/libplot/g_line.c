@@ -107,7 +107,7 @@ _API_fcont (R___(Plotter *_plotter) double x, double y)
   if (_plotter->drawstate->path == (plPath *)NULL)
     /* begin a new path, of segment list type */
     {
-      _plotter->drawstate->path = _new_plPath ();
+      _plotter->drawstate->path = _new_pooled_plPath (&_plotter->data->pool);
       prev_num_segments = 0;
       _add_moveto (_plotter->drawstate->path, p0);
     }
@@ -147,6 +147,109 @@ _API_fcont (R___(Plotter *_plotter) double x, double y)
   return 0;
 }
 
+/* The fpolyline method draws a polyline through the n points
+   (x[0],y[0])...(x[n-1],y[n-1]).  It is equivalent to fmove() to the first
+   point, followed by fcont() to each of the others, but the vertices are
+   added to the path buffer in bulk, and each batch of them is passed to
+   maybe_prepaint_segments() at once.  As after fcont(), the path is left
+   open: it may be extended, e.g. by fpolycont(), or ended by endpath(). */
+
+int
+_API_fpolyline (R___(Plotter *_plotter) const double *x, const double *y, int n)
+{
+  if (!_plotter->data->open)
+    {
+      _plotter->error (R___(_plotter) 
+		       "fpolyline: invalid operation");
+      return -1;
+    }
+
+  if (n <= 0)
+    return 0;
+
+  /* flush path under construction, if any */
+  _API_fmove (R___(_plotter) x[0], y[0]);
+
+  return _API_fpolycont (R___(_plotter) x + 1, y + 1, n - 1);
+}
+
+/* The fpolycont method continues the path under construction, if any,
+   from the graphics cursor through the n points (x[0],y[0])...
+   (x[n-1],y[n-1]).  It is equivalent to fcont() to each of them, with the
+   vertices added in bulk as in fpolyline(), so a long polyline may be
+   passed in pieces. */
+
+int
+_API_fpolycont (R___(Plotter *_plotter) const double *x, const double *y, int n)
+{
+  int i, count, prev_num_segments;
+
+  if (!_plotter->data->open)
+    {
+      _plotter->error (R___(_plotter) 
+		       "fpolycont: invalid operation");
+      return -1;
+    }
+
+  if (n <= 0)
+    return 0;
+
+  if (_plotter->drawstate->path != (plPath *)NULL
+      && (_plotter->drawstate->path->type != PATH_SEGMENT_LIST
+	  || _plotter->drawstate->path->primitive
+	  || (_plotter->data->have_mixed_paths == false
+	      && _plotter->drawstate->path->num_segments == 2)))
+    /* the path under construction contains a closed primitive, which
+       must be flushed out, or may be a single arc, which may have to be
+       replaced by a polyline; let fcont() deal with the first point */
+    {
+      _API_fcont (R___(_plotter) x[0], y[0]);
+      i = 1;
+    }
+  else
+    i = 0;
+
+  for (; i < n; i += count)
+    {
+      if (_plotter->drawstate->path == (plPath *)NULL)
+	/* begin a new path, of segment list type */
+	{
+	  _plotter->drawstate->path = _new_pooled_plPath (&_plotter->data->pool);
+	  prev_num_segments = 0;
+	  _add_moveto (_plotter->drawstate->path, _plotter->drawstate->pos);
+	}
+      else
+	prev_num_segments = _plotter->drawstate->path->num_segments;
+
+      /* add as many segments as fcont() would before flushing the path,
+	 if it's unfilled; see below */
+      count = n - i;
+      if (_plotter->drawstate->fill_type == 0
+	  && (_plotter->drawstate->path->num_segments 
+	      < _plotter->data->max_unfilled_path_length))
+	count = IMIN(count, (_plotter->data->max_unfilled_path_length
+			     - _plotter->drawstate->path->num_segments));
+      _add_lines (_plotter->drawstate->path, x + i, y + i, count);
+
+      /* move to endpoint */
+      _plotter->drawstate->pos.x = x[i + count - 1];
+      _plotter->drawstate->pos.y = y[i + count - 1];
+
+      /* pass the newly added segments to maybe_prepaint_segments(), as
+	 fcont() does */
+      _plotter->maybe_prepaint_segments (R___(_plotter) prev_num_segments);
+
+      /* flush out the path if it has become too long, as fcont() does */
+      if ((_plotter->drawstate->path->num_segments 
+	   >= _plotter->data->max_unfilled_path_length)
+	  && (_plotter->drawstate->fill_type == 0)
+	  && _plotter->path_is_flushable (S___(_plotter)))
+	_API_endpath (S___(_plotter));
+    }
+
+  return 0;
+}
+
 /* Some Plotters, such as FigPlotters, support the drawing of single arc
    segments as primitives, but they don't allow mixed segment lists to
    appear in the path storage buffer, because they don't know how to handle
@@ -169,14 +272,14 @@ _pl_g_maybe_replace_arc (S___(Plotter *_plotter))
 	&& _plotter->drawstate->path->num_segments == 2))
     return;
 
-  switch (_plotter->drawstate->path->segments[1].type)
+  switch (_plotter->drawstate->path->types[1])
     {
       plPoint pc, pd, p1;
       
     case S_ARC:
       /* segment buffer contains a single circular arc segment, so remove it */
-      pc = _plotter->drawstate->path->segments[1].pc;
-      p1 = _plotter->drawstate->path->segments[1].p;
+      pc = _plotter->drawstate->path->controls[1].pc;
+      p1 = _plotter->drawstate->path->points[1];
       _plotter->drawstate->path->num_segments = 1;
 
       /* add polygonal approximation to circular arc to the segment buffer */
@@ -185,8 +288,8 @@ _pl_g_maybe_replace_arc (S___(Plotter *_plotter))
       
     case S_ELLARC:
       /* segment buffer contains a single elliptic arc segment, so remove it */
-      pc = _plotter->drawstate->path->segments[1].pc;
-      p1 = _plotter->drawstate->path->segments[1].p;
+      pc = _plotter->drawstate->path->controls[1].pc;
+      p1 = _plotter->drawstate->path->points[1];
       _plotter->drawstate->path->num_segments = 1;
 
       /* add polygonal approximation to elliptic arc to the segment buffer */
@@ -195,8 +298,8 @@ _pl_g_maybe_replace_arc (S___(Plotter *_plotter))
 
     case S_QUAD:
       /* segment buffer contains a single quad. Bezier segment, so remove it */
-      pc = _plotter->drawstate->path->segments[1].pc;
-      p1 = _plotter->drawstate->path->segments[1].p;
+      pc = _plotter->drawstate->path->controls[1].pc;
+      p1 = _plotter->drawstate->path->points[1];
       _plotter->drawstate->path->num_segments = 1;
 
       /* add polygonal approximation to quad. Bezier to the segment buffer */
@@ -205,9 +308,9 @@ _pl_g_maybe_replace_arc (S___(Plotter *_plotter))
 
     case S_CUBIC:
       /* segment buffer contains a single cubic Bezier segment, so remove it */
-      pc = _plotter->drawstate->path->segments[1].pc;
-      pd = _plotter->drawstate->path->segments[1].pd;
-      p1 = _plotter->drawstate->path->segments[1].p;
+      pc = _plotter->drawstate->path->controls[1].pc;
+      pd = _plotter->drawstate->path->controls[1].pd;
+      p1 = _plotter->drawstate->path->points[1];
       _plotter->drawstate->path->num_segments = 1;
 
       /* add polygonal approximation to cubic Bezier to the segment buffer */
@@ -27,7 +27,12 @@
    will be a fixed fraction of `size'. */
 
 /* This is a generic version.  Currently, it is overridden only by Metafile
-   and CGM Plotters. */
+   and CGM Plotters.
+
+   This file also contains the markers method, which plots n identical
+   markers at the points (x[i],y[i]).  It is equivalent to invoking marker()
+   n times, but Bitmap, PS and SVG Plotters draw the marker only once and
+   then reuse it (see the paint_markers method). */
 
 #include "sys-defines.h"
 #include "extern.h"
@@ -519,6 +524,47 @@ _API_fmarker (R___(Plotter *_plotter) double x, double y, int type, double size)
   return 0;
 }
 
+int
+_API_fmarkers (R___(Plotter *_plotter) const double *x, const double *y, int n, int type, double size)
+{
+  int i;
+
+  if (!_plotter->data->open)
+    {
+      _plotter->error (R___(_plotter) 
+		       "fmarkers: invalid operation");
+      return -1;
+    }
+
+  if (n <= 0)
+    return 0;
+
+  _API_endpath (S___(_plotter)); /* flush path if any */
+
+  if (_plotter->drawstate->pen_type == 0)
+    /* no pen to draw with, so just update our notion of position */
+    {
+      _plotter->drawstate->pos.x = x[n - 1];
+      _plotter->drawstate->pos.y = y[n - 1];
+      return 0;
+    }
+
+  /* attempt to draw all markers in a Plotter-specific way; only marker
+     symbols qualify, not characters in the current font */
+  if (type > 0 && type % 256 <= 31
+      && _plotter->paint_markers (R___(_plotter) x, y, n, type % 256, size))
+    {
+      _plotter->drawstate->pos.x = x[n - 1];
+      _plotter->drawstate->pos.y = y[n - 1];
+      return 0;
+    }
+
+  for (i = 0; i < n; i++)
+    _API_fmarker (R___(_plotter) x[i], y[i], type, size);
+
+  return 0;
+}
+
 /* The paint_marker method, which is an internal function that is called
    when the marker() method is invoked.  It plots an object: a marker of a
    specified type, at a specified size, at the current location.
@@ -534,3 +580,20 @@ _pl_g_paint_marker (R___(Plotter *_plotter) int type, double size)
 {
   return false;
 }
+
+/* The paint_markers method, which is an internal function that is called
+   when the markers() method is invoked.  It plots n markers of a specified
+   type (a marker symbol, not a character) and size, at the specified
+   locations, and returns `true' if it did so.
+
+   If this returns `false', markers() will plot the markers one at a time
+   by invoking marker(). */
+
+/* Most Plotters use this version, which does nothing but returns
+   `false'. */
+
+bool
+_pl_g_paint_markers (R___(Plotter *_plotter) const double *x, const double *y, int n, int type, double size)
+{
+  return false;
+}
@@ -27,6 +27,12 @@
    method (_UPDATE_BUFFER) is needed because on many systems, sprintf()
    does not return the number of characters it writes.  _UPDATE_BUFFER must
    be called after each call to sprintf(); it is not invoked automatically.
+
+   Code that writes many numbers, such as the vertices of a long path,
+   should instead use the _APPEND_ routines, which know the length of what
+   they write and so need no rescan, and format numbers without going
+   through sprintf().  _RESERVE_OUTBUF makes room for a known amount of
+   output in advance.
    
    Output buffers of this sort are a bit of a kludge.  They may eventually
    be replaced or supplemented by an in-core object hierarchy, which
@@ -112,6 +118,31 @@ _delete_outbuf (plOutbuf *bufp)
     }
 }
 
+/* Grow a plOutbuf if necessary, so that after `additional' more chars
+   have been written it will still be at most half full.  Keeping half of
+   it free leaves room for the next sprintf(), whose length we can't know
+   in advance. */
+
+static void
+_grow_outbuf (plOutbuf *bufp, unsigned long additional)
+{
+  unsigned long newlen;
+
+  newlen = bufp->len;
+  while (bufp->contents + additional > (newlen >> 1))
+    newlen = NEW_OUTBUF_LEN(newlen);
+
+  if (newlen > bufp->len)
+    /* expand buffer */
+    {
+      bufp->base = 
+	(char *)_pl_xrealloc (bufp->base, newlen * sizeof(char));
+      bufp->len = newlen;
+      bufp->point = bufp->base + bufp->contents;
+      bufp->reset_point = bufp->base + bufp->reset_contents;
+    }      
+}
+
 /* UPDATE_BUFFER is called manually, after each sprintf() and other object
    write operation.  It assumes that the buffer is always a null-terminated
    string, so that strlen() can be used, to determine how many additional
@@ -124,6 +155,16 @@ _update_buffer (plOutbuf *bufp)
 
   /* determine how many add'l chars were added */
   additional = strlen (bufp->point);
+  _update_buffer_by_added_bytes (bufp, additional);
+}
+
+/* A variant of _UPDATE_BUFFER in which the caller specifies how many bytes
+   have been added.  Used in cases when the buffer contains something other
+   than a null-terminated string (e.g., raw binary bytes). */
+
+void
+_update_buffer_by_added_bytes (plOutbuf *bufp, int additional)
+{
   bufp->point += additional;
   bufp->contents += additional;
   
@@ -133,52 +174,229 @@ _update_buffer (plOutbuf *bufp)
       fprintf (stderr, "libplot: output buffer overrun\n");
       exit (EXIT_FAILURE);
     }
-  if (bufp->contents > (bufp->len >> 1))
-    /* expand buffer */
+  _grow_outbuf (bufp, 0);
+}
+
+/* Make room in a plOutbuf for `additional' more chars, so that e.g. the
+   vertices of a path of known length can be appended with at most one
+   reallocation. */
+
+void
+_reserve_outbuf (plOutbuf *bufp, unsigned long additional)
+{
+  _grow_outbuf (bufp, additional);
+}
+
+/* Append `n' chars to a plOutbuf, keeping it null-terminated. */
+
+void
+_append_to_outbuf (plOutbuf *bufp, const char *s, int n)
+{
+  _grow_outbuf (bufp, (unsigned long)n);
+  memcpy (bufp->point, s, (size_t)n);
+  bufp->point += n;
+  bufp->contents += n;
+  *(bufp->point) = '\0';
+}
+
+void
+_append_string (plOutbuf *bufp, const char *s)
+{
+  _append_to_outbuf (bufp, s, (int)strlen (s));
+}
+
+/* Append an integer, as sprintf's "%d" would. */
+
+void
+_append_integer (plOutbuf *bufp, int i)
+{
+  char digits[16];
+  unsigned int u;
+  int n = 0;
+
+  _grow_outbuf (bufp, 16);
+  u = (i < 0 ? 0U - (unsigned int)i : (unsigned int)i);
+  do
     {
-      unsigned long oldlen, newlen;
+      digits[n++] = '0' + (char)(u % 10);
+      u /= 10;
+    }
+  while (u);
+  if (i < 0)
+    *(bufp->point++) = '-', bufp->contents++;
+  while (n > 0)
+    *(bufp->point++) = digits[--n], bufp->contents++;
+  *(bufp->point) = '\0';
+}
+
+/* Powers of ten that are exactly representable as doubles. */
+static const double _pl_pow10[] = 
+{
+  1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12
+};
 
-      oldlen = bufp->len;
-      newlen = NEW_OUTBUF_LEN(oldlen);
+/* Append a double, as sprintf's "%.<precision>g" would. */
 
-      bufp->base = 
-	(char *)_pl_xrealloc (bufp->base, newlen * sizeof(char));
-      bufp->len = newlen;
-      bufp->point = bufp->base + bufp->contents;
-      bufp->reset_point = bufp->base + bufp->reset_contents;
-    }      
+void
+_append_double (plOutbuf *bufp, double x, int precision)
+{
+  int n;
+
+  _grow_outbuf (bufp, 32);
+  n = _pl_format_double (bufp->point, x, precision);
+  bufp->point += n;
+  bufp->contents += n;
 }
 
-/* A variant of _UPDATE_BUFFER in which the caller specifies how many bytes
-   have been added.  Used in cases when the buffer contains something other
-   than a null-terminated string (e.g., raw binary bytes). */
+/* Append a double rounded to `decimals' places after the decimal point
+   (0 <= decimals <= 9), like sprintf's "%.<decimals>f" but with trailing
+   zeroes, and a trailing decimal point, removed.  A value that rounds to
+   zero is written as "0".  Rounding is to nearest, with halves rounded
+   away from zero. */
 
 void
-_update_buffer_by_added_bytes (plOutbuf *bufp, int additional)
+_append_fixed (plOutbuf *bufp, double x, int decimals)
 {
-  bufp->point += additional;
-  bufp->contents += additional;
-  
-  if (bufp->contents + 1 > bufp->len) /* need room for NUL */
-    /* shouldn't happen! */
+  char digits[24];
+  double ax, r;
+  int n = 0, nfrac;
+
+  if (decimals < 0 || decimals > 9)
     {
-      fprintf (stderr, "libplot: output buffer overrun\n");
-      exit (EXIT_FAILURE);
+      _append_double (bufp, x, 15);
+      return;
     }
-  if (bufp->contents > (bufp->len >> 1))
-    /* expand buffer */
+  ax = (x < 0.0 ? -x : x) * _pl_pow10[decimals];
+  if (!(ax < 1e15))
+    /* huge, or NaN */
+    {
+      _append_double (bufp, x, 15);
+      return;
+    }
+
+  /* digits of the rounded value, least significant first */
+  r = floor (ax + 0.5);
+  do
+    {
+      digits[n++] = '0' + (char)(int)fmod (r, 10.0);
+      r = floor (r / 10.0);
+    }
+  while (r > 0.0 || n <= decimals);
+
+  /* skip trailing zeroes after the decimal point */
+  nfrac = decimals;
+  while (nfrac > 0 && digits[decimals - nfrac] == '0')
+    nfrac--;
+
+  _grow_outbuf (bufp, 32);
+  if (x < 0.0 && !(n == decimals + 1 && digits[n - 1] == '0' && nfrac == 0))
+    /* negative, and nonzero once rounded */
+    *(bufp->point++) = '-', bufp->contents++;
+  while (n > decimals)
+    *(bufp->point++) = digits[--n], bufp->contents++;
+  if (nfrac > 0)
     {
-      unsigned long oldlen, newlen;
+      *(bufp->point++) = '.', bufp->contents++;
+      while (nfrac-- > 0)
+	*(bufp->point++) = digits[--n], bufp->contents++;
+    }
+  *(bufp->point) = '\0';
+}
 
-      oldlen = bufp->len;
-      newlen = NEW_OUTBUF_LEN(oldlen);
+/* Write a double into a char array, exactly as sprintf (s, "%.*g",
+   precision, x) would, and return the number of chars written (not
+   counting the final NUL).  The common case in our output, a number of
+   modest size printed to at most 9 significant digits in fixed-point
+   notation, is handled by scaling it by an exact power of ten and
+   rounding to an integer.  That takes a single rounding step, so its
+   result agrees with the correctly rounded one unless the scaled value is
+   very close to a half-integer; sprintf() is used for such ties and for
+   everything else (zero, exponential notation, NaN etc.). */
+
+int
+_pl_format_double (char *s, double x, int precision)
+{
+  char digits[16];
+  char *p = s;
+  double ax, scaled, whole, frac;
+  long m;
+  int e, k, i, ndigits, nint;
+
+  if (precision < 1 || precision > 9)
+    goto slow;
+  ax = (x < 0.0 ? -x : x);
+  if (!(ax >= 1e-4 && ax < 1e9))
+    /* also catches zero and NaN */
+    goto slow;
+
+  /* decimal exponent of x, i.e. floor(log10(|x|)) */
+  e = 0;
+  if (ax >= 1.0)
+    while (e < 8 && ax >= _pl_pow10[e + 1])
+      e++;
+  else
+    do
+      e--;
+    while (e > -4 && ax * _pl_pow10[-e] < 1.0);
+
+  /* scale to an integer with `precision' digits, and round it */
+  k = precision - 1 - e;
+  scaled = (k >= 0 ? ax * _pl_pow10[k] : ax / _pl_pow10[-k]);
+  whole = floor (scaled);
+  frac = scaled - whole;
+  if (frac > 0.5 - 1e-6 && frac < 0.5 + 1e-6)
+    /* too close to call */
+    goto slow;
+  m = (long)whole + (frac > 0.5 ? 1 : 0);
+  if (m >= (long)_pl_pow10[precision])
+    /* rounded up to the next power of ten */
+    {
+      m /= 10;
+      e++;
+    }
+  if (e >= precision)
+    /* sprintf would use exponential notation */
+    goto slow;
 
-      bufp->base = 
-	(char *)_pl_xrealloc (bufp->base, newlen * sizeof(char));
-      bufp->len = newlen;
-      bufp->point = bufp->base + bufp->contents;
-      bufp->reset_point = bufp->base + bufp->reset_contents;
-    }      
+  for (i = precision - 1; i >= 0; i--)
+    {
+      digits[i] = '0' + (char)(m % 10);
+      m /= 10;
+    }
+  /* remove trailing zeroes after the decimal point */
+  nint = (e >= 0 ? e + 1 : 0);
+  ndigits = precision;
+  while (ndigits > nint && ndigits > 1 && digits[ndigits - 1] == '0')
+    ndigits--;
+
+  if (x < 0.0)
+    *p++ = '-';
+  if (e >= 0)
+    {
+      for (i = 0; i < nint; i++)
+	*p++ = digits[i];
+      if (ndigits > nint)
+	{
+	  *p++ = '.';
+	  for (; i < ndigits; i++)
+	    *p++ = digits[i];
+	}
+    }
+  else
+    {
+      *p++ = '0';
+      *p++ = '.';
+      for (i = e + 1; i < 0; i++)
+	*p++ = '0';
+      for (i = 0; i < ndigits; i++)
+	*p++ = digits[i];
+    }
+  *p = '\0';
+  return (int)(p - s);
+
+ slow:
+  sprintf (s, "%.*g", precision, x);
+  return (int)strlen (s);
 }
 
 /* update bounding box information for a plOutbuf, to take account of a
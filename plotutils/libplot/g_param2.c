@@ -37,6 +37,8 @@ const struct plParamRecord _known_params[NUM_PLOTTER_PARAMETERS] =
   /* String-valued (i.e. really (char *)-valued */
 
   {"AI_VERSION", (char *)"5", true}, /* ai [obsolescent; undocumented] */
+  {"ANTIALIAS", (char *)"no", true}, /* pnm, png */
+  {"ANTIALIAS_RESOLVE", (char *)"yes", true}, /* pnm, png */
   {"BG_COLOR", (char *)"white", true}, /* X, pnm, gif, cgm */
   {"BITMAPSIZE", (char *)"570x570", true}, /* X, pnm, gif */
   {"CGM_ENCODING", (char *)"binary", true}, /* cgm */
@@ -44,6 +46,7 @@ const struct plParamRecord _known_params[NUM_PLOTTER_PARAMETERS] =
   {"DISPLAY", (char *)"", true}, /* X */
   {"EMULATE_COLOR", (char *)"no", true}, /* all except meta */
   {"GIF_ANIMATION", (char *)"yes", true}, /* gif */
+  {"GIF_COMPRESSION", (char *)"lzw", true}, /* gif */
   {"GIF_DELAY", (char *)"0", true}, /* gif */
   {"GIF_ITERATIONS", (char *)"0", true}, /* gif */
   {"HPGL_ASSIGN_COLORS", (char *)"no", true}, /* hpgl */
@@ -57,8 +60,15 @@ const struct plParamRecord _known_params[NUM_PLOTTER_PARAMETERS] =
   {"PAGESIZE", (char *)"letter", true}, /* hpgl, pcl, fig, cgm, ps, ai */
   {"PCL_ASSIGN_COLORS", (char *)"no", true}, /* pcl */
   {"PCL_BEZIERS", (char *)"yes", true},	/* pcl */
+  {"PNG_COMPRESSION_LEVEL", (char *)"default", true}, /* png */
+  {"PNG_FILTER", (char *)"default", true}, /* png */
+  {"PNG_PALETTE", (char *)"no", true}, /* png */
   {"PNM_PORTABLE", (char *)"no", true}, /* pnm */
+  {"PS_STREAMING", (char *)"no", true}, /* ps */
   {"ROTATION", (char *)"no", true}, /* tek, hpgl, pcl, fig, ps, ai, X, XDrawable */
+  {"SVG_DECIMALS", (char *)"none", true}, /* svg */
+  {"SVG_MERGE_PATHS", (char *)"no", true}, /* svg */
+  {"SVG_RELATIVE", (char *)"no", true}, /* svg */
   {"TERM", (char *)"tek", true}, /* tek only! */
   {"TRANSPARENT_COLOR", (char *)"none", true}, /* gif */
   {"USE_DOUBLE_BUFFERING", (char *)"no", true}, /* X, XDrawable */
@@ -68,8 +68,14 @@ _API_savestate(S___(Plotter *_plotter))
       return -1;
     }
 
-  /* create a new state */
-  drawstate = (plDrawState *)_pl_xmalloc (sizeof(plDrawState));
+  /* create a new state, reusing one popped earlier in the page if any */
+  if (_plotter->data->pool.drawstates)
+    {
+      drawstate = _plotter->data->pool.drawstates;
+      _plotter->data->pool.drawstates = drawstate->previous;
+    }
+  else
+    drawstate = (plDrawState *)_pl_xmalloc (sizeof(plDrawState));
   
   /* copy from old state */
   memcpy (drawstate, oldstate, sizeof(plDrawState));
@@ -174,8 +180,10 @@ _API_restorestate(S___(Plotter *_plotter))
   if (_plotter->drawstate->dash_array_len > 0)
     free ((double *)_plotter->drawstate->dash_array);
 
-  /* pop state off the stack */
-  free (_plotter->drawstate);
+  /* pop state off the stack, keeping it in the Plotter's pool for the
+     next savestate() */
+  _plotter->drawstate->previous = _plotter->data->pool.drawstates;
+  _plotter->data->pool.drawstates = _plotter->drawstate;
   _plotter->drawstate = oldstate;
 
   return 0;
@@ -58,6 +58,10 @@
 #define REL_CUBIC_FLATNESS 5e-4
 
 #define DATAPOINTS_BUFSIZ PL_MAX_UNFILLED_PATH_LENGTH
+
+/* Paths released to a Plotter's pool keep their segment buffers, unless
+   the buffers have grown beyond this many segments. */
+#define POOLED_PATH_MAX_SEGMENTS (4 * DATAPOINTS_BUFSIZ)
 #define DIST(p0,p1) (sqrt( ((p0).x - (p1).x)*((p0).x - (p1).x) \
 			  + ((p0).y - (p1).y)*((p0).y - (p1).y)))
 
@@ -77,7 +81,9 @@ _new_plPath (void)
   path = (plPath *)_pl_xmalloc (sizeof (plPath));
 
   path->type = PATH_SEGMENT_LIST;
-  path->segments = (plPathSegment *)NULL;
+  path->points = (plPoint *)NULL;
+  path->types = (unsigned char *)NULL;
+  path->controls = (plPathControls *)NULL;
   path->segments_len = 0;	/* number of slots allocated */
   path->num_segments = 0;	/* number of slots occupied */
 
@@ -90,6 +96,20 @@ _new_plPath (void)
   return path;
 }
   
+/* free the segment buffers of a plPath (a pooled path that has been
+   reused for a primitive may still have them) */
+static void
+_free_plPath_segments (plPath *path)
+{
+  if (path->segments_len > 0)	/* number of slots allocated */
+    {
+      free (path->points);
+      free (path->types);
+      if (path->controls)
+	free (path->controls);
+    }
+}
+
 /* dtor for plPath class */
 void
 _delete_plPath (plPath *path)
@@ -97,9 +117,7 @@ _delete_plPath (plPath *path)
   if (path == (plPath *)NULL)
     return;
   
-  if (path->type == PATH_SEGMENT_LIST 
-      && path->segments_len > 0) /* number of slots allocated */
-    free (path->segments);
+  _free_plPath_segments (path);
   free (path);
 }
 
@@ -110,10 +128,10 @@ _reset_plPath (plPath *path)
   if (path == (plPath *)NULL)
     return;
   
-  if (path->type == PATH_SEGMENT_LIST 
-      && path->segments_len > 0) /* number of slots allocated */
-    free (path->segments);
-  path->segments = (plPathSegment *)NULL;
+  _free_plPath_segments (path);
+  path->points = (plPoint *)NULL;
+  path->types = (unsigned char *)NULL;
+  path->controls = (plPathControls *)NULL;
   path->segments_len = 0;
   path->type = PATH_SEGMENT_LIST; /* restore to default */
   path->num_segments = 0;
@@ -125,6 +143,110 @@ _reset_plPath (plPath *path)
   path->ury = -(DBL_MAX);
 }
 
+/* Get an empty plPath from a Plotter's pool, or construct one if the pool
+   is empty.  The path is freed with _delete_plPath() or handed back with
+   _release_plPath(), as usual. */
+plPath *
+_new_pooled_plPath (plPool *pool)
+{
+  if (pool->num_paths == 0)
+    return _new_plPath ();
+
+  return pool->paths[--pool->num_paths];
+}
+
+/* Return a plPath that is no longer needed to a Plotter's pool, emptying
+   it but keeping its segment buffers (if they are not too large), so that
+   the next path constructed needn't allocate them.  If the pool is full,
+   the path is deleted. */
+void
+_release_plPath (plPool *pool, plPath *path)
+{
+  if (path == (plPath *)NULL)
+    return;
+
+  if (pool->num_paths == PL_PATH_POOL_SIZE)
+    {
+      _delete_plPath (path);
+      return;
+    }
+
+  if (path->segments_len > POOLED_PATH_MAX_SEGMENTS)
+    _reset_plPath (path);
+  else
+    {
+      path->type = PATH_SEGMENT_LIST; /* restore to default */
+      path->num_segments = 0;
+      path->primitive = false;
+      path->llx = DBL_MAX;
+      path->lly = DBL_MAX;
+      path->urx = -(DBL_MAX);
+      path->ury = -(DBL_MAX);
+    }
+  pool->paths[pool->num_paths++] = path;
+}
+
+/* Free everything in a Plotter's pool of paths and drawing states; done
+   when a page is closed or erased.  The drawing states are bare blocks,
+   the strings in them having been freed when they were popped off the
+   stack (see g_savestate.c). */
+void
+_clear_plPool (plPool *pool)
+{
+  while (pool->num_paths > 0)
+    _delete_plPath (pool->paths[--pool->num_paths]);
+
+  while (pool->drawstates)
+    {
+      plDrawState *drawstate = pool->drawstates;
+
+      pool->drawstates = drawstate->previous;
+      free (drawstate);
+    }
+}
+
+/* Make room for n more segments in a plPath of segment list type.  The
+   buffers are allocated with DATAPOINTS_BUFSIZ slots, and their length is
+   kept a power-of-2 multiple of that; the control point table, if it has
+   been allocated, grows along with them. */
+static void
+_grow_plPath (plPath *path, int n)
+{
+  int len;
+
+  if (path->num_segments + n <= path->segments_len)
+    return;
+
+  len = (path->segments_len > 0 ? path->segments_len : DATAPOINTS_BUFSIZ);
+  while (path->num_segments + n > len)
+    len *= 2;
+
+  path->points = (plPoint *) 
+    _pl_xrealloc (path->points, len * sizeof(plPoint));
+  path->types = (unsigned char *) 
+    _pl_xrealloc (path->types, len * sizeof(unsigned char));
+  if (path->controls)
+    path->controls = (plPathControls *) 
+      _pl_xrealloc (path->controls, len * sizeof(plPathControls));
+  path->segments_len = len;
+}
+
+/* Append a curved segment to a plPath of segment list type, allocating
+   the control point table when the first such segment is added.  The
+   caller fills in the control points. */
+static plPathControls *
+_add_curved_segment (plPath *path, plPathSegmentType type, plPoint p)
+{
+  _grow_plPath (path, 1);
+  if (path->controls == (plPathControls *)NULL)
+    path->controls = (plPathControls *)
+      _pl_xmalloc (path->segments_len * sizeof(plPathControls));
+
+  path->types[path->num_segments] = type;
+  path->points[path->num_segments] = p;
+  return &path->controls[path->num_segments++];
+}
+
 void
 _add_moveto (plPath *path, plPoint p)
 {
@@ -134,13 +256,11 @@ _add_moveto (plPath *path, plPoint p)
   if (path->type != PATH_SEGMENT_LIST || path->num_segments > 0)
     return;
   
-  /* empty, so allocate a segment buffer */
-  path->segments = (plPathSegment *) 
-    _pl_xmalloc (DATAPOINTS_BUFSIZ * sizeof(plPathSegment));
-  path->segments_len = DATAPOINTS_BUFSIZ;
+  /* empty, so allocate the segment buffers */
+  _grow_plPath (path, 1);
   
-  path->segments[0].type = S_MOVETO;
-  path->segments[0].p = p;
+  path->types[0] = S_MOVETO;
+  path->points[0] = p;
   path->num_segments = 1;
   
   path->llx = p.x;
@@ -158,25 +278,10 @@ _add_line (plPath *path, plPoint p)
   if (path->type != PATH_SEGMENT_LIST || path->num_segments == 0)
     return;
   
-  if (path->num_segments == 0)
-    /* empty, so allocate a segment buffer */
-    {
-      path->segments = (plPathSegment *) 
-	_pl_xmalloc (DATAPOINTS_BUFSIZ * sizeof(plPathSegment));
-      path->segments_len = DATAPOINTS_BUFSIZ;
-    }
-  
-  if (path->num_segments == path->segments_len)
-    /* full, so reallocate */
-    {
-      path->segments = (plPathSegment *) 
-	_pl_xrealloc (path->segments, 
-			2 * path->segments_len * sizeof(plPathSegment));
-      path->segments_len *= 2;
-    }
+  _grow_plPath (path, 1);
   
-  path->segments[path->num_segments].type = S_LINE;
-  path->segments[path->num_segments].p = p;
+  path->types[path->num_segments] = S_LINE;
+  path->points[path->num_segments] = p;
   path->num_segments++;
   
   path->llx = DMIN(path->llx, p.x);
@@ -185,34 +290,55 @@ _add_line (plPath *path, plPoint p)
   path->ury = DMAX(path->ury, p.y);
 }
 
+/* Add n line segments at once, to the points (x[i],y[i]); equivalent to n
+   calls to _add_line(), but the buffers are grown at most once and the
+   bounding box is updated in a single pass. */
 void
-_add_closepath (plPath *path)
+_add_lines (plPath *path, const double *x, const double *y, int n)
 {
-  if (path == (plPath *)NULL)
+  plPoint *point;
+  double llx, lly, urx, ury;
+  int i;
+
+  if (path == (plPath *)NULL || n <= 0)
     return;
   
   if (path->type != PATH_SEGMENT_LIST || path->num_segments == 0)
     return;
   
-  if (path->num_segments == 0)	/* meaningless */
-    return;
+  _grow_plPath (path, n);
   
-  if (path->num_segments == path->segments_len)
-    /* full, so reallocate */
+  point = path->points + path->num_segments;
+  for (i = 0; i < n; i++)
     {
-      path->segments = (plPathSegment *) 
-	_pl_xrealloc (path->segments, 
-			2 * path->segments_len * sizeof(plPathSegment));
-      path->segments_len *= 2;
+      point[i].x = x[i];
+      point[i].y = y[i];
     }
+  memset (path->types + path->num_segments, S_LINE, (size_t)n);
+  path->num_segments += n;
   
-  path->segments[path->num_segments].type = S_CLOSEPATH;
-  path->segments[path->num_segments].p = path->segments[0].p;
-  path->num_segments++;
+  llx = path->llx;
+  lly = path->lly;
+  urx = path->urx;
+  ury = path->ury;
+  for (i = 0; i < n; i++)
+    {
+      llx = DMIN(llx, x[i]);
+      urx = DMAX(urx, x[i]);
+    }
+  for (i = 0; i < n; i++)
+    {
+      lly = DMIN(lly, y[i]);
+      ury = DMAX(ury, y[i]);
+    }
+  path->llx = llx;
+  path->lly = lly;
+  path->urx = urx;
+  path->ury = ury;
 }
 
 void
-_add_bezier2 (plPath *path, plPoint pc, plPoint p)
+_add_closepath (plPath *path)
 {
   if (path == (plPath *)NULL)
     return;
@@ -220,124 +346,72 @@ _add_bezier2 (plPath *path, plPoint pc, plPoint p)
   if (path->type != PATH_SEGMENT_LIST || path->num_segments == 0)
     return;
   
-  if (path->num_segments == 0)
-    /* empty, so allocate a segment buffer */
-    {
-      path->segments = (plPathSegment *) 
-	_pl_xmalloc (DATAPOINTS_BUFSIZ * sizeof(plPathSegment));
-      path->segments_len = DATAPOINTS_BUFSIZ;
-    }
-  
-  if (path->num_segments == path->segments_len)
-    /* full, so reallocate */
-    {
-      path->segments = (plPathSegment *) 
-	_pl_xrealloc (path->segments, 
-			2 * path->segments_len * sizeof(plPathSegment));
-      path->segments_len *= 2;
-    }
+  _grow_plPath (path, 1);
   
-  path->segments[path->num_segments].type = S_QUAD;
-  path->segments[path->num_segments].p = p;
-  path->segments[path->num_segments].pc = pc;
+  path->types[path->num_segments] = S_CLOSEPATH;
+  path->points[path->num_segments] = path->points[0];
   path->num_segments++;
 }
 
 void
-_add_bezier3 (plPath *path, plPoint pc, plPoint pd, plPoint p)
+_add_bezier2 (plPath *path, plPoint pc, plPoint p)
 {
+  plPathControls *controls;
+
   if (path == (plPath *)NULL)
     return;
   
   if (path->type != PATH_SEGMENT_LIST || path->num_segments == 0)
     return;
   
-  if (path->num_segments == 0)
-    /* empty, so allocate a segment buffer */
-    {
-      path->segments = (plPathSegment *) 
-	_pl_xmalloc (DATAPOINTS_BUFSIZ * sizeof(plPathSegment));
-      path->segments_len = DATAPOINTS_BUFSIZ;
-    }
+  controls = _add_curved_segment (path, S_QUAD, p);
+  controls->pc = pc;
+}
+
+void
+_add_bezier3 (plPath *path, plPoint pc, plPoint pd, plPoint p)
+{
+  plPathControls *controls;
+
+  if (path == (plPath *)NULL)
+    return;
   
-  if (path->num_segments == path->segments_len)
-    /* full, so reallocate */
-    {
-      path->segments = (plPathSegment *) 
-	_pl_xrealloc (path->segments, 
-			2 * path->segments_len * sizeof(plPathSegment));
-      path->segments_len *= 2;
-    }
+  if (path->type != PATH_SEGMENT_LIST || path->num_segments == 0)
+    return;
   
-  path->segments[path->num_segments].type = S_CUBIC;
-  path->segments[path->num_segments].p = p;
-  path->segments[path->num_segments].pc = pc;
-  path->segments[path->num_segments].pd = pd;
-  path->num_segments++;
+  controls = _add_curved_segment (path, S_CUBIC, p);
+  controls->pc = pc;
+  controls->pd = pd;
 }
 
 void
 _add_arc (plPath *path, plPoint pc, plPoint p1)
 {
+  plPathControls *controls;
+
   if (path == (plPath *)NULL)
     return;
   
   if (path->type != PATH_SEGMENT_LIST || path->num_segments == 0)
     return;
   
-  if (path->num_segments == 0)
-    /* empty, so allocate a segment buffer */
-    {
-      path->segments = (plPathSegment *) 
-	_pl_xmalloc (DATAPOINTS_BUFSIZ * sizeof(plPathSegment));
-      path->segments_len = DATAPOINTS_BUFSIZ;
-    }
-  
-  if (path->num_segments == path->segments_len)
-    /* full, so reallocate */
-    {
-      path->segments = (plPathSegment *) 
-	_pl_xrealloc (path->segments, 
-			2 * path->segments_len * sizeof(plPathSegment));
-      path->segments_len *= 2;
-    }
-  
-  path->segments[path->num_segments].type = S_ARC;
-  path->segments[path->num_segments].p = p1;
-  path->segments[path->num_segments].pc = pc;
-  path->num_segments++;
+  controls = _add_curved_segment (path, S_ARC, p1);
+  controls->pc = pc;
 }
 
 void
 _add_ellarc (plPath *path, plPoint pc, plPoint p1)
 {
+  plPathControls *controls;
+
   if (path == (plPath *)NULL)
     return;
   
   if (path->type != PATH_SEGMENT_LIST || path->num_segments == 0)
     return;
   
-  if (path->num_segments == 0)
-    /* empty, so allocate a segment buffer */
-    {
-      path->segments = (plPathSegment *) 
-	_pl_xmalloc (DATAPOINTS_BUFSIZ * sizeof(plPathSegment));
-      path->segments_len = DATAPOINTS_BUFSIZ;
-    }
-  
-  if (path->num_segments == path->segments_len)
-    /* full, so reallocate */
-    {
-      path->segments = (plPathSegment *) 
-	_pl_xrealloc (path->segments, 
-			2 * path->segments_len * sizeof(plPathSegment));
-      path->segments_len *= 2;
-    }
-  
-  path->segments[path->num_segments].type = S_ELLARC;
-  path->segments[path->num_segments].p = p1;
-  path->segments[path->num_segments].pc = pc;
-  path->num_segments++;
+  controls = _add_curved_segment (path, S_ELLARC, p1);
+  controls->pc = pc;
 }
 
 void
@@ -425,7 +499,7 @@ _add_arc_as_lines (plPath *path, plPoint pc, plPoint p1)
     return;
       
   /* determine starting point */
-  p0 = path->segments[path->num_segments - 1].p;
+  p0 = path->points[path->num_segments - 1];
 
   if (p0.x == p1.x && p0.y == p1.y)
     /* zero-length arc, draw as zero-length line segment */
@@ -498,7 +572,7 @@ _add_ellarc_as_lines (plPath *path, plPoint pc, plPoint p1)
     return;
       
   /* determine starting point */
-  p0 = path->segments[path->num_segments - 1].p;
+  p0 = path->points[path->num_segments - 1];
 
   /* vectors from pc to p0, and pc to p1 */
   v0.x = p0.x - pc.x;
@@ -564,7 +638,7 @@ _add_arc_as_bezier3 (plPath *path, plPoint pc, plPoint p1)
     return;
       
   /* determine starting point */
-  p0 = path->segments[path->num_segments - 1].p;
+  p0 = path->points[path->num_segments - 1];
 
   /* vectors to starting, ending points */
   v0.x = p0.x - pc.x;
@@ -660,7 +734,7 @@ _add_ellarc_as_bezier3 (plPath *path, plPoint pc, plPoint p1)
     return;
       
   /* determine starting point */
-  p0 = path->segments[path->num_segments - 1].p;
+  p0 = path->points[path->num_segments - 1];
 
   /* vectors to starting, ending points */
   v0.x = p0.x - pc.x;
@@ -700,7 +774,7 @@ _add_bezier2_as_lines (plPath *path, plPoint pc, plPoint p)
     return;
   
   /* determine starting point */
-  p0 = path->segments[path->num_segments - 1].p;
+  p0 = path->points[path->num_segments - 1];
   
   /* squared distance between p0 and p */
   sqdist = (p.x - p0.x) * (p.x - p0.x) + (p.y - p0.y) * (p.y - p0.y);
@@ -798,7 +872,7 @@ _add_bezier3_as_lines (plPath *path, plPoint pc, plPoint pd, plPoint p)
     return;
   
   /* determine starting point */
-  p0 = path->segments[path->num_segments - 1].p;
+  p0 = path->points[path->num_segments - 1];
   
   /* squared distance between p0 and p */
   sqdist = (p.x - p0.x) * (p.x - p0.x) + (p.y - p0.y) * (p.y - p0.y);
@@ -1303,9 +1377,9 @@ _flatten_path (const plPath *path)
 
 	for (i = 0; i < path->num_segments; i++)
 	  {
-	    if (path->segments[i].type != S_MOVETO
-		&& path->segments[i].type != S_LINE
-		&& path->segments[i].type != S_CLOSEPATH)
+	    if (path->types[i] != S_MOVETO
+		&& path->types[i] != S_LINE
+		&& path->types[i] != S_CLOSEPATH)
 	      {
 		do_flatten = true;
 		break;
@@ -1319,13 +1393,13 @@ _flatten_path (const plPath *path)
 	    newpath = _new_plPath ();
 	    for (i = 0; i < path->num_segments; i++)
 	      {
-		switch ((int)(path->segments[i].type))
+		switch ((int)(path->types[i]))
 		  {
 		  case (int)S_MOVETO:
-		    _add_moveto (newpath, path->segments[i].p);
+		    _add_moveto (newpath, path->points[i]);
 		    break;
 		  case (int)S_LINE:
-		    _add_line (newpath, path->segments[i].p);
+		    _add_line (newpath, path->points[i]);
 		    break;
 		  case (int)S_CLOSEPATH:
 		    _add_closepath (newpath);
@@ -1335,24 +1409,24 @@ _flatten_path (const plPath *path)
 
 		  case (int)S_ARC:
 		    _add_arc_as_lines (newpath, 
-				       path->segments[i].pc, 
-				       path->segments[i].p);
+				       path->controls[i].pc, 
+				       path->points[i]);
 		    break;
 		  case (int)S_ELLARC:
 		    _add_ellarc_as_lines (newpath, 
-					  path->segments[i].pc, 
-					  path->segments[i].p);
+					  path->controls[i].pc, 
+					  path->points[i]);
 		    break;
 		  case (int)S_QUAD:
 		    _add_bezier2_as_lines (newpath, 
-					   path->segments[i].pc, 
-					   path->segments[i].p);
+					   path->controls[i].pc, 
+					   path->points[i]);
 		    break;
 		  case (int)S_CUBIC:
 		    _add_bezier3_as_lines (newpath, 
-					   path->segments[i].pc, 
-					   path->segments[i].pd, 
-					   path->segments[i].p);
+					   path->controls[i].pc, 
+					   path->controls[i].pd, 
+					   path->points[i]);
 		    break;
 		  default:	/* shouldn't happen */
 		    break;
@@ -1430,6 +1504,7 @@ typedef struct subpath_struct
   int num_segments;		/* number of segments */
 
   struct subpath_struct **parents; /* array of pointers to possible parents */
+  int parents_len;		/* length of parents array */
   struct subpath_struct *parent; /* pointer to parent path */
   struct subpath_struct **children; /* array of pointers to child paths */
   int num_children;		/* number of children */
@@ -1443,9 +1518,9 @@ typedef struct subpath_struct
 /* forward references */
 
 /* 0. ctors, dtors */
-static subpath * new_subpath (void);
+static void init_subpath (subpath *s);
 static subpath ** new_subpath_array (int n);
-static void delete_subpath (subpath *s);
+static void clear_subpath (subpath *s);
 static void delete_subpath_array (subpath **s, int n);
 
 /* 1. functions that act on a subpath, i.e. an `annotated path' */
@@ -1455,23 +1530,23 @@ static void linearize_subpath (subpath *s);
 static void read_into_subpath (subpath *s, const plPath *path);
 
 /* 2. miscellaneous */
+static int compare_subpath_llx (const void *a, const void *b);
+static int compare_subpath_order (const void *a, const void *b);
+static void add_possible_parent (subpath *s, subpath *other);
 static void find_parents_in_subpath_list (subpath **annotated_paths, int num_paths);
 static void insert_subpath (plPathSegment *parent_segments, const plPathSegment *child_segments, int parent_size, int child_size, int parent_index, int child_index);
 static void _compute_closest (const plPathSegment *p1, const plPathSegment *p2, int size1, int size2, double *distance, int *index1, int *index2);
 
 /**********************************************************************/
 
-/* ctor for subpath class */
-static subpath * 
-new_subpath (void)
+/* ctor for subpath class; constructs an empty subpath in place */
+static void
+init_subpath (subpath *s)
 {
-  subpath *s;
-  
-  s = (subpath *)_pl_xmalloc (sizeof (subpath));
-
   s->segments = (plPathSegment *)NULL;
   s->num_segments = 0;
   s->parents = (subpath **)NULL;
+  s->parents_len = 0;
   s->parent = (subpath *)NULL;
   s->children = (subpath **)NULL;
   s->num_children = 0;
@@ -1481,39 +1556,38 @@ new_subpath (void)
   s->urx = -DBL_MAX;
   s->ury = -DBL_MAX;
   s->inserted = false;
-
-  return s;
 }
   
-/* corresponding ctor for a subpath array */
+/* ctor for an array of pointers to n new subpaths, which are allocated as
+   a single block */
 static subpath **
 new_subpath_array (int n)
 {
   int i;
   subpath **s;
+  subpath *block;
   
   s = (subpath **)_pl_xmalloc (n * sizeof (subpath *));
+  block = (subpath *)_pl_xmalloc (n * sizeof (subpath));
   for (i = 0; i < n; i++)
-    s[i] = new_subpath ();
+    {
+      init_subpath (&block[i]);
+      s[i] = &block[i];
+    }
 
   return s;
 }
   
-/* dtor for subpath class */
+/* dtor for subpath class; frees what a subpath points to */
 static void
-delete_subpath (subpath *s)
+clear_subpath (subpath *s)
 {
-  if (s)
-    {
-      if (s->segments)
-	free (s->segments);
-      if (s->children)
-	free (s->children);
-      if (s->parents)
-	free (s->parents);
-
-      free (s);
-    }
+  if (s->segments)
+    free (s->segments);
+  if (s->children)
+    free (s->children);
+  if (s->parents)
+    free (s->parents);
 }
 
 /* corresponding dtor for a subpath array */
@@ -1525,7 +1599,9 @@ delete_subpath_array (subpath **s, int n)
   if (s)
     {
       for (i = 0; i < n; i++)
-	delete_subpath (s[i]);
+	clear_subpath (s[i]);
+      if (n > 0)
+	free (s[0]);		/* the block */
       free (s);
     }
 }
@@ -1580,10 +1656,10 @@ read_into_subpath (subpath *s, const plPath *path)
   /* Is this path closed?  If not, we'll close manually the annotated path
      that we'll construct.  WE CURRENTLY TREAT FINAL = INITIAL AS
      INDICATING CLOSURE. */
-  if (path->segments[path->num_segments - 1].type != S_CLOSEPATH
+  if (path->types[path->num_segments - 1] != S_CLOSEPATH
       &&
-      (path->segments[path->num_segments - 1].p.x != path->segments[0].p.x
-       || path->segments[path->num_segments - 1].p.y != path->segments[0].p.y))
+      (path->points[path->num_segments - 1].x != path->points[0].x
+       || path->points[path->num_segments - 1].y != path->points[0].y))
     need_to_close = true;
 
   /* copy the segments, updating bounding box to take each juncture point
@@ -1592,7 +1668,8 @@ read_into_subpath (subpath *s, const plPath *path)
     {
       plPathSegment e;
       
-      e = path->segments[i];
+      e.type = (plPathSegmentType)path->types[i];
+      e.p = path->points[i];
       s->segments[i] = e;
 
       if (e.p.x < s->llx)
@@ -1612,7 +1689,7 @@ read_into_subpath (subpath *s, const plPath *path)
 #else  /* currently, use line segment instead of closepath */
       s->segments[path->num_segments].type = S_LINE;
 #endif
-      s->segments[path->num_segments].p = path->segments[0].p;
+      s->segments[path->num_segments].p = path->points[0];
       s->num_segments++;
     }
 }
@@ -1766,53 +1843,123 @@ is_inside_of (const subpath *s, const subpath *other)
   return (inside > outside ? true : false);
 }
 
+/* qsort() comparison functions for subpaths.  The first orders subpaths
+   by the left edges of their bounding boxes.  The second restores the
+   order of the subpath list, i.e. of the block the subpaths were
+   allocated in (see new_subpath_array() above). */
+
+static int
+compare_subpath_llx (const void *a, const void *b)
+{
+  const subpath *s1 = *(const subpath * const *)a;
+  const subpath *s2 = *(const subpath * const *)b;
+
+  if (s1->llx < s2->llx)
+    return -1;
+  if (s1->llx > s2->llx)
+    return 1;
+  return compare_subpath_order (a, b);
+}
+
+static int
+compare_subpath_order (const void *a, const void *b)
+{
+  const subpath *s1 = *(const subpath * const *)a;
+  const subpath *s2 = *(const subpath * const *)b;
+
+  return (s1 < s2 ? -1 : (s1 > s2 ? 1 : 0));
+}
+
+/* record that a subpath is nominally inside another, i.e. that the other
+   is a possible parent; the parents array grows as needed */
+static void
+add_possible_parent (subpath *s, subpath *other)
+{
+  if (s->num_outside == s->parents_len)
+    {
+      s->parents_len = (s->parents_len == 0 ? 4 : 2 * s->parents_len);
+      s->parents = (subpath **)_pl_xrealloc (s->parents, 
+					     s->parents_len * sizeof (subpath *));
+    }
+  s->parents[s->num_outside] = other;
+  s->num_outside++;
+}
+
 /* Find parent (if any) of each subpath in a list of subpaths.  When this
    is invoked, each subpath should consist of an initial moveto, at least
-   one lineto, and a closepath (not currently enforced). */
+   one lineto, and a closepath (not currently enforced).
+
+   A subpath can be inside another only if its bounding box is, so rather
+   than testing every pair of subpaths, we sweep a vertical line from left
+   to right across the bounding boxes, keeping a list of the `active'
+   ones, i.e. the ones the line currently crosses.  When a subpath's box
+   is reached, any subpath that contains it, or is contained in it, is
+   active; so only those need be tested.  For the typical compound path
+   (disjoint islands, or a shape with holes) the active list stays short,
+   and the cost is close to linear in the number of subpaths. */
 
 static void 
 find_parents_in_subpath_list (subpath **annotated_paths, int num_paths)
 {
   int i, j;
+  int num_active;
+  subpath **sorted_paths, **active_paths;
   subpath *parent;
   
-  /* determine for each subpath the subpaths that are nominally outside it */
+  /* determine for each subpath the subpaths that are nominally outside
+     it, by sweeping across the subpaths in order of their left edges */
+  sorted_paths = (subpath **)_pl_xmalloc (num_paths * sizeof (subpath *));
+  active_paths = (subpath **)_pl_xmalloc (num_paths * sizeof (subpath *));
+  for (i = 0; i < num_paths; i++)
+    sorted_paths[i] = annotated_paths[i];
+  qsort (sorted_paths, (size_t)num_paths, sizeof (subpath *),
+	 compare_subpath_llx);
+
+  num_active = 0;
   for (i = 0; i < num_paths; i++)
     {
-      annotated_paths[i]->parents = new_subpath_array (num_paths);
-      for (j = 0; j < num_paths; j++)
+      subpath *s = sorted_paths[i];
+      int num_still_active = 0;
+
+      for (j = 0; j < num_active; j++)
 	{
-	  if (j != i)
-	    {
-	      if (is_inside_of (annotated_paths[i], annotated_paths[j]))
-		{
-		  annotated_paths[i]->parents[annotated_paths[i]->num_outside] = 
-		    annotated_paths[j];
-		  annotated_paths[i]->num_outside++;
-		}
-	    }
+	  subpath *other = active_paths[j];
+
+	  if (other->urx < s->llx)
+	    /* sweep line has passed this one, so drop it */
+	    continue;
+	  active_paths[num_still_active++] = other;
+
+	  if (is_inside_of (s, other))
+	    add_possible_parent (s, other);
+	  if (is_inside_of (other, s))
+	    add_possible_parent (other, s);
 	}
+      active_paths[num_still_active++] = s;
+      num_active = num_still_active;
     }
+  free (active_paths);
+  free (sorted_paths);
+
+  /* put each list of possible parents back in the order of the subpath
+     list, since the first suitable one found below becomes the parent */
+  for (i = 0; i < num_paths; i++)
+    if (annotated_paths[i]->num_outside > 1)
+      qsort (annotated_paths[i]->parents, 
+	     (size_t)annotated_paths[i]->num_outside, sizeof (subpath *),
+	     compare_subpath_order);
 
   /* Now find the real parent subpaths, i.e. the root subpaths.  A subpath
      is a parent subpath if the number of nominally-outside subpaths is
      even, and is a child subpath only if the number is odd.  An odd
      number, together with a failure to find a suitable potential parent,
      will flag a path as an isolate: technically a parent, but without
-     children. */
+     children.
 
-  for (i = 0; i < num_paths; i++)
-    {
-      if ((annotated_paths[i]->num_outside & 1) == 0)
-	/* an even number of subpaths outside, definitely a parent
-	   (i.e. doesn't have a parent itself, may or may not have children) */
-	{
-	  /* allocate space for children (if any) */
-	  annotated_paths[i]->children = new_subpath_array (num_paths);
-	}
-    }
-  
-  /* now determine which are children, and link them to their parents */
+     So for each subpath with an odd number outside, i.e. possibly a
+     child, search linearly through possible parents until we get a hit;
+     if so, this is a child, and we count it as one of the parent's
+     children; if not, this is an isolate (classed as a parent). */
 
   for (i = 0; i < num_paths; i++)
     {
@@ -1820,28 +1967,37 @@ find_parents_in_subpath_list (subpath **annotated_paths, int num_paths)
 	/* even number outside, definitely a parent subpath (whether it has
            children remains to be determined) */
 	continue;
-      else
-	/* odd number outside, possibly a child, so search linearly through
-	   possible parents until we get a hit; if so, this is a child; if
-	   not, this is an isolate (classed as a parent) */
+
+      for (j = 0; j < annotated_paths[i]->num_outside; j++)
 	{
-	  for (j = 0; j < annotated_paths[i]->num_outside; j++)
+	  if (annotated_paths[i]->num_outside == 
+	      annotated_paths[i]->parents[j]->num_outside + 1)
+	    /* number outside is one more than the number outside a
+	       potential parent; flag as a child */
 	    {
-	      if (annotated_paths[i]->num_outside == 
-		  annotated_paths[i]->parents[j]->num_outside + 1)
-		/* number outside is one more than the number outside a
-		   potential parent; flag as a child, and add it to the
-		   parent's child list */
-		{
-		  parent = annotated_paths[i]->parents[j];
-		  annotated_paths[i]->parent = parent; /* give it a parent */
-		  parent->children[parent->num_children] = annotated_paths[i];
-		  parent->num_children++;
-		  break;
-		}
+	      parent = annotated_paths[i]->parents[j];
+	      annotated_paths[i]->parent = parent; /* give it a parent */
+	      parent->num_children++;
+	      break;
 	    }
 	}
     }
+
+  /* allocate space for the children of each parent, and link them to it */
+  for (i = 0; i < num_paths; i++)
+    if (annotated_paths[i]->num_children > 0)
+      {
+	annotated_paths[i]->children = (subpath **)_pl_xmalloc 
+	  (annotated_paths[i]->num_children * sizeof (subpath *));
+	annotated_paths[i]->num_children = 0;
+      }
+  for (i = 0; i < num_paths; i++)
+    if (annotated_paths[i]->parent != (subpath *)NULL)
+      {
+	parent = annotated_paths[i]->parent;
+	parent->children[parent->num_children] = annotated_paths[i];
+	parent->num_children++;
+      }
 }
 
 /* Compute closest vertices in two paths.  Indices of closest vertices, and
@@ -2043,6 +2199,7 @@ _merge_paths (const plPath **paths, int num_paths)
   for (i = 0; i < num_paths; i++)
     if (flattened_paths[i] != paths[i])
       _delete_plPath (flattened_paths[i]);
+  free (flattened_paths);
 
   /* determine which subpaths are parents, children */
   find_parents_in_subpath_list (annotated_paths, num_paths);
@@ -2061,11 +2218,13 @@ _merge_paths (const plPath **paths, int num_paths)
 
   for (i = 0; i < num_paths; i++)
     {
-      int j, k, num_segments_in_merged_path;
+      int j, k, num_segments_in_merged_path, num_merged_segments;
       subpath *parent;
+      plPathSegment *merged_segments;
       plPath *merged_path;
-      double *parent_to_child_distances;
+      double *parent_to_child_distances, *new_parent_to_child_distances;
       int *child_best_indices, *parent_best_indices;
+      int *new_child_best_indices, *new_parent_best_indices;
 
       if (annotated_paths[i]->parent != (subpath *)NULL)
 	/* child path; original path will be merged into parent */
@@ -2091,16 +2250,13 @@ _merge_paths (const plPath **paths, int num_paths)
 	num_segments_in_merged_path 
 	  += (parent->children[j]->num_segments + 1);
 
-      merged_path = _new_plPath ();
-      merged_path->segments = (plPathSegment *)_pl_xmalloc(num_segments_in_merged_path * sizeof (plPathSegment));
-      merged_path->num_segments = 0;
-      merged_path->segments_len = num_segments_in_merged_path;
+      merged_segments = (plPathSegment *)_pl_xmalloc(num_segments_in_merged_path * sizeof (plPathSegment));
 
-      /* copy parent path into new empty path, i.e. initialize the merged
-         path */
+      /* copy parent path into new empty segment list, i.e. initialize the
+         merged path */
       for (j = 0; j < parent->num_segments; j++)
-	merged_path->segments[j] = parent->segments[j];
-      merged_path->num_segments = parent->num_segments;
+	merged_segments[j] = parent->segments[j];
+      num_merged_segments = parent->num_segments;
       
       /* Create temporary storage for `closest vertex pairs' and inter-path
 	 distances.  We first compute the shortest distance between each
@@ -2112,6 +2268,12 @@ _merge_paths (const plPath **paths, int num_paths)
       parent_best_indices = (int *)_pl_xmalloc(parent->num_children * sizeof (int));
       child_best_indices = (int *)_pl_xmalloc(parent->num_children * sizeof (int));
 
+      /* ... and for the arrays that will be used to update those three
+	 with each pass through the loop below */
+      new_parent_to_child_distances = (double *)_pl_xmalloc(parent->num_children * sizeof (double));
+      new_parent_best_indices = (int *)_pl_xmalloc(parent->num_children * sizeof (int));
+      new_child_best_indices = (int *)_pl_xmalloc(parent->num_children * sizeof (int));
+
       /* compute closest vertices between merged path (i.e., right now, the
 	 parent) and any child; these arrays will be updated when any child
 	 is inserted into the merged path */
@@ -2131,16 +2293,8 @@ _merge_paths (const plPath **paths, int num_paths)
 	{
 	  double min_distance;
 	  int closest = 0; /* keep compiler happy */
-	  double *new_parent_to_child_distances;
-	  int *new_child_best_indices, *new_parent_best_indices;
 
-	  /* allocate storage for arrays that will be used to update the
-	     three abovementioned arrays, with each pass through the loop */
-	  new_parent_to_child_distances = (double *)_pl_xmalloc(parent->num_children * sizeof (double));
-	  new_parent_best_indices = (int *)_pl_xmalloc(parent->num_children * sizeof (int));
-	  new_child_best_indices = (int *)_pl_xmalloc(parent->num_children * sizeof (int));
-
-	  /* initially, they're the same as the current arrays */
+	  /* initially, the new arrays are the same as the current ones */
 	  for (j = 0; j < parent->num_children; j++)
 	    {
 	      new_parent_to_child_distances[j] = parent_to_child_distances[j];
@@ -2237,7 +2391,7 @@ _merge_paths (const plPath **paths, int num_paths)
 		  new_parent_best_indices[j] = 
 		    CHILD_VERTEX_IN_MERGED_PATH(nearest_index_in_closest_child,
 						parent_best_indices[closest],
-						merged_path->num_segments, 
+						num_merged_segments, 
 						child_best_indices[closest],
 						parent->children[closest]->num_segments);
 		}
@@ -2257,7 +2411,7 @@ _merge_paths (const plPath **paths, int num_paths)
 		  new_parent_best_indices[j] = 
 		    PARENT_VERTEX_IN_MERGED_PATH(nearest_index_in_parent,
 						 parent_best_indices[closest],
-						 merged_path->num_segments, 
+						 num_merged_segments, 
 						 child_best_indices[closest],
 						 parent->children[closest]->num_segments);
 		}
@@ -2265,13 +2419,13 @@ _merge_paths (const plPath **paths, int num_paths)
 	  
 	  /* do the actual insertion, by adding a pair of lineto's between
              closest vertices; flag child as inserted */
-	  insert_subpath (merged_path->segments, 
+	  insert_subpath (merged_segments, 
 			  parent->children[closest]->segments, 
-			  merged_path->num_segments, 
+			  num_merged_segments, 
 			  parent->children[closest]->num_segments,
 			  parent_best_indices[closest],
 			  child_best_indices[closest]);
-	  merged_path->num_segments += 
+	  num_merged_segments += 
 	    (parent->children[closest]->num_segments + 1);
 	  parent->children[closest]->inserted = true;
 
@@ -2283,18 +2437,24 @@ _merge_paths (const plPath **paths, int num_paths)
 	      parent_best_indices[j] = new_parent_best_indices[j];
 	      child_best_indices[j] = new_child_best_indices[j];
 	    }
-
-	  free (new_parent_to_child_distances);
-	  free (new_parent_best_indices);
-	  free (new_child_best_indices);
 	}
       /* End of loop over all children of parent subpath; all >=1 children
 	 have now been inserted into the parent, i.e. into the `merged
 	 path' which the parent initialized.  However, the merged path's
-	 segments are all lines; so change the first to a moveto. */
+	 segments are all lines; so change the first to a moveto, as we
+	 copy them into a new plPath. */
 
-      merged_path->segments[0].type = S_MOVETO;
+      merged_path = _new_plPath ();
+      _grow_plPath (merged_path, num_merged_segments);
+      for (j = 0; j < num_merged_segments; j++)
+	{
+	  merged_path->types[j] = merged_segments[j].type;
+	  merged_path->points[j] = merged_segments[j].p;
+	}
+      merged_path->types[0] = S_MOVETO;
+      merged_path->num_segments = num_merged_segments;
       merged_paths[i] = merged_path;
+      free (merged_segments);
 
       /* NOTE: SHOULD ALSO REPLACE LAST LINE SEGMENT BY A CLOSEPATH! */
 
@@ -2303,6 +2463,9 @@ _merge_paths (const plPath **paths, int num_paths)
       free (parent_to_child_distances);
       free (parent_best_indices);
       free (child_best_indices);
+      free (new_parent_to_child_distances);
+      free (new_parent_best_indices);
+      free (new_child_best_indices);
     }
   /* end of loop over parent subpaths */
 
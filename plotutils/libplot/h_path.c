@@ -59,8 +59,8 @@ _pl_h_paint_path (S___(Plotter *_plotter))
 	  break;
 
 	if ((_plotter->drawstate->path->num_segments >= 3)/*check for closure*/
-	    && (_plotter->drawstate->path->segments[_plotter->drawstate->path->num_segments - 1].p.x == _plotter->drawstate->path->segments[0].p.x)
-	    && (_plotter->drawstate->path->segments[_plotter->drawstate->path->num_segments - 1].p.y == _plotter->drawstate->path->segments[0].p.y))
+	    && (_plotter->drawstate->path->points[_plotter->drawstate->path->num_segments - 1].x == _plotter->drawstate->path->points[0].x)
+	    && (_plotter->drawstate->path->points[_plotter->drawstate->path->num_segments - 1].y == _plotter->drawstate->path->points[0].y))
 	  closed = true;
 	else
 	  closed = false;	/* 2-point ones should be open */
@@ -71,24 +71,24 @@ _pl_h_paint_path (S___(Plotter *_plotter))
 	xarray = (plIntPathSegment *)_pl_xmalloc (_plotter->drawstate->path->num_segments * sizeof(plIntPathSegment));
 	
 	/* add first point of path to xarray[] (type field is a moveto) */
-	xarray[0].p.x = IROUND(XD(_plotter->drawstate->path->segments[0].p.x, 
-				  _plotter->drawstate->path->segments[0].p.y));
-	xarray[0].p.y = IROUND(YD(_plotter->drawstate->path->segments[0].p.x, 
-				  _plotter->drawstate->path->segments[0].p.y));
+	xarray[0].p.x = IROUND(XD(_plotter->drawstate->path->points[0].x, 
+				  _plotter->drawstate->path->points[0].y));
+	xarray[0].p.y = IROUND(YD(_plotter->drawstate->path->points[0].x, 
+				  _plotter->drawstate->path->points[0].y));
 	polyline_len = 1;
 	/* save user coors of last point added to xarray[] */
-	last_x = _plotter->drawstate->path->segments[0].p.x;
-	last_y = _plotter->drawstate->path->segments[0].p.y;  
+	last_x = _plotter->drawstate->path->points[0].x;
+	last_y = _plotter->drawstate->path->points[0].y;  
 	
 	for (i = 1; i < _plotter->drawstate->path->num_segments; i++)
 	  {
-	    plPathSegment datapoint;
+	    plPoint datapoint;
 	    double xuser, yuser, xdev, ydev;
 	    int device_x, device_y;
 	    
-	    datapoint = _plotter->drawstate->path->segments[i];
-	    xuser = datapoint.p.x;
-	    yuser = datapoint.p.y;
+	    datapoint = _plotter->drawstate->path->points[i];
+	    xuser = datapoint.x;
+	    yuser = datapoint.y;
 	    if (xuser != last_x || yuser != last_y)
 	      /* in user space, not all points are the same */
 	      identical_user_coordinates = false;	
@@ -104,11 +104,12 @@ _pl_h_paint_path (S___(Plotter *_plotter))
 		 field) */
 	      {
 		plPathSegmentType element_type;
+		const plPathControls *controls;
 		int device_xc, device_yc;
 		
 		xarray[polyline_len].p.x = device_x;
 		xarray[polyline_len].p.y = device_y;
-		element_type = datapoint.type;
+		element_type = (plPathSegmentType)_plotter->drawstate->path->types[i];
 		xarray[polyline_len].type = element_type;
 		
 		if (element_type == S_ARC)
@@ -116,14 +117,15 @@ _pl_h_paint_path (S___(Plotter *_plotter))
 		  {
 		    double angle;
 		    
-		    device_xc = IROUND(XD(datapoint.pc.x, datapoint.pc.y));
-		    device_yc = IROUND(YD(datapoint.pc.x, datapoint.pc.y));
+		    controls = &_plotter->drawstate->path->controls[i];
+		    device_xc = IROUND(XD(controls->pc.x, controls->pc.y));
+		    device_yc = IROUND(YD(controls->pc.x, controls->pc.y));
 		    xarray[polyline_len].pc.x = device_xc;
 		    xarray[polyline_len].pc.y = device_yc;
 		    p0.x = last_x; 
 		    p0.y = last_y;
-		    pp1 = datapoint.p;
-		    pc = datapoint.pc;
+		    pp1 = datapoint;
+		    pc = controls->pc;
 		    angle = _angle_of_arc (p0, pp1, pc);
 
 		    /* if user coors -> device coors includes a reflection,
@@ -135,19 +137,20 @@ _pl_h_paint_path (S___(Plotter *_plotter))
 		else if (element_type == S_CUBIC)
 		  /* a cubic Bezier element, so compute control points too */
 		  {
+		    controls = &_plotter->drawstate->path->controls[i];
 		    xarray[polyline_len].pc.x 
-		      = IROUND(XD(datapoint.pc.x, datapoint.pc.y));
+		      = IROUND(XD(controls->pc.x, controls->pc.y));
 		    xarray[polyline_len].pc.y 
-		      = IROUND(YD(datapoint.pc.x, datapoint.pc.y));
+		      = IROUND(YD(controls->pc.x, controls->pc.y));
 		    xarray[polyline_len].pd.x
-		      = IROUND(XD(datapoint.pd.x, datapoint.pd.y));
+		      = IROUND(XD(controls->pd.x, controls->pd.y));
 		    xarray[polyline_len].pd.y
-		      = IROUND(YD(datapoint.pd.x, datapoint.pd.y));
+		      = IROUND(YD(controls->pd.x, controls->pd.y));
 		  }
 		
 		/* save user coors of last point added to xarray[] */
-		last_x = datapoint.p.x;
-		last_y = datapoint.p.y;  
+		last_x = datapoint.x;
+		last_y = datapoint.y;  
 		polyline_len++;
 	      }
 	  }
@@ -174,7 +177,7 @@ _pl_h_paint_path (S___(Plotter *_plotter))
 		/* move to center of circle */
 		savedpoint = _plotter->drawstate->pos;
 		_plotter->drawstate->pos = 
-		  _plotter->drawstate->path->segments[0].p;
+		  _plotter->drawstate->path->points[0];
 		_pl_h_set_position (S___(_plotter));
 		_plotter->drawstate->pos = savedpoint;
 		
@@ -249,7 +252,7 @@ _pl_h_paint_path (S___(Plotter *_plotter))
 	_pl_h_set_attributes (S___(_plotter));
 	
 	savedpoint = _plotter->drawstate->pos;
-	_plotter->drawstate->pos = _plotter->drawstate->path->segments[0].p;
+	_plotter->drawstate->pos = _plotter->drawstate->path->points[0];
 	_pl_h_set_position (S___(_plotter));
 	_plotter->drawstate->pos = savedpoint;
 	
@@ -285,15 +288,16 @@ _pl_h_paint_path (S___(Plotter *_plotter))
 		    /* emit one or more pen advances */
 		    strcpy (_plotter->data->page->point, "PA");
 		    _update_buffer (_plotter->data->page);
-		    sprintf (_plotter->data->page->point, "%d,%d", 
-			     xarray[i].p.x, xarray[i].p.y);
-		    _update_buffer (_plotter->data->page);
+		    _append_integer (_plotter->data->page, xarray[i].p.x);
+		    _append_to_outbuf (_plotter->data->page, ",", 1);
+		    _append_integer (_plotter->data->page, xarray[i].p.y);
 		    i++;
 		    while (i < polyline_len && xarray[i].type == S_LINE)
 		      {
-			sprintf (_plotter->data->page->point, 
-				 ",%d,%d", xarray[i].p.x, xarray[i].p.y);
-			_update_buffer (_plotter->data->page);
+			_append_to_outbuf (_plotter->data->page, ",", 1);
+			_append_integer (_plotter->data->page, xarray[i].p.x);
+			_append_to_outbuf (_plotter->data->page, ",", 1);
+			_append_integer (_plotter->data->page, xarray[i].p.y);
 			i++;
 		      }
 		    sprintf (_plotter->data->page->point, ";");
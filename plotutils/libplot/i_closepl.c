@@ -29,6 +29,7 @@
 
 /* forward references */
 static bool same_colormap (plColor cmap1[256], plColor cmap2[256], int num1, int num2);
+static bool colormap_remap (plColor cmap1[256], plColor cmap2[256], int num1, int num2, unsigned char remap[256]);
 
 bool
 _pl_i_end_page (S___(Plotter *_plotter))
@@ -153,6 +154,7 @@ _pl_i_write_gif_header (S___(Plotter *_plotter))
       _plotter->i_global_colormap[i] = _plotter->i_colormap[i];
     }
   _plotter->i_num_global_color_indices = _plotter->i_num_color_indices;
+  _plotter->i_global_bit_depth = _plotter->i_bit_depth;
 
   /* Netscape Loop Extension Block (extension blocks are a GIF89a feature;
      this requests `looping' of subsequent images) */
@@ -186,8 +188,9 @@ _pl_i_write_gif_header (S___(Plotter *_plotter))
 void
 _pl_i_write_gif_image (S___(Plotter *_plotter))
 {
-  bool write_local_table;
-  int i, min_code_size, packed_bits;
+  bool write_local_table, remap_indices = false;
+  unsigned char remap[256];
+  int i, bit_depth, min_code_size, packed_bits;
 
   /* Graphic Control Block (a GIF89a feature; modifies following image
      descriptor).  Needed to express transparency of each image, or a
@@ -243,11 +246,26 @@ _pl_i_write_gif_image (S___(Plotter *_plotter))
   _pl_i_write_short_int (R___(_plotter) (unsigned int)_plotter->i_yn);
 
   /* does current frame's color table differ from zeroth frame's color
-     table (i.e. GIF file's global color table)? */
+     table (i.e. GIF file's global color table)?  If it does, but every
+     color in it also appears in the global table, reuse the global table
+     by remapping the frame's color indices. */
   write_local_table 
     = same_colormap (_plotter->i_colormap, _plotter->i_global_colormap,
 		      _plotter->i_num_color_indices,
 		      _plotter->i_num_global_color_indices) ? false : true;
+  if (write_local_table
+      && colormap_remap (_plotter->i_colormap, _plotter->i_global_colormap,
+			 _plotter->i_num_color_indices,
+			 _plotter->i_num_global_color_indices, remap)
+      /* transparent color index is the same for all frames */
+      && (_plotter->i_transparent == false
+	  || remap[_plotter->i_transparent_index] == _plotter->i_transparent_index))
+    {
+      write_local_table = false;
+      remap_indices = true;
+    }
+  bit_depth = (remap_indices 
+	       ? _plotter->i_global_bit_depth : _plotter->i_bit_depth);
 
   /* Packed fields: Local Color Table (1 bit), Interlace Flag (1 bit), Sort
      Flag (1 bit), Reserved (2 bits), Local Color Table Size (3 bits) */
@@ -283,28 +301,48 @@ _pl_i_write_gif_image (S___(Plotter *_plotter))
      this has a floor of 2, and, also compression codes must start out one
      bit longer than the floored version, "because of some algorithmic
      constraints".  See i_rle.c.) */
-  min_code_size = IMAX(_plotter->i_bit_depth, 2);
+  min_code_size = IMAX(bit_depth, 2);
   _write_byte (_plotter->data, (unsigned char)min_code_size);
 
-  /* initialize pixel scanner */
-  _pl_i_start_scan (S___(_plotter));
-
   /* Image Data, consisting of a sequence of sub-blocks of size at most 
-     255 bytes each, encoded as LZW with variable-length code
-     (actually, we use miGIF [RLE] rather than LZW; see i_rle.c) */
+     255 bytes each, encoded as LZW with variable-length code (or, if the
+     GIF_COMPRESSION parameter is "rle", as miGIF [RLE]; see i_rle.c) */
   {
     rle_out *rle;
-    int pixel;
+    unsigned char *indices;	/* color indices of the current row */
+    int pass, x, y;
       
 #ifdef LIBPLOTTER
     rle = _rle_init (_plotter->data->outfp, _plotter->data->outstream,
-		     _plotter->i_bit_depth);
+		     bit_depth, _plotter->i_lzw);
 #else
     rle = _rle_init (_plotter->data->outfp,
-		     _plotter->i_bit_depth);
+		     bit_depth, _plotter->i_lzw);
 #endif
-    while ((pixel = _pl_i_scan_pixel (S___(_plotter))) != -1)
-      _rle_do_pixel (rle, pixel);
+
+    /* scan the canvas a row at a time, from the top; if interlacing, in
+       four passes over every 8th row from row 0, every 8th row from row
+       4, every 4th row from row 2, and every 2nd row from row 1 */
+    indices = (unsigned char *)_pl_xmalloc (_plotter->i_xn * sizeof (unsigned char));
+    for (pass = 0; pass < (_plotter->i_interlace ? 4 : 1); pass++)
+      {
+	static const int first_row[4] = { 0, 4, 2, 1 };
+	static const int row_step[4] = { 8, 8, 4, 2 };
+	int first = (_plotter->i_interlace ? first_row[pass] : 0);
+	int step = (_plotter->i_interlace ? row_step[pass] : 1);
+
+	for (y = first; y < _plotter->i_yn; y += step)
+	  {
+	    _pl_canvas_row (_plotter->i_canvas, y, 1, indices);
+	    if (remap_indices)
+	      for (x = 0; x < _plotter->i_xn; x++)
+		_rle_do_pixel (rle, (int)remap[indices[x]]);
+	    else
+	      for (x = 0; x < _plotter->i_xn; x++)
+		_rle_do_pixel (rle, (int)indices[x]);
+	  }
+      }
+    free (indices);
     _rle_terminate (rle);
   }
 
@@ -319,90 +357,6 @@ _pl_i_write_gif_trailer (S___(Plotter *_plotter))
   _write_byte (_plotter->data, (unsigned char)';');
 }
 
-/* reset scanner variables (first pixel scanned is (0,0), i.e. upper
-   left-hand corner) */
-void
-_pl_i_start_scan (S___(Plotter *_plotter))
-{
-  _plotter->i_pixels_scanned = 0;
-  _plotter->i_pass = 0;
-  _plotter->i_hot.x = 0;
-  _plotter->i_hot.y = 0;  
-}
-
-/* Return index (in color table) of pixel under the hot spot, and continue
-   the scan by moving to the next pixel.  Return -1 when scan is finished. */
-int
-_pl_i_scan_pixel (S___(Plotter *_plotter))
-{
-  if (_plotter->i_pixels_scanned < _plotter->i_num_pixels)
-    {
-      miCanvas *canvas;
-      int x, y;
-      miPixel full_pixel;
-      int pixel;
-
-      /* use a libxmi macro, defined in xmi.h, to extract the miPixel at
-	 the hotspot; extract index field from it */
-      canvas = (miCanvas *)_plotter->i_canvas;
-      x = _plotter->i_hot.x;
-      y = _plotter->i_hot.y;      
-      MI_GET_CANVAS_DRAWABLE_PIXEL(canvas, x, y, full_pixel)
-      pixel = full_pixel.u.index;
-
-      _plotter->i_hot.x++;
-      if (_plotter->i_hot.x == _plotter->i_xn)
-	{
-	  _plotter->i_hot.x = 0;
-
-	  if (_plotter->i_interlace == false)
-	    _plotter->i_hot.y++;
-	  else			/* move to next scan line */
-	    {
-	      switch (_plotter->i_pass)
-		{
-		case 0:
-		  /* every 8th row, starting with row 0 */
-		  _plotter->i_hot.y += 8;
-		  if (_plotter->i_hot.y >= _plotter->i_yn)
-		    {
-		      _plotter->i_pass++;
-		      _plotter->i_hot.y = 4;
-		    }
-		  break;
-		case 1:
-		  /* every 8th row, starting with row 4 */
-		  _plotter->i_hot.y += 8;
-		  if (_plotter->i_hot.y >= _plotter->i_yn)
-		    {
-		      _plotter->i_pass++;
-		      _plotter->i_hot.y = 2;
-		    }
-		  break;
-		case 2:
-		  /* every 4th row, starting with row 2 */
-		  _plotter->i_hot.y += 4;
-		  if (_plotter->i_hot.y >= _plotter->i_yn)
-		    {
-		      _plotter->i_pass++;
-		      _plotter->i_hot.y = 1;
-		    }
-		  break;
-		case 3:
-		  /* every 2nd row, starting with row 1 */
-		  _plotter->i_hot.y += 2;
-		  break;
-		}
-	    }
-	}
-
-      _plotter->i_pixels_scanned++;
-      return pixel;
-    }
-  else				/* scan is finished */
-    return -1;
-}
-
 /* write out an unsigned short int, in range 0..65535, as 2 bytes in
    little-endian order */
 void
@@ -450,3 +404,24 @@ same_colormap (plColor cmap1[256], plColor cmap2[256], int num1, int num2)
       return false;
   return true;
 }
+
+/* map each color in a partially filled size-256 colormap to the first
+   matching color in another; return false if some color has no match */
+static bool
+colormap_remap (plColor cmap1[256], plColor cmap2[256], int num1, int num2, unsigned char remap[256])
+{
+  int i, j;
+  
+  for (i = 0; i < num1; i++)
+    {
+      for (j = 0; j < num2; j++)
+	if ((cmap1[i].red == cmap2[j].red)
+	    && (cmap1[i].green == cmap2[j].green)
+	    && (cmap1[i].blue == cmap2[j].blue))
+	  break;
+      if (j == num2)
+	return false;
+      remap[i] = (unsigned char)j;
+    }
+  return true;
+}
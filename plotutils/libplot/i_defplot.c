@@ -42,7 +42,9 @@ const Plotter _pl_i_default_plotter =
   /* internal path-painting methods (endpath() is a wrapper for the first) */
   _pl_i_paint_path, _pl_i_paint_paths, _pl_g_path_is_flushable, _pl_g_maybe_prepaint_segments,
   /* internal methods for drawing of markers and points */
-  _pl_g_paint_marker, _pl_i_paint_point,
+  _pl_g_paint_marker, _pl_g_paint_markers, _pl_i_paint_point,
+  /* internal methods for drawing and reading of raster images */
+  _pl_g_paint_image, _pl_g_read_image,
   /* internal methods that plot strings in Hershey, non-Hershey fonts */
   _pl_g_paint_text_string_with_escapes, _pl_g_paint_text_string,
   _pl_g_get_text_width,
@@ -139,6 +141,7 @@ _pl_i_initialize (S___(Plotter *_plotter))
   _plotter->i_iterations = 0;
   _plotter->i_delay = 0;
   _plotter->i_interlace = false;
+  _plotter->i_lzw = true;
   _plotter->i_transparent = false;  
   _plotter->i_transparent_color.red = 255; /* dummy */
   _plotter->i_transparent_color.green = 255; /* dummy */
@@ -154,12 +157,8 @@ _pl_i_initialize (S___(Plotter *_plotter))
   _plotter->i_num_color_indices = 0;
   _plotter->i_bit_depth = 0;
   _plotter->i_frame_nonempty = false;
-  _plotter->i_pixels_scanned = 0;
-  _plotter->i_pass = 0;
-  _plotter->i_hot.x = 0;
-  _plotter->i_hot.y = 0;  
-  /* N.B. _plotter->i_global_colormap, i_num_global_color_indices are
-     copied into later */
+  /* N.B. _plotter->i_global_colormap, i_num_global_color_indices,
+     i_global_bit_depth are copied into later */
   _plotter->i_header_written = false;
 
   /* initialize certain data members from device driver parameters */
@@ -188,6 +187,15 @@ _pl_i_initialize (S___(Plotter *_plotter))
       _plotter->i_interlace = true;
   }
   
+  /* use miGIF run-length encoding rather than LZW? */
+  {
+    const char *compression_s;
+
+    compression_s = (const char *)_get_plot_param (_plotter->data, "GIF_COMPRESSION" );
+    if (strcasecmp (compression_s, "rle") == 0)
+      _plotter->i_lzw = false;
+  }
+  
   /* turn off animation? */
   {
     const char *animate_s;
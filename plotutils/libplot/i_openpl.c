@@ -33,10 +33,6 @@ _pl_i_begin_page (S___(Plotter *_plotter))
   _plotter->i_num_color_indices = 0;
   _plotter->i_bit_depth = 0;
   _plotter->i_frame_nonempty = false;
-  _plotter->i_pixels_scanned = 0;
-  _plotter->i_pass = 0;
-  _plotter->i_hot.x = 0;
-  _plotter->i_hot.y = 0;  
   _plotter->i_header_written = false;
 
   /* Create new image, consisting of bitmap and colormap; initialized to
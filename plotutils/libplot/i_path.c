@@ -62,12 +62,12 @@ _pl_i_paint_path (S___(Plotter *_plotter))
 	  break;
 
 	if (_plotter->drawstate->path->num_segments == 2
-	    && _plotter->drawstate->path->segments[1].type == S_ARC)
+	    && _plotter->drawstate->path->types[1] == S_ARC)
 	  /* segment buffer contains a single circular arc, not a polyline */
 	  {
-	    p0 = _plotter->drawstate->path->segments[0].p;
-	    p1 = _plotter->drawstate->path->segments[1].p;
-	    pc = _plotter->drawstate->path->segments[1].pc;
+	    p0 = _plotter->drawstate->path->points[0];
+	    p1 = _plotter->drawstate->path->points[1];
+	    pc = _plotter->drawstate->path->controls[1].pc;
 	    
 	    /* use libxmi rendering */
 	    _pl_i_draw_elliptic_arc (R___(_plotter) p0, p1, pc);
@@ -76,12 +76,12 @@ _pl_i_paint_path (S___(Plotter *_plotter))
 	  }
 
 	if (_plotter->drawstate->path->num_segments == 2
-	    && _plotter->drawstate->path->segments[1].type == S_ELLARC)
+	    && _plotter->drawstate->path->types[1] == S_ELLARC)
 	  /* segment buffer contains a single elliptic arc, not a polyline */
 	  {
-	    p0 = _plotter->drawstate->path->segments[0].p;
-	    p1 = _plotter->drawstate->path->segments[1].p;
-	    pc = _plotter->drawstate->path->segments[1].pc;
+	    p0 = _plotter->drawstate->path->points[0];
+	    p1 = _plotter->drawstate->path->points[1];
+	    pc = _plotter->drawstate->path->controls[1].pc;
 	    
 	    /* use libxmi rendering */
 	    _pl_i_draw_elliptic_arc_2 (R___(_plotter) p0, p1, pc);
@@ -105,8 +105,8 @@ _pl_i_paint_path (S___(Plotter *_plotter))
 	    double xu, yu;
 	    int device_x, device_y;
 	    
-	    xu = _plotter->drawstate->path->segments[i].p.x;
-	    yu = _plotter->drawstate->path->segments[i].p.y;
+	    xu = _plotter->drawstate->path->points[i].x;
+	    yu = _plotter->drawstate->path->points[i].y;
 	    if (i > 0 && (xu != xu_last || yu != yu_last))
 	      /* in user space, not all points are the same */
 	      identical_user_coordinates = false;	
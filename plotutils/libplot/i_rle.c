@@ -16,16 +16,17 @@
    the Free Software Foundation, Inc., 51 Franklin St., Fifth Floor,
    Boston, MA 02110-1301, USA. */
 
-/* This file (i_rle.c) is a module that does run-length encoding on
-   a sequence of integers ("pixel values"), and writes the resulting
+/* This file (i_rle.c) is a module that compresses a sequence of integers
+   ("pixel values") into a GIF-compatible code stream, and writes the
    encoded sequence to an output stream.  The accompanying header file
-   (i_rle.h) defines the external interface.  The encoded sequence
-   should be GIF-compatible, even though the compression technique
-   is not LZW.
-
-   This module encapsulates the miGIF compression routines, originally
-   written by der Mouse and ivo.  Their copyright notice is reproduced
-   below. */
+   (i_rle.h) defines the external interface.  Two compression techniques
+   are supported: true LZW, with a hashed string table and variable code
+   width, and run-length encoding that emits only codes any GIF decoder
+   accepts (a workaround for the now-expired Unisys patent on LZW).
+
+   The run-length encoder encapsulates the miGIF compression routines,
+   originally written by der Mouse and ivo.  Their copyright notice is
+   reproduced below. */
    
 
 /*-----------------------------------------------------------------------
@@ -346,16 +347,89 @@ _rl_flush (rle_out *rle)
   rle->rl_count = 0;
 }
 
+/***********************************************************************/
+/*			LZW COMPRESSION				       */
+/***********************************************************************/
+
+/* The LZW encoder extends the string matched so far (lzw_prefix) by one
+   pixel at a time, and emits the prefix's code when the extended string
+   is not in the table.  The table is stored in an open-addressed hash
+   table keyed on (prefix, pixel).  Code width grows from out_bits_init
+   to GIFBITS as codes are added; when all 2**GIFBITS codes are in use,
+   a clear code is emitted and the table is restarted. */
+
+static void 
+_lzw_clear_table (rle_out *rle)
+{
+  memset (rle->lzw_hash_key, 0, sizeof(rle->lzw_hash_key));
+  rle->lzw_next_code = rle->code_eof + 1;
+}
+
+/* emit a code, then widen subsequent codes if the decoder's table will
+   have outgrown the current width */
+static void 
+_lzw_output (rle_out *rle, int code)
+{
+  _output (rle, code);
+  if (rle->lzw_next_code > (1 << rle->out_bits) - 1 
+      && rle->out_bits < GIFBITS)
+    rle->out_bits++;
+}
+
+static void 
+_lzw_do_pixel (rle_out *rle, int c)
+{
+  long key;
+  int i, disp;
+
+  if (rle->lzw_prefix < 0)
+    {
+      rle->lzw_prefix = c;
+      return;
+    }
+
+  /* look up (prefix, c), with double hashing */
+  key = (((long)rle->lzw_prefix << 8) | c) + 1;
+  i = ((c << 4) ^ rle->lzw_prefix) % LZW_HSIZE;
+  disp = (i == 0 ? 1 : LZW_HSIZE - i);
+  while (rle->lzw_hash_key[i] != 0)
+    {
+      if (rle->lzw_hash_key[i] == key)
+	{
+	  rle->lzw_prefix = rle->lzw_hash_code[i];
+	  return;
+	}
+      if ((i -= disp) < 0)
+	i += LZW_HSIZE;
+    }
+
+  /* not in table: emit prefix, add the extended string, restart at c */
+  _lzw_output (rle, rle->lzw_prefix);
+  if (rle->lzw_next_code < (1 << GIFBITS))
+    {
+      rle->lzw_hash_key[i] = key;
+      rle->lzw_hash_code[i] = (short)(rle->lzw_next_code++);
+    }
+  else
+    {
+      _output (rle, rle->code_clear);
+      _lzw_clear_table (rle);
+      rle->out_bits = rle->out_bits_init;
+    }
+  rle->lzw_prefix = c;
+}
+
 /***********************************************************************/
 /* 			EXTERNAL INTERFACE			       */
 /***********************************************************************/
 
-/* create new RLE struct, which writes to a specified stream */
+/* create new RLE struct, which writes to a specified stream, compressing
+   with LZW if lzw is true and with run-length encoding otherwise */
 rle_out *
 #ifdef LIBPLOTTER
-_rle_init (FILE *fp, ostream *out, int bit_depth)
+_rle_init (FILE *fp, ostream *out, int bit_depth, bool lzw)
 #else
-_rle_init (FILE *fp, int bit_depth)
+_rle_init (FILE *fp, int bit_depth, bool lzw)
 #endif
 {
   int init_bits;
@@ -390,6 +464,11 @@ _rle_init (FILE *fp, int bit_depth)
   _output (rle, rle->code_clear);
   rle->rl_count = 0;
 
+  rle->lzw = lzw;
+  rle->lzw_prefix = -1;
+  if (lzw)
+    _lzw_clear_table (rle);
+
   return rle;
 }
 
@@ -397,6 +476,12 @@ _rle_init (FILE *fp, int bit_depth)
 void
 _rle_do_pixel (rle_out *rle, int c)
 {
+  if (rle->lzw)
+    {
+      _lzw_do_pixel (rle, c);
+      return;
+    }
+
   /* if a run needs to be terminated by being written out, do so */
   if ((rle->rl_count > 0) && (c != rle->rl_pixel))
     _rl_flush (rle);
@@ -415,8 +500,13 @@ _rle_do_pixel (rle_out *rle, int c)
 void
 _rle_terminate (rle_out *rle)
 {
-  /* if a run in progress, end it */
-  if (rle->rl_count > 0)
+  /* if a string or a run is in progress, end it */
+  if (rle->lzw)
+    {
+      if (rle->lzw_prefix >= 0)
+	_lzw_output (rle, rle->lzw_prefix);
+    }
+  else if (rle->rl_count > 0)
     _rl_flush (rle);
   _output (rle, rle->code_eof);
   _output_flush (rle);
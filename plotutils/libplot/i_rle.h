@@ -17,19 +17,23 @@
    Boston, MA 02110-1301, USA. */
 
 /* This header file (i_rle.h) defines the external interface to the module
-   i_rle.c, which does run-length encoding on a sequence of integers
-   ("pixel values"), and writes the resulting encoded sequence to an output
-   stream.  The encoded sequence should be GIF-compatible, even though the
-   compression technique is not LZW.
+   i_rle.c, which compresses a sequence of integers ("pixel values") into
+   a GIF-compatible code stream, and writes the encoded sequence to an
+   output stream.  The compression is either true table-based LZW, or
+   run-length encoding that any GIF decoder accepts.
 
-   The module encapsulates the miGIF compression routines, originally
-   written by der Mouse and ivo.  Their copyright notice appears in
-   i_rle.c. */
+   The run-length encoder encapsulates the miGIF compression routines,
+   originally written by der Mouse and ivo.  Their copyright notice appears
+   in i_rle.c. */
 
 /* an `int' should be able to hold 2**GIFBITS distinct values, together
    with -1 */
 #define GIFBITS 12
 
+/* size of the LZW string table's hash table (a prime, about 20% larger
+   than 2**GIFBITS) */
+#define LZW_HSIZE 5003
+
 /* the RLE output structure */
 typedef struct
 {
@@ -57,13 +61,19 @@ typedef struct
 #endif
   unsigned char oblock[256];
   int oblen;
+  /* LZW state (used if lzw is true) */
+  bool lzw;
+  int lzw_prefix;		/* code of the string matched so far, or -1 */
+  int lzw_next_code;		/* next code to be added to the table */
+  long lzw_hash_key[LZW_HSIZE];	/* (prefix << 8 | pixel) + 1, or 0 if free */
+  short lzw_hash_code[LZW_HSIZE]; /* code of that string */
 } rle_out;
 
 /* create, initialize, and return a new RLE output structure */
 #ifdef LIBPLOTTER
-extern rle_out *_rle_init (FILE *fp, ostream *out, int bit_depth);
+extern rle_out *_rle_init (FILE *fp, ostream *out, int bit_depth, bool lzw);
 #else
-extern rle_out *_rle_init (FILE *fp, int bit_depth);
+extern rle_out *_rle_init (FILE *fp, int bit_depth, bool lzw);
 #endif
 /* write a single integer (pixel) to the structure */
 extern void _rle_do_pixel (rle_out *rle, int c);
@@ -165,7 +165,8 @@ _pl_m_paint_path_internal (R___(Plotter *_plotter) const plPath *path)
 	if (path->num_segments == 1) /* shouldn't happen */
 	  break;
 
-	segment = path->segments[0]; /* initial moveto */
+	segment.type = S_MOVETO;	/* initial moveto */
+	segment.p = path->points[0];
 	if (_plotter->meta_pos.x != segment.p.x
 	    || _plotter->meta_pos.y != segment.p.y)
 	  {
@@ -181,7 +182,13 @@ _pl_m_paint_path_internal (R___(Plotter *_plotter) const plPath *path)
 	    plPathSegment prev_segment;
 
 	    prev_segment = segment;
-	    segment = path->segments[i];
+	    segment.type = (plPathSegmentType)path->types[i];
+	    segment.p = path->points[i];
+	    if (path->controls)
+	      {
+		segment.pc = path->controls[i].pc;
+		segment.pd = path->controls[i].pd;
+	      }
 	    switch ((int)segment.type)
 	      {
 	      case (int)S_LINE:
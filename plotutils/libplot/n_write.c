@@ -30,9 +30,6 @@
 #define MAX_PGM_PIXELS_PER_LINE 16
 #define MAX_PPM_PIXELS_PER_LINE 5
 
-/* forward references */
-static int best_image_type (miPixel **pixmap, int width, int height);
-
 /* do a rapid decimal printf of a nonnegative integer, in range 0..999
    to a character buffer */
 #define FAST_PRINT(integer_to_print, linebuf, pos) \
@@ -75,13 +72,9 @@ void
 _pl_n_write_pnm (S___(Plotter *_plotter))
 {
   int type;			/* 0,1,2 = PBM/PGM/PPM */
-  int width, height;
-  miPixel **pixmap;
 
-  width = _plotter->b_xn;
-  height = _plotter->b_yn;
-  pixmap = ((miCanvas *)(_plotter->b_canvas))->drawable->pixmap;
-  type = best_image_type (pixmap, width, height);
+  /* best type, as recorded while painting (see b_openpl.c) */
+  type = _plotter->b_image_type;
 
   switch (type)
     {
@@ -104,7 +97,8 @@ _pl_n_write_pbm (S___(Plotter *_plotter))
 {
   int i, j;
   bool portable = _plotter->n_portable_output;
-  miPixel **pixmap = ((miCanvas *)(_plotter->b_canvas))->drawable->pixmap;
+  void *canvas = _plotter->b_canvas;
+  unsigned char *pixels;		/* colors of the current row */
   int width = _plotter->b_xn;
   int height = _plotter->b_yn;  
   FILE *fp = _plotter->data->outfp;
@@ -120,6 +114,8 @@ _pl_n_write_pbm (S___(Plotter *_plotter))
     return;
 #endif
 
+  pixels = (unsigned char *)_pl_xmalloc (width * sizeof (unsigned char));
+
   if (fp)
     {
       if (portable)			/* emit ascii format */
@@ -132,19 +128,22 @@ P1\n\
 # CREATOR: GNU libplot drawing library, version %s\n\
 %d %d\n", PL_LIBPLOT_VER_STRING, width, height);
 	  for (j = 0; j < height; j++)
-	    for (i = 0; i < width; i++)
-	      {
-		if (pixmap[j][i].u.rgb[0] == 0)
-		  linebuf[pos++] = '1';	/* 1 = black */
-		else
-		  linebuf[pos++] = '0';
-		if (pos >= MAX_PBM_PIXELS_PER_LINE || i == (width - 1))
-		  {
-		    fwrite ((void *)linebuf, sizeof(unsigned char), pos, fp);
-		    putc ('\n', fp);
-		    pos = 0;
-		  }
-	      }
+	    {
+	      _pl_canvas_row (canvas, j, 1, pixels);
+	      for (i = 0; i < width; i++)
+		{
+		  if (pixels[i] == 0)
+		    linebuf[pos++] = '1';	/* 1 = black */
+		  else
+		    linebuf[pos++] = '0';
+		  if (pos >= MAX_PBM_PIXELS_PER_LINE || i == (width - 1))
+		    {
+		      fwrite ((void *)linebuf, sizeof(unsigned char), pos, fp);
+		      putc ('\n', fp);
+		      pos = 0;
+		    }
+		}
+	    }
 	}
       else			/* emit binary format */
 	{
@@ -161,12 +160,13 @@ P4\n\
 	  rowbuf = (unsigned char *)_pl_xmalloc (((width + 7) / 8) * sizeof (unsigned char));
 	  for (j = 0; j < height; j++)
 	    {
+	      _pl_canvas_row (canvas, j, 1, pixels);
 	      bitcount = 0;
 	      bytecount = 0;
 	      outbyte = 0;
 	      for (i = 0; i < width; i++)
 		{
-		  set = (pixmap[j][i].u.rgb[0] == 0 ? 1 : 0); /* 1 = black */
+		  set = (pixels[i] == 0 ? 1 : 0); /* 1 = black */
 		  outbyte = (outbyte << 1) | set;
 		  bitcount++;
 		  if (bitcount == 8)	/* write byte to row (8 bits) */
@@ -203,20 +203,23 @@ P1\n\
 		 << width << ' ' << height << '\n';
 	  
 	  for (j = 0; j < height; j++)
-	    for (i = 0; i < width; i++)
-	      {
-		if (pixmap[j][i].u.rgb[0] == 0)
-		  linebuf[pos++] = '1';	/* 1 = black */
-		else
-		  linebuf[pos++] = '0';
-		if (pos >= MAX_PBM_PIXELS_PER_LINE || i == (width - 1))
-		  {
-		    stream->write ((const char *)linebuf, pos);
-		    stream->put ('\n');
-
-		    pos = 0;
-		  }
-	      }
+	    {
+	      _pl_canvas_row (canvas, j, 1, pixels);
+	      for (i = 0; i < width; i++)
+		{
+		  if (pixels[i] == 0)
+		    linebuf[pos++] = '1';	/* 1 = black */
+		  else
+		    linebuf[pos++] = '0';
+		  if (pos >= MAX_PBM_PIXELS_PER_LINE || i == (width - 1))
+		    {
+		      stream->write ((const char *)linebuf, pos);
+		      stream->put ('\n');
+
+		      pos = 0;
+		    }
+		}
+	    }
 	}
       else			/* emit binary format */
 	{
@@ -235,12 +238,13 @@ P4\n\
 	  rowbuf = (unsigned char *)_pl_xmalloc (((width + 7) / 8) * sizeof (unsigned char));
 	  for (j = 0; j < height; j++)
 	    {
+	      _pl_canvas_row (canvas, j, 1, pixels);
 	      bitcount = 0;
 	      bytecount = 0;
 	      outbyte = 0;
 	      for (i = 0; i < width; i++)
 		{
-		  set = (pixmap[j][i].u.rgb[0] == 0 ? 1 : 0); /* 1 = black */
+		  set = (pixels[i] == 0 ? 1 : 0); /* 1 = black */
 		  outbyte = (outbyte << 1) | set;
 		  bitcount++;
 		  if (bitcount == 8)	/* write byte to row (8 bits) */
@@ -263,6 +267,8 @@ P4\n\
 	}
     }
 #endif
+
+  free (pixels);
 }
 
 /* write output (header plus RGB values) in PGM format */
@@ -271,7 +277,8 @@ _pl_n_write_pgm (S___(Plotter *_plotter))
 {
   int i, j;
   bool portable = _plotter->n_portable_output;
-  miPixel **pixmap = ((miCanvas *)(_plotter->b_canvas))->drawable->pixmap;
+  void *canvas = _plotter->b_canvas;
+  unsigned char *pixels;		/* colors of the current row */
   int width = _plotter->b_xn;
   int height = _plotter->b_yn;  
   FILE *fp = _plotter->data->outfp;
@@ -287,6 +294,8 @@ _pl_n_write_pgm (S___(Plotter *_plotter))
     return;
 #endif
 
+  pixels = (unsigned char *)_pl_xmalloc (width * sizeof (unsigned char));
+
   if (fp)
     {
       if (portable)			/* emit ascii format */
@@ -303,21 +312,24 @@ P2\n\
 255\n", PL_LIBPLOT_VER_STRING, width, height);
 	  
 	  for (j = 0; j < height; j++)
-	    for (i = 0; i < width; i++)
-	      {
-		/* emit <=3 decimal digits per grayscale pixel */
-		FAST_PRINT (pixmap[j][i].u.rgb[0], linebuf, pos)
-		num_pixels++;
-		if (num_pixels >= MAX_PGM_PIXELS_PER_LINE || i == (width - 1))
-		  {
-		    fwrite ((void *)linebuf, sizeof(unsigned char), pos, fp);
-		    putc ('\n', fp);
-		    num_pixels = 0;
-		    pos = 0;
-		  }
-		else
-		  linebuf[pos++] = ' ';
-	      }
+	    {
+	      _pl_canvas_row (canvas, j, 1, pixels);
+	      for (i = 0; i < width; i++)
+		{
+		  /* emit <=3 decimal digits per grayscale pixel */
+		  FAST_PRINT (pixels[i], linebuf, pos)
+		  num_pixels++;
+		  if (num_pixels >= MAX_PGM_PIXELS_PER_LINE || i == (width - 1))
+		    {
+		      fwrite ((void *)linebuf, sizeof(unsigned char), pos, fp);
+		      putc ('\n', fp);
+		      num_pixels = 0;
+		      pos = 0;
+		    }
+		  else
+		    linebuf[pos++] = ' ';
+		}
+	    }
 	}
       else				/* emit binary format */
 	{
@@ -332,8 +344,7 @@ P5\n\
 	  
 	  for (j = 0; j < height; j++)
 	    {
-	      for (i = 0; i < width; i++)
-		rowbuf[i] = pixmap[j][i].u.rgb[0];
+	      _pl_canvas_row (canvas, j, 1, rowbuf);
 	      fwrite ((void *)rowbuf, sizeof(unsigned char), width, fp);
 	    }
 	  free (rowbuf);
@@ -357,22 +368,25 @@ P2\n\
 	         << "255" << '\n';
 	  
 	  for (j = 0; j < height; j++)
-	    for (i = 0; i < width; i++)
-	      {
-		/* emit <=3 decimal digits per grayscale pixel */
-		FAST_PRINT (pixmap[j][i].u.rgb[0], linebuf, pos)
-		num_pixels++;
-		if (num_pixels >= MAX_PGM_PIXELS_PER_LINE || i == (width - 1))
-		  {
-		    stream->write ((const char *)linebuf, pos);
-		    stream->put ('\n');
-
-		    num_pixels = 0;
-		    pos = 0;
-		  }
-		else
-		  linebuf[pos++] = ' ';
-	      }
+	    {
+	      _pl_canvas_row (canvas, j, 1, pixels);
+	      for (i = 0; i < width; i++)
+		{
+		  /* emit <=3 decimal digits per grayscale pixel */
+		  FAST_PRINT (pixels[i], linebuf, pos)
+		  num_pixels++;
+		  if (num_pixels >= MAX_PGM_PIXELS_PER_LINE || i == (width - 1))
+		    {
+		      stream->write ((const char *)linebuf, pos);
+		      stream->put ('\n');
+
+		      num_pixels = 0;
+		      pos = 0;
+		    }
+		  else
+		    linebuf[pos++] = ' ';
+		}
+	    }
 	}
       else				/* emit binary format */
 	{
@@ -388,14 +402,15 @@ P5\n\
 	  rowbuf = (unsigned char *)_pl_xmalloc (width * sizeof (unsigned char));
 	  for (j = 0; j < height; j++)
 	    {
-	      for (i = 0; i < width; i++)
-		rowbuf[i] = pixmap[j][i].u.rgb[0];
+	      _pl_canvas_row (canvas, j, 1, rowbuf);
 	      stream->write ((const char *)rowbuf, width);
 	    }
 	  free (rowbuf);
 	}
     }
 #endif
+
+  free (pixels);
 }
 
 /* write output (header plus RGB values) in PPM format */
@@ -404,7 +419,8 @@ _pl_n_write_ppm (S___(Plotter *_plotter))
 {
   int i, j;
   bool portable = _plotter->n_portable_output;
-  miPixel **pixmap = ((miCanvas *)(_plotter->b_canvas))->drawable->pixmap;
+  void *canvas = _plotter->b_canvas;
+  unsigned char *pixels;		/* colors of the current row */
   int width = _plotter->b_xn;
   int height = _plotter->b_yn;  
   FILE *fp = _plotter->data->outfp;
@@ -420,6 +436,8 @@ _pl_n_write_ppm (S___(Plotter *_plotter))
     return;
 #endif
 
+  pixels = (unsigned char *)_pl_xmalloc (3 * width * sizeof (unsigned char));
+
   if (fp)
     {
       if (portable)			/* emit ascii format */
@@ -436,30 +454,32 @@ P3\n\
 255\n", PL_LIBPLOT_VER_STRING, width, height);
       
 	  for (j = 0; j < height; j++)
-	    for (i = 0; i < width; i++)
-	      {
-		/* emit <=3 decimal digits per RGB component */
-		FAST_PRINT (pixmap[j][i].u.rgb[0], linebuf, pos)
-		linebuf[pos++] = ' ';
-		FAST_PRINT (pixmap[j][i].u.rgb[1], linebuf, pos)
-		linebuf[pos++] = ' ';
-		FAST_PRINT (pixmap[j][i].u.rgb[2], linebuf, pos)
-		num_pixels++;
-		if (num_pixels >= MAX_PPM_PIXELS_PER_LINE || i == (width - 1))
-		  {
-		    fwrite ((void *)linebuf, sizeof(unsigned char), pos, fp);
-		    putc ('\n', fp);
-		    num_pixels = 0;
-		    pos = 0;
-		  }
-		else
+	    {
+	      _pl_canvas_row (canvas, j, 3, pixels);
+	      for (i = 0; i < width; i++)
+		{
+		  /* emit <=3 decimal digits per RGB component */
+		  FAST_PRINT (pixels[3 * i], linebuf, pos)
 		  linebuf[pos++] = ' ';
-	      }
+		  FAST_PRINT (pixels[3 * i + 1], linebuf, pos)
+		  linebuf[pos++] = ' ';
+		  FAST_PRINT (pixels[3 * i + 2], linebuf, pos)
+		  num_pixels++;
+		  if (num_pixels >= MAX_PPM_PIXELS_PER_LINE || i == (width - 1))
+		    {
+		      fwrite ((void *)linebuf, sizeof(unsigned char), pos, fp);
+		      putc ('\n', fp);
+		      num_pixels = 0;
+		      pos = 0;
+		    }
+		  else
+		    linebuf[pos++] = ' ';
+		}
+	    }
 	}
       else			/* emit binary format */
 	{
 	  unsigned char *rowbuf;
-	  int component;
 
 	  fprintf (fp, "\
 P6\n\
@@ -470,9 +490,7 @@ P6\n\
 	  rowbuf = (unsigned char *)_pl_xmalloc (3 * width * sizeof (unsigned char));
 	  for (j = 0; j < height; j++)
 	    {
-	      for (i = 0; i < width; i++)
-		for (component = 0; component < 3; component++)
-		  rowbuf[3 * i + component] = pixmap[j][i].u.rgb[component];
+	      _pl_canvas_row (canvas, j, 3, rowbuf);
 	      fwrite ((void *)rowbuf, sizeof(unsigned char), 3 * width, fp);
 	    }
 	  free (rowbuf);
@@ -496,31 +514,33 @@ P3\n\
 	         << "255" << '\n';
       
 	  for (j = 0; j < height; j++)
-	    for (i = 0; i < width; i++)
-	      {
-		/* emit <=3 decimal digits per RGB component */
-		FAST_PRINT (pixmap[j][i].u.rgb[0], linebuf, pos)
-		linebuf[pos++] = ' ';
-		FAST_PRINT (pixmap[j][i].u.rgb[1], linebuf, pos)
-		linebuf[pos++] = ' ';
-		FAST_PRINT (pixmap[j][i].u.rgb[2], linebuf, pos)
-		num_pixels++;
-		if (num_pixels >= MAX_PPM_PIXELS_PER_LINE || i == (width - 1))
-		  {
-		    stream->write ((const char *)linebuf, pos);
-		    stream->put ('\n');
-
-		    num_pixels = 0;
-		    pos = 0;
-		  }
-		else
+	    {
+	      _pl_canvas_row (canvas, j, 3, pixels);
+	      for (i = 0; i < width; i++)
+		{
+		  /* emit <=3 decimal digits per RGB component */
+		  FAST_PRINT (pixels[3 * i], linebuf, pos)
+		  linebuf[pos++] = ' ';
+		  FAST_PRINT (pixels[3 * i + 1], linebuf, pos)
 		  linebuf[pos++] = ' ';
-	      }
+		  FAST_PRINT (pixels[3 * i + 2], linebuf, pos)
+		  num_pixels++;
+		  if (num_pixels >= MAX_PPM_PIXELS_PER_LINE || i == (width - 1))
+		    {
+		      stream->write ((const char *)linebuf, pos);
+		      stream->put ('\n');
+
+		      num_pixels = 0;
+		      pos = 0;
+		    }
+		  else
+		    linebuf[pos++] = ' ';
+		}
+	    }
 	}
       else			/* emit binary format */
 	{
 	  unsigned char *rowbuf;
-	  int component;
 	  
 	  (*stream) << "\
 P6\n\
@@ -532,56 +552,13 @@ P6\n\
 	  rowbuf = (unsigned char *)_pl_xmalloc (3 * width * sizeof (unsigned char));
 	  for (j = 0; j < height; j++)
 	    {
-	      for (i = 0; i < width; i++)
-		for (component = 0; component < 3; component++)
-		  rowbuf[3 * i + component] = pixmap[j][i].u.rgb[component];
+	      _pl_canvas_row (canvas, j, 3, rowbuf);
 	      stream->write ((const char *)rowbuf, 3 * width);
 	    }
 	  free (rowbuf);
 	}
     }
 #endif
-}
 
-/* return best type for writing an image (0=mono, 1=grey, 2=color) */
-static int
-best_image_type (miPixel **pixmap, int width, int height)
-{
-  int i, j;
-  int type = 0;			/* default is mono */
-  
-  for (j = 0; j < height; j++)
-    for (i = 0; i < width; i++)
-      {
-	unsigned char red, green, blue;
-	
-	red = pixmap[j][i].u.rgb[0];
-	green = pixmap[j][i].u.rgb[1];
-	blue = pixmap[j][i].u.rgb[2];
-	if (type == 0)		/* up to now, all pixels are black or white */
-	  {
-	    if (! ((red == (unsigned char)0 && green == (unsigned char)0
-		    && blue == (unsigned char)0)
-		   || (red == (unsigned char)255 && green == (unsigned char)255
-		    && blue == (unsigned char)255)))
-	      {
-		if (red == green && red == blue)
-		  type = 1;	/* need grey */
-		else
-		  {
-		    type = 2;	/* need color */
-		    return type;
-		  }
-	      }
-	  }
-	else if (type == 1)
-	  {
-	    if (red != green || red != blue)
-	      {
-		type = 2;	/* need color */
-		return type;
-	      }
-	  }
-      }
-  return type;
+  free (pixels);
 }
@@ -22,5 +22,10 @@
 bool
 _pl_p_end_page (S___(Plotter *_plotter))
 {
+  /* if streaming, attach header and trailer so that closepl() can write
+     out the page right away */
+  if (_plotter->ps_streaming)
+    _pl_p_stream_page (S___(_plotter));
+
   return true;
 }
@@ -68,7 +68,9 @@ const Plotter _pl_p_default_plotter =
   /* internal path-painting methods (endpath() is a wrapper for the first) */
   _pl_p_paint_path, _pl_p_paint_paths, _pl_g_path_is_flushable, _pl_g_maybe_prepaint_segments,
   /* internal methods for drawing of markers and points */
-  _pl_g_paint_marker, _pl_p_paint_point,
+  _pl_g_paint_marker, _pl_p_paint_markers, _pl_p_paint_point,
+  /* internal methods for drawing and reading of raster images */
+  _pl_p_paint_image, _pl_g_read_image,
   /* internal methods that plot strings in Hershey, non-Hershey fonts */
   _pl_g_paint_text_string_with_escapes, _pl_p_paint_text_string,
   _pl_g_get_text_width,
@@ -109,7 +111,7 @@ _pl_p_initialize (S___(Plotter *_plotter))
   _plotter->data->type = PL_PS;
 #endif
 
-  /* output model */
+  /* output model (see below, for streaming) */
   _plotter->data->output_model = PL_OUTPUT_PAGES_ALL_AT_ONCE;
   
   /* user-queryable capabilities: 0/1/2 = no/yes/maybe */
@@ -169,7 +171,36 @@ _pl_p_initialize (S___(Plotter *_plotter))
   _plotter->data->ymax = 0.0;  
   _plotter->data->page_data = (plPageData *)NULL;
 
+  /* PS-specific initializations */
+  _plotter->ps_streaming = false;
+  _plotter->ps_doc_xmin = DBL_MAX;
+  _plotter->ps_doc_ymin = DBL_MAX;
+  _plotter->ps_doc_xmax = -(DBL_MAX);
+  _plotter->ps_doc_ymax = -(DBL_MAX);
+  {
+    int i;
+
+    for (i = 0; i < PL_NUM_PS_FONTS; i++)
+      _plotter->ps_font_used_in_doc[i] = false;
+    for (i = 0; i < PL_NUM_PCL_FONTS; i++)
+      _plotter->pcl_font_used_in_doc[i] = false;
+  }
+
   /* initialize certain data members from device driver parameters */
+
+  /* streaming output?  If so, each page is written out by closepl(), so
+     that only one page is held in memory; the DSC comments that depend
+     on all pages are deferred to the document trailer */
+  {
+    const char *streaming_s;
+
+    streaming_s = (const char *)_get_plot_param (_plotter->data, "PS_STREAMING");
+    if (strcasecmp (streaming_s, "yes") == 0)
+      {
+	_plotter->ps_streaming = true;
+	_plotter->data->output_model = PL_OUTPUT_ONE_PAGE_AT_A_TIME;
+      }
+  }
       
   /* Determine range of device coordinates over which the viewport will
      extend (and hence the transformation from user to device coordinates;
@@ -197,6 +228,402 @@ _pl_p_initialize (S___(Plotter *_plotter))
   _compute_ndc_to_device_map (_plotter->data);
 }
 
+/* Internal routines that append pieces of the document structure to a
+   plOutbuf.  They are shared by _pl_p_terminate(), which emits all pages
+   at once, and _pl_p_stream_page(), which emits each page as soon as it
+   is closed. */
+
+/* append a DSC comment (e.g. "%%PageResources: ") listing the fonts
+   flagged in a pair of `font used' arrays */
+static void
+_p_emit_font_list (plOutbuf *buf, const char *comment, const bool *ps_font_used, const bool *pcl_font_used)
+{
+  bool first_font = true;
+  int i;
+
+  strcpy (buf->point, comment);
+  _update_buffer (buf);
+  for (i = 0; i < PL_NUM_PS_FONTS; i++)
+    {
+      if (ps_font_used[i])
+	{
+	  if (first_font == false)
+	    {
+	      strcpy (buf->point, "%%+ ");
+	      _update_buffer (buf);
+	    }
+	  strcpy (buf->point, "font ");
+	  _update_buffer (buf);
+	  strcpy (buf->point, _pl_g_ps_font_info[i].ps_name);
+	  _update_buffer (buf);
+	  strcpy (buf->point, "\n");
+	  _update_buffer (buf);
+	  first_font = false;
+	}
+    }
+#ifdef USE_LJ_FONTS_IN_PS
+  for (i = 0; i < PL_NUM_PCL_FONTS; i++)
+    {
+      if (pcl_font_used[i])
+	{
+	  if (first_font == false)
+	    {
+	      strcpy (buf->point, "%%+ ");
+	      _update_buffer (buf);
+	    }
+	  strcpy (buf->point, "font ");
+	  _update_buffer (buf);
+	  /* use replacement font name if any (this is only to support the
+	     Tidbits-is-Wingdings botch) */
+	  if (_pl_g_pcl_font_info[i].substitute_ps_name)
+	    strcpy (buf->point, _pl_g_pcl_font_info[i].substitute_ps_name);
+	  else
+	    strcpy (buf->point, _pl_g_pcl_font_info[i].ps_name);
+	  _update_buffer (buf);
+	  strcpy (buf->point, "\n");
+	  _update_buffer (buf);
+	  first_font = false;
+	}
+    }
+#endif
+  if (first_font)		/* no fonts needed */
+    {
+      strcpy (buf->point, "\n");
+      _update_buffer (buf);
+    }
+}
+
+/* append a DSC bounding box comment (e.g. "PageBoundingBox") */
+static void
+_p_emit_bbox (plOutbuf *buf, const char *keyword, double x_min, double x_max, double y_min, double y_max)
+{
+  if (x_min > x_max || y_min > y_max)
+    /* empty page(s) */
+    sprintf (buf->point, "\
+%%%%%s: 0 0 0 0\n", keyword);
+  else
+    sprintf (buf->point, "\
+%%%%%s: %d %d %d %d\n", keyword,
+	     IROUND(x_min - 0.5), IROUND(y_min - 0.5),
+	     IROUND(x_max + 0.5), IROUND(y_max + 0.5));
+  _update_buffer (buf);
+}
+
+/* tell driver to include any PS [or PCL] fonts that are needed */
+static void
+_p_emit_font_includes (plOutbuf *buf, const bool *ps_font_used, const bool *pcl_font_used)
+{
+  int i;
+
+  for (i = 0; i < PL_NUM_PS_FONTS; i++)
+    if (ps_font_used[i])
+      {
+	sprintf (buf->point, "\
+%%%%IncludeResource: font %s\n", _pl_g_ps_font_info[i].ps_name);
+	_update_buffer (buf);
+      }
+#ifdef USE_LJ_FONTS_IN_PS
+  for (i = 0; i < PL_NUM_PCL_FONTS; i++)
+    if (pcl_font_used[i])
+      {
+	/* this is to support the Tidbits-is-Wingdings botch */
+	if (_pl_g_pcl_font_info[i].substitute_ps_name)
+	  sprintf (buf->point, "\
+%%%%IncludeResource: font %s\n", _pl_g_pcl_font_info[i].substitute_ps_name);
+	else
+	  sprintf (buf->point, "\
+%%%%IncludeResource: font %s\n", _pl_g_pcl_font_info[i].ps_name);
+	_update_buffer (buf);
+      }
+#endif
+}
+
+/* do ISO-Latin-1 reencoding for any fonts that need it; the reencodeISO
+   procedure must already be defined, unless `with_fontproc' is set */
+static void
+_p_emit_reencodings (plOutbuf *buf, const bool *ps_font_used, const bool *pcl_font_used, bool with_fontproc)
+{
+  bool need_to_reencode = false;
+  int i;
+
+  for (i = 0; i < PL_NUM_PS_FONTS; i++)
+    if (ps_font_used[i] && _pl_g_ps_font_info[i].iso8859_1)
+      {
+	need_to_reencode = true;
+	break;
+      }
+#ifdef USE_LJ_FONTS_IN_PS
+  for (i = 0; i < PL_NUM_PCL_FONTS; i++)
+    if (pcl_font_used[i] && _pl_g_pcl_font_info[i].iso8859_1)
+      {
+	need_to_reencode = true;
+	break;
+      }
+#endif
+  if (need_to_reencode == false)
+    return;
+
+  if (with_fontproc)
+    {
+      strcpy (buf->point, _ps_fontproc);
+      _update_buffer (buf);
+    }
+  for (i = 0; i < PL_NUM_PS_FONTS; i++)
+    {
+      if (ps_font_used[i] && _pl_g_ps_font_info[i].iso8859_1)
+	{
+	  sprintf (buf->point, "\
+/%s reencodeISO def\n",
+		   _pl_g_ps_font_info[i].ps_name);
+	  _update_buffer (buf);
+	}
+    }
+#ifdef USE_LJ_FONTS_IN_PS
+  for (i = 0; i < PL_NUM_PCL_FONTS; i++)
+    {
+      if (pcl_font_used[i] && _pl_g_pcl_font_info[i].iso8859_1)
+	{
+	  sprintf (buf->point, "\
+/%s reencodeISO def\n",
+		   _pl_g_pcl_font_info[i].ps_name);
+	  _update_buffer (buf);
+	}
+    }
+#endif
+}
+
+/* append the idraw-derived PS prologue, as a DSC resource */
+static void
+_p_emit_procset (plOutbuf *buf)
+{
+  int i;
+
+  sprintf (buf->point, "\
+%%%%BeginResource: procset %s %s 0\n",
+	   PS_PROCSET_NAME, PS_PROCSET_VERSION);
+  _update_buffer (buf);
+  /* write out idraw-derived PS prologue in p_header.h (makes many
+     definitions) */
+  for (i=0; *_ps_procset[i]; i++)
+    {
+      strcpy (buf->point, _ps_procset[i]);
+      _update_buffer (buf);
+    }
+  strcpy (buf->point, "\
+%%EndResource\n");
+  _update_buffer (buf);
+}
+
+/* Append the document header (DSC lines, etc.).  The header is very long:
+   most of it is simply the idraw header (see p_header.h).  If `streaming'
+   is set, the header is written before any page is known, so the page
+   count, bounding box and font list are deferred to the trailer with
+   `(atend)', the document is PS rather than EPS, and the fonts are
+   included and reencoded page by page instead. */
+static void
+_p_emit_doc_header (plOutbuf *buf, int num_pages, bool streaming, double x_min, double x_max, double y_min, double y_max, const bool *ps_font_used, const bool *pcl_font_used)
+{
+  time_t clock;
+  char *time_string, time_string_buffer[32];
+  bool eps = (num_pages == 1 && streaming == false);
+
+  if (eps)
+    /* will plot an EPS file, not just a PS file */
+    sprintf (buf->point, "\
+%%!PS-Adobe-3.0 EPSF-3.0\n");
+  else
+    sprintf (buf->point, "\
+%%!PS-Adobe-3.0\n");
+  _update_buffer (buf);
+
+  /* Compute an ASCII representation of the current time, in a
+     reentrant way if we're supporting pthreads (i.e. by using ctime_r
+     if it's available). */
+  time (&clock);
+#ifdef PTHREAD_SUPPORT
+#ifdef HAVE_PTHREAD_H
+#ifdef HAVE_CTIME_R
+  ctime_r (&clock, time_string_buffer);
+  time_string = time_string_buffer;
+#else
+  time_string = ctime (&clock);
+#endif
+#else
+  time_string = ctime (&clock);
+#endif
+#else
+  time_string = ctime (&clock);
+#endif
+
+  sprintf (buf->point, "\
+%%%%Creator: GNU libplot drawing library %s\n\
+%%%%Title: PostScript plot\n\
+%%%%CreationDate: %s\
+%%%%DocumentData: Clean7Bit\n\
+%%%%LanguageLevel: 1\n",
+	   PL_LIBPLOT_VER_STRING, time_string);
+  _update_buffer (buf);
+  if (streaming)
+    strcpy (buf->point, "\
+%%Pages: (atend)\n");
+  else
+    sprintf (buf->point, "\
+%%%%Pages: %d\n", num_pages);
+  _update_buffer (buf);
+  strcpy (buf->point, "\
+%%PageOrder: Ascend\n\
+%%Orientation: Portrait\n");
+  _update_buffer (buf);
+
+  /* emit the bounding box for the document, and the list of fonts needed
+     by the document */
+  if (streaming)
+    {
+      strcpy (buf->point, "\
+%%BoundingBox: (atend)\n\
+%%DocumentNeededResources: (atend)\n");
+      _update_buffer (buf);
+    }
+  else
+    {
+      _p_emit_bbox (buf, "BoundingBox", x_min, x_max, y_min, y_max);
+      _p_emit_font_list (buf, "%%DocumentNeededResources: ",
+			 ps_font_used, pcl_font_used);
+    }
+
+  /* emit final DSC lines in header */
+  if (num_pages > 0 || streaming)
+    {
+      sprintf (buf->point, "\
+%%%%DocumentSuppliedResources: procset %s %s 0\n",
+	       PS_PROCSET_NAME, PS_PROCSET_VERSION);
+      _update_buffer (buf);
+    }
+  strcpy (buf->point, "\
+%%EndComments\n\n");
+  _update_buffer (buf);
+
+  /* write out list of fonts needed by the document, all over again;
+     this time it's interpreted as the default font list for each page
+     (a streamed document has no defaults: each page lists its own) */
+  if (streaming == false)
+    {
+      strcpy (buf->point, "\
+%%BeginDefaults\n");
+      _update_buffer (buf);
+      _p_emit_font_list (buf, "%%PageResources: ",
+			 ps_font_used, pcl_font_used);
+      strcpy (buf->point, "\
+%%EndDefaults\n\n");
+      _update_buffer (buf);
+    }
+
+  /* Document Prolog */
+  strcpy (buf->point, "\
+%%BeginProlog\n");
+  _update_buffer (buf);
+  if (num_pages > 1 || streaming)
+    /* PS [not EPS] file, include procset in document prolog */
+    _p_emit_procset (buf);
+  strcpy (buf->point, "\
+%%EndProlog\n\n");
+  _update_buffer (buf);
+
+  /* Document Setup */
+  strcpy (buf->point, "\
+%%BeginSetup\n");
+  _update_buffer (buf);
+
+  if (streaming == false)
+    _p_emit_font_includes (buf, ps_font_used, pcl_font_used);
+
+  /* push private dictionary on stack */
+  strcpy (buf->point, "\
+/DrawDict 50 dict def\n\
+DrawDict begin\n");
+  _update_buffer (buf);
+
+  if (streaming)
+    /* fonts used by later pages are reencoded by those pages */
+    {
+      strcpy (buf->point, _ps_fontproc);
+      _update_buffer (buf);
+    }
+  else
+    _p_emit_reencodings (buf, ps_font_used, pcl_font_used, true);
+
+  if (eps)
+    /* EPS [not just PS] file, include procset in setup section,
+       so that it will modify only the private dictionary */
+    _p_emit_procset (buf);
+
+  strcpy (buf->point, "\
+%%EndSetup\n\n");
+  _update_buffer (buf);
+}
+
+/* Append the header of page number `n' (DSC lines, and idraw
+   initialization code).  If `streaming' is set, the page setup also
+   includes and reencodes the fonts the page uses. */
+static void
+_p_emit_page_header (plOutbuf *buf, plOutbuf *page, int n, bool streaming)
+{
+  double x_min, x_max, y_min, y_max;
+
+  sprintf (buf->point, "\
+%%%%Page: %d %d\n", n, n);
+  _update_buffer (buf);
+
+  /* write out list of fonts needed by the page */
+  _p_emit_font_list (buf, "%%PageResources: ",
+		     page->ps_font_used, page->pcl_font_used);
+
+  /* emit the bounding box for the page */
+  _bbox_of_outbuf (page, &x_min, &x_max, &y_min, &y_max);
+  _p_emit_bbox (buf, "PageBoundingBox", x_min, x_max, y_min, y_max);
+
+  /* Page Setup */
+  strcpy (buf->point, "\
+%%BeginPageSetup\n");
+  _update_buffer (buf);
+  if (streaming)
+    {
+      _p_emit_font_includes (buf, page->ps_font_used, page->pcl_font_used);
+      _p_emit_reencodings (buf, page->ps_font_used, page->pcl_font_used,
+			   false);
+    }
+  /* emit initialization code (including idraw, PS directives) */
+  /* N.B. `8' below is the version number of the idraw PS format
+     we're producing; see <Unidraw/Components/psformat.h> */
+  strcpy (buf->point, "\
+%I Idraw 8\n\n\
+Begin\n\
+%I b u\n\
+%I cfg u\n\
+%I cbg u\n\
+%I f u\n\
+%I p u\n\
+%I t\n\
+[ 1 0 0 1 0 0 ] concat\n\
+/originalCTM matrix currentmatrix def\n\
+/trueoriginalCTM matrix currentmatrix def\n");
+  _update_buffer (buf);
+  strcpy (buf->point, "\
+%%EndPageSetup\n\n");
+  _update_buffer (buf);
+}
+
+/* Append the page trailer, which includes `showpage' */
+static void
+_p_emit_page_trailer (plOutbuf *buf)
+{
+  strcpy (buf->point, "\
+%%PageTrailer\n\
+End %I eop\n\
+showpage\n\n");
+  _update_buffer (buf);
+}
+
 /* The private `terminate' method, which is invoked when a Plotter is
    deleted.  It may do such things as write to an output stream from
    internal storage, deallocate storage, etc.  When this is invoked,
@@ -217,98 +644,75 @@ _pl_p_initialize (S___(Plotter *_plotter))
    a plOutbuf, and the page plOutbufs form a linked list.  In this function
    we write the document header, the document trailer, and the
    header/trailer for each page, all to separate plOutbufs.  We then copy
-   the plOutbufs, one after another, to the output stream. */
+   the plOutbufs, one after another, to the output stream.
+
+   If the PS_STREAMING parameter was set, each page has instead been
+   written out by closepl(), and the document header along with the first
+   page (see _pl_p_stream_page() below).  All that remains is to emit the
+   document trailer, which supplies the DSC comments deferred with
+   `(atend)'. */
 
 void
 _pl_p_terminate (S___(Plotter *_plotter))
 {
   double x_min, x_max, y_min, y_max;
   int i, n;
-  time_t clock;
   plOutbuf *doc_header, *doc_trailer, *current_page;
   bool ps_font_used_in_doc[PL_NUM_PS_FONTS];
-#ifdef USE_LJ_FONTS_IN_PS
-  bool pcl_font_used_in_doc[PL_NUM_PCL_FONTS];	
-#endif
-  char *time_string, time_string_buffer[32];
+  bool pcl_font_used_in_doc[PL_NUM_PCL_FONTS];
 
 #ifdef LIBPLOTTER
-  if (_plotter->data->outfp || _plotter->data->outstream)
+  if ((_plotter->data->outfp || _plotter->data->outstream)
+      && _plotter->ps_streaming)
 #else
-  if (_plotter->data->outfp)
+  if (_plotter->data->outfp && _plotter->ps_streaming)
 #endif
-    /* have an output stream */
+    /* have an output stream, to which pages have already been written */
     {
-      int num_pages = _plotter->data->page_number;
-
-      /* First, prepare the document header (DSC lines, etc.), and write it
-         to a plOutbuf.  The header is very long: most of it is simply the
-         idraw header (see p_header.h). */
-      doc_header = _new_outbuf ();
-
-      if (num_pages == 1)
-	/* will plot an EPS file, not just a PS file */
-	sprintf (doc_header->point, "\
-%%!PS-Adobe-3.0 EPSF-3.0\n");
-      else
-	sprintf (doc_header->point, "\
-%%!PS-Adobe-3.0\n");
-      _update_buffer (doc_header);
+      doc_trailer = _new_outbuf ();
+      if (_plotter->data->page_number == 0)
+	/* no page was ever closed, so no header has been written */
+	_p_emit_doc_header (doc_trailer, 0, true, 0.0, 0.0, 0.0, 0.0,
+			    _plotter->ps_font_used_in_doc,
+			    _plotter->pcl_font_used_in_doc);
+
+      /* Document Trailer: pop private dictionary off stack, and emit
+	 the DSC comments that were deferred */
+      sprintf (doc_trailer->point, "\
+%%%%Trailer\n\
+end\n\
+%%%%Pages: %d\n", _plotter->data->page_number);
+      _update_buffer (doc_trailer);
+      _p_emit_bbox (doc_trailer, "BoundingBox",
+		    _plotter->ps_doc_xmin, _plotter->ps_doc_xmax,
+		    _plotter->ps_doc_ymin, _plotter->ps_doc_ymax);
+      _p_emit_font_list (doc_trailer, "%%DocumentNeededResources: ",
+			 _plotter->ps_font_used_in_doc,
+			 _plotter->pcl_font_used_in_doc);
+      strcpy (doc_trailer->point, "\
+%%EOF\n");
+      _update_buffer (doc_trailer);
 
-      /* Compute an ASCII representation of the current time, in a
-	 reentrant way if we're supporting pthreads (i.e. by using ctime_r
-	 if it's available). */
-      time (&clock);
-#ifdef PTHREAD_SUPPORT
-#ifdef HAVE_PTHREAD_H
-#ifdef HAVE_CTIME_R
-      ctime_r (&clock, time_string_buffer);
-      time_string = time_string_buffer;
-#else
-      time_string = ctime (&clock);
-#endif
-#else
-      time_string = ctime (&clock);
-#endif
+      _write_string (_plotter->data, doc_trailer->base);
+      _delete_outbuf (doc_trailer);
+    }
+#ifdef LIBPLOTTER
+  else if (_plotter->data->outfp || _plotter->data->outstream)
 #else
-      time_string = ctime (&clock);
+  else if (_plotter->data->outfp)
 #endif
+    /* have an output stream */
+    {
+      int num_pages = _plotter->data->page_number;
 
-      sprintf (doc_header->point, "\
-%%%%Creator: GNU libplot drawing library %s\n\
-%%%%Title: PostScript plot\n\
-%%%%CreationDate: %s\
-%%%%DocumentData: Clean7Bit\n\
-%%%%LanguageLevel: 1\n\
-%%%%Pages: %d\n\
-%%%%PageOrder: Ascend\n\
-%%%%Orientation: Portrait\n",
-	       PL_LIBPLOT_VER_STRING, time_string, num_pages);
-      _update_buffer (doc_header);
-      
-      /* emit the bounding box for the document */
-      _bbox_of_outbufs (_plotter->data->first_page, &x_min, &x_max, &y_min, &y_max);
-      if (x_min > x_max || y_min > y_max) 
-	/* all pages empty */
-	sprintf (doc_header->point, "\
-%%%%BoundingBox: 0 0 0 0\n");
-      else
-	sprintf (doc_header->point, "\
-%%%%BoundingBox: %d %d %d %d\n",
-		 IROUND(x_min - 0.5), IROUND(y_min - 0.5),
-		 IROUND(x_max + 0.5), IROUND(y_max + 0.5));
-      _update_buffer (doc_header);
-      
       /* determine fonts needed by document, by examining all pages */
       {
 	current_page = _plotter->data->first_page;
-	
+
 	for (i = 0; i < PL_NUM_PS_FONTS; i++)
 	  ps_font_used_in_doc[i] = false;
-#ifdef USE_LJ_FONTS_IN_PS	
 	for (i = 0; i < PL_NUM_PCL_FONTS; i++)
 	  pcl_font_used_in_doc[i] = false;
-#endif
 	while (current_page)
 	  {
 	    for (i = 0; i < PL_NUM_PS_FONTS; i++)
@@ -323,272 +727,13 @@ _pl_p_terminate (S___(Plotter *_plotter))
 	  }
       }
 
-      /* write out list of fonts needed by the document */
-      {
-	bool first_font = true;
-
-	strcpy (doc_header->point, "\
-%%DocumentNeededResources: ");
-	_update_buffer (doc_header);
-
-	for (i = 0; i < PL_NUM_PS_FONTS; i++)
-	  {
-	    if (ps_font_used_in_doc[i])
-	      {
-		if (first_font == false)
-		  {
-		    strcpy (doc_header->point, "%%+ ");
-		    _update_buffer (doc_header);
-		  }
-		strcpy (doc_header->point, "font ");
-		_update_buffer (doc_header);
-		strcpy (doc_header->point, _pl_g_ps_font_info[i].ps_name);
-		_update_buffer (doc_header);
-		strcpy (doc_header->point, "\n");
-		_update_buffer (doc_header);
-		first_font = false;
-	      }
-	  }
-#ifdef USE_LJ_FONTS_IN_PS
-	for (i = 0; i < PL_NUM_PCL_FONTS; i++)
-	  {
-	    if (pcl_font_used_in_doc[i])
-	      {
-		if (first_font == false)
-		  {
-		    strcpy (doc_header->point, "%%+ ");
-		    _update_buffer (doc_header);
-		  }
-		strcpy (doc_header->point, "font ");
-		_update_buffer (doc_header);
-		/* use replacement font name if any (this is only to
-                   support the Tidbits-is-Wingdings botch) */
-		if (_pl_g_pcl_font_info[i].substitute_ps_name)
-		  strcpy (doc_header->point, _pl_g_pcl_font_info[i].substitute_ps_name);
-		else
-		  strcpy (doc_header->point, _pl_g_pcl_font_info[i].ps_name);
-		_update_buffer (doc_header);
-		strcpy (doc_header->point, "\n");
-		_update_buffer (doc_header);
-		first_font = false;
-	      }
-	  }
-#endif
-	if (first_font)		/* no fonts needed in document */
-	  {
-	    strcpy (doc_header->point, "\n");
-	    _update_buffer (doc_header);	    
-	  }
-      }
-
-      /* emit final DSC lines in header */
-      if (num_pages > 0)
-	{
-	  sprintf (doc_header->point, "\
-%%%%DocumentSuppliedResources: procset %s %s 0\n",
-		   PS_PROCSET_NAME, PS_PROCSET_VERSION);
-	  _update_buffer (doc_header);
-	}
-      strcpy (doc_header->point, "\
-%%EndComments\n\n");
-      _update_buffer (doc_header);
-
-      /* write out list of fonts needed by the document, all over again;
-	 this time it's interpreted as the default font list for each page */
-      {
-	bool first_font = true;
-
-	strcpy (doc_header->point, "\
-%%BeginDefaults\n");
-	_update_buffer (doc_header);
-	strcpy (doc_header->point, "\
-%%PageResources: ");
-	_update_buffer (doc_header);
-	for (i = 0; i < PL_NUM_PS_FONTS; i++)
-	  {
-	    if (ps_font_used_in_doc[i])
-	      {
-		if (first_font == false)
-		  {
-		    strcpy (doc_header->point, "%%+ ");
-		    _update_buffer (doc_header);
-		  }
-		strcpy (doc_header->point, "font ");
-		_update_buffer (doc_header);
-		strcpy (doc_header->point, _pl_g_ps_font_info[i].ps_name);
-		_update_buffer (doc_header);
-		strcpy (doc_header->point, "\n");
-		_update_buffer (doc_header);
-		first_font = false;
-	      }
-	  }
-#ifdef USE_LJ_FONTS_IN_PS
-	for (i = 0; i < PL_NUM_PCL_FONTS; i++)
-	  {
-	    if (pcl_font_used_in_doc[i])
-	      {
-		if (first_font == false)
-		  {
-		    strcpy (doc_header->point, "%%+ ");
-		    _update_buffer (doc_header);
-		  }
-		strcpy (doc_header->point, "font ");
-		_update_buffer (doc_header);
-		if (_pl_g_pcl_font_info[i].substitute_ps_name)
-		  /* this is to support the Tidbits-is-Wingdings botch */
-		  strcpy (doc_header->point, _pl_g_pcl_font_info[i].substitute_ps_name);
-		else
-		  strcpy (doc_header->point, _pl_g_pcl_font_info[i].ps_name);
-		_update_buffer (doc_header);
-		strcpy (doc_header->point, "\n");
-		_update_buffer (doc_header);
-		first_font = false;
-	      }
-	  }
-#endif
-	if (first_font)		/* no fonts needed in document */
-	  {
-	    strcpy (doc_header->point, "\n");
-	    _update_buffer (doc_header);
-	  }
-
-	strcpy (doc_header->point, "\
-%%EndDefaults\n\n");
-	_update_buffer (doc_header);
-      }
-
-      /* Document Prolog */
-      strcpy (doc_header->point, "\
-%%BeginProlog\n");
-      _update_buffer (doc_header);
-      if (num_pages > 1)
-	/* PS [not EPS] file, include procset in document prolog */
-	{
-	  sprintf (doc_header->point, "\
-%%%%BeginResource: procset %s %s 0\n", 
-		   PS_PROCSET_NAME, PS_PROCSET_VERSION);
-	  _update_buffer (doc_header);
-	  /* write out idraw-derived PS prologue (makes many definitions) */
-	  for (i=0; *_ps_procset[i]; i++)
-	    {
-	      strcpy (doc_header->point, _ps_procset[i]);
-	      _update_buffer (doc_header);
-	    }
-	  strcpy (doc_header->point, "\
-%%EndResource\n");
-	  _update_buffer (doc_header);
-	}
-      strcpy (doc_header->point, "\
-%%EndProlog\n\n");
-      _update_buffer (doc_header);
-
-      /* Document Setup */
-      strcpy (doc_header->point, "\
-%%BeginSetup\n");
-      _update_buffer (doc_header);
-
-      /* tell driver to include any PS [or PCL] fonts that are needed */
-      for (i = 0; i < PL_NUM_PS_FONTS; i++)
-	  if (ps_font_used_in_doc[i])
-	    {
-	      sprintf (doc_header->point, "\
-%%%%IncludeResource: font %s\n", _pl_g_ps_font_info[i].ps_name);
-	      _update_buffer (doc_header);
-	    }
-#ifdef USE_LJ_FONTS_IN_PS
-      for (i = 0; i < PL_NUM_PCL_FONTS; i++)
-	  if (pcl_font_used_in_doc[i])
-	    {
-	      /* this is to support the Tidbits-is-Wingdings botch */
-	      if (_pl_g_pcl_font_info[i].substitute_ps_name)
-		sprintf (doc_header->point, "\
-%%%%IncludeResource: font %s\n", _pl_g_pcl_font_info[i].substitute_ps_name);
-	      else
-		sprintf (doc_header->point, "\
-%%%%IncludeResource: font %s\n", _pl_g_pcl_font_info[i].ps_name);
-	      _update_buffer (doc_header);
-	    }
-#endif
-
-      /* push private dictionary on stack */
-      strcpy (doc_header->point, "\
-/DrawDict 50 dict def\n\
-DrawDict begin\n");
-      _update_buffer (doc_header);
-
-      /* do ISO-Latin-1 reencoding for any fonts that need it */
-      {
-	bool need_to_reencode = false;
-
-	for (i = 0; i < PL_NUM_PS_FONTS; i++)
-	  if (ps_font_used_in_doc[i] && _pl_g_ps_font_info[i].iso8859_1)
-	    {
-	      need_to_reencode = true;
-	      break;
-	    }
-#ifdef USE_LJ_FONTS_IN_PS
-	for (i = 0; i < PL_NUM_PCL_FONTS; i++)
-	  if (pcl_font_used_in_doc[i] && _pl_g_pcl_font_info[i].iso8859_1)
-	    {
-	      need_to_reencode = true;
-	      break;
-	    }
-#endif
-	if (need_to_reencode)
-	  {
-	    strcpy (doc_header->point, _ps_fontproc);
-	    _update_buffer (doc_header);
-	    
-	    for (i = 0; i < PL_NUM_PS_FONTS; i++)
-	      {
-		if (ps_font_used_in_doc[i] && _pl_g_ps_font_info[i].iso8859_1)
-		  {
-		    sprintf (doc_header->point, "\
-/%s reencodeISO def\n",
-			     _pl_g_ps_font_info[i].ps_name);
-		    _update_buffer (doc_header);
-		  }
-	      }
-#ifdef USE_LJ_FONTS_IN_PS
-	    for (i = 0; i < PL_NUM_PCL_FONTS; i++)
-	      {
-		if (pcl_font_used_in_doc[i] && _pl_g_pcl_font_info[i].iso8859_1)
-		  {
-		    sprintf (doc_header->point, "\
-/%s reencodeISO def\n",
-			     _pl_g_pcl_font_info[i].ps_name);
-		    _update_buffer (doc_header);
-		  }
-	      }
-#endif
-	  }
-      }
-
-      if (num_pages == 1)
-	/* EPS [not just PS] file, include procset in setup section,
-	   so that it will modify only the private dictionary */
-	{
-	  sprintf (doc_header->point, "\
-%%%%BeginResource: procset %s %s 0\n", 
-		   PS_PROCSET_NAME, PS_PROCSET_VERSION);
-	  _update_buffer (doc_header);
-
-	  /* write out idraw-derived PS prologue in p_header.h (makes many
-             definitions) */
-	  for (i=0; *_ps_procset[i]; i++)
-	    {
-	      strcpy (doc_header->point, _ps_procset[i]);
-	      _update_buffer (doc_header);
-	    }
-	  strcpy (doc_header->point, "\
-%%EndResource\n");
-	  _update_buffer (doc_header);
-	}
+      /* First, prepare the document header, and write it to a plOutbuf */
+      doc_header = _new_outbuf ();
+      _bbox_of_outbufs (_plotter->data->first_page, &x_min, &x_max, &y_min, &y_max);
+      _p_emit_doc_header (doc_header, num_pages, false,
+			  x_min, x_max, y_min, y_max,
+			  ps_font_used_in_doc, pcl_font_used_in_doc);
 
-      strcpy (doc_header->point, "\
-%%EndSetup\n\n");
-      _update_buffer (doc_header);
-      
       /* Document header is now prepared, and stored in a plOutbuf.
 	 Now do the same for the doc trailer (much shorter). */
 
@@ -601,131 +746,27 @@ end\n\
       _update_buffer (doc_trailer);
 
       /* WRITE DOCUMENT HEADER (and free its plOutbuf) */
-      _write_string (_plotter->data, doc_header->base); 
+      _write_string (_plotter->data, doc_header->base);
       _delete_outbuf (doc_header);
 
       /* now loop through pages, emitting each in turn */
       if (num_pages > 0)
 	{
-	  for (current_page = _plotter->data->first_page, n=1; 
-	       current_page; 
+	  for (current_page = _plotter->data->first_page, n=1;
+	       current_page;
 	       current_page = current_page->next, n++)
 	    {
 	      plOutbuf *page_header, *page_trailer;
 
-	      /* prepare page header, and store it in a plOutbuf */
+	      /* prepare page header and trailer, and store them in
+		 plOutbufs */
 	      page_header = _new_outbuf ();
-
-	      sprintf (page_header->point, "\
-%%%%Page: %d %d\n", n, n);
-	      _update_buffer (page_header);
-
-	      /* write out list of fonts needed by the page */
-	      {
-		bool first_font = true;
-
-		strcpy (page_header->point, "\
-%%PageResources: ");
-		_update_buffer (page_header);
-		for (i = 0; i < PL_NUM_PS_FONTS; i++)
-		  {
-		    if (current_page->ps_font_used[i])
-		      {
-			if (first_font == false)
-			  {
-			    strcpy (page_header->point, "%%+ ");
-			    _update_buffer (page_header);
-			  }
-			strcpy (page_header->point, "font ");
-			_update_buffer (page_header);
-			strcpy (page_header->point, _pl_g_ps_font_info[i].ps_name);
-			_update_buffer (page_header);
-			strcpy (page_header->point, "\n");
-			_update_buffer (page_header);
-			first_font = false;
-		      }
-		  }
-#ifdef USE_LJ_FONTS_IN_PS
-		for (i = 0; i < PL_NUM_PCL_FONTS; i++)
-		  {
-		    if (current_page->pcl_font_used[i])
-		      {
-			if (first_font == false)
-			  {
-			    strcpy (page_header->point, "%%+ ");
-			    _update_buffer (page_header);
-			  }
-			strcpy (page_header->point, "font ");
-			_update_buffer (page_header);
-			if (_pl_g_pcl_font_info[i].substitute_ps_name)
-			  /* this is to support the Tidbits-is-Wingdings botch */
-			  strcpy (page_header->point, _pl_g_pcl_font_info[i].substitute_ps_name);
-			else
-			  strcpy (page_header->point, _pl_g_pcl_font_info[i].ps_name);
-			_update_buffer (page_header);
-			strcpy (page_header->point, "\n");
-			_update_buffer (page_header);
-			first_font = false;
-		      }
-		  }
-#endif
-		if (first_font)	/* no fonts needed on page */
-		  {
-		    strcpy (page_header->point, "\n");
-		    _update_buffer (page_header);
-		  }
-	      }
-
-	      /* emit the bounding box for the page */
-	      _bbox_of_outbuf (current_page, &x_min, &x_max, &y_min, &y_max);
-	      if (x_min > x_max || y_min > y_max)
-		/* empty page */
-		sprintf (page_header->point, "\
-%%%%PageBoundingBox: 0 0 0 0\n");
-	      else
-		sprintf (page_header->point, "\
-%%%%PageBoundingBox: %d %d %d %d\n",
-			 IROUND(x_min - 0.5), IROUND(y_min - 0.5),
-			 IROUND(x_max + 0.5), IROUND(y_max + 0.5));
-	      _update_buffer (page_header);
-	      /* Page Setup */
-	      strcpy (page_header->point, "\
-%%BeginPageSetup\n");
-	      _update_buffer (page_header);
-	      /* emit initialization code (including idraw, PS directives) */
-	      /* N.B. `8' below is the version number of the idraw PS format
-		 we're producing; see <Unidraw/Components/psformat.h> */
-	      strcpy (page_header->point, "\
-%I Idraw 8\n\n\
-Begin\n\
-%I b u\n\
-%I cfg u\n\
-%I cbg u\n\
-%I f u\n\
-%I p u\n\
-%I t\n\
-[ 1 0 0 1 0 0 ] concat\n\
-/originalCTM matrix currentmatrix def\n\
-/trueoriginalCTM matrix currentmatrix def\n");
-	      _update_buffer (page_header);
-	      strcpy (page_header->point, "\
-%%EndPageSetup\n\n");
-	      _update_buffer (page_header);	  
-
-	      /* Page header is now prepared, and stored in a plOutbuf.  
-                 Do the same for the page trailer (much shorter). */
-
+	      _p_emit_page_header (page_header, current_page, n, false);
 	      page_trailer = _new_outbuf ();
-	      /* Page Trailer: includes `showpage' */
-	      strcpy (page_trailer->point, "\
-%%PageTrailer\n\
-End %I eop\n\
-showpage\n\n");
-	      _update_buffer (page_trailer);
-	      /* Page trailer is now ready */
+	      _p_emit_page_trailer (page_trailer);
 
 	      /* WRITE PS CODE FOR THIS PAGE, including header, trailer */
-	      _write_string (_plotter->data, page_header->base); 
+	      _write_string (_plotter->data, page_header->base);
 	      if (current_page->len > 0)
 		_write_string (_plotter->data, current_page->base);
 	      _write_string (_plotter->data, page_trailer->base);
@@ -735,23 +776,23 @@ showpage\n\n");
 	      _delete_outbuf (page_header);
 	    }
 	}
-      
+
       /* WRITE DOCUMENT TRAILER (and free its plOutbuf) */
-      _write_string (_plotter->data, doc_trailer->base); 
+      _write_string (_plotter->data, doc_trailer->base);
       _delete_outbuf (doc_trailer);
     }
-  
+
   /* delete all plOutbufs in which document pages are stored */
   current_page = _plotter->data->first_page;
   while (current_page)
     {
       plOutbuf *next_page;
-	  
+
       next_page = current_page->next;
       _delete_outbuf (current_page);
       current_page = next_page;
     }
-  
+
   /* flush output stream if any */
   if (_plotter->data->outfp)
     {
@@ -778,6 +819,49 @@ showpage\n\n");
 #endif
 }
 
+/* In streaming mode (see the PS_STREAMING parameter), this is invoked by
+   _pl_p_end_page() to prepare the header and trailer of the page that is
+   being closed, so that closepl() writes the page out and frees it at
+   once.  The header of the first page is preceded by the document header.
+   The page's bounding box and fonts are merged into those of the
+   document, which _pl_p_terminate() emits in the document trailer. */
+
+void
+_pl_p_stream_page (S___(Plotter *_plotter))
+{
+  plOutbuf *page = _plotter->data->page;
+  double x_min, x_max, y_min, y_max;
+  int i;
+
+  page->header = _new_outbuf ();
+  if (_plotter->data->page_number == 1)
+    _p_emit_doc_header (page->header, 1, true, 0.0, 0.0, 0.0, 0.0,
+			page->ps_font_used, page->pcl_font_used);
+  _p_emit_page_header (page->header, page, _plotter->data->page_number,
+		       true);
+  page->trailer = _new_outbuf ();
+  _p_emit_page_trailer (page->trailer);
+
+  /* merge page's bounding box and fonts into those of the document */
+  _bbox_of_outbuf (page, &x_min, &x_max, &y_min, &y_max);
+  if (!(x_max < x_min || y_max < y_min))
+    /* nonempty page */
+    {
+      if (x_max > _plotter->ps_doc_xmax) _plotter->ps_doc_xmax = x_max;
+      if (y_max > _plotter->ps_doc_ymax) _plotter->ps_doc_ymax = y_max;
+      if (x_min < _plotter->ps_doc_xmin) _plotter->ps_doc_xmin = x_min;
+      if (y_min < _plotter->ps_doc_ymin) _plotter->ps_doc_ymin = y_min;
+    }
+  for (i = 0; i < PL_NUM_PS_FONTS; i++)
+    if (page->ps_font_used[i])
+      _plotter->ps_font_used_in_doc[i] = true;
+#ifdef USE_LJ_FONTS_IN_PS
+  for (i = 0; i < PL_NUM_PCL_FONTS; i++)
+    if (page->pcl_font_used[i])
+      _plotter->pcl_font_used_in_doc[i] = true;
+#endif
+}
+
 #ifdef LIBPLOTTER
 PSPlotter::PSPlotter (FILE *infile, FILE *outfile, FILE *errfile)
 	:Plotter (infile, outfile, errfile)
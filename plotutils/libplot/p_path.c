@@ -91,8 +91,8 @@ _pl_p_paint_path (S___(Plotter *_plotter))
 	  break;
 
 	if ((_plotter->drawstate->path->num_segments >= 3)/*check for closure*/
-	    && (_plotter->drawstate->path->segments[_plotter->drawstate->path->num_segments - 1].p.x == _plotter->drawstate->path->segments[0].p.x)
-	    && (_plotter->drawstate->path->segments[_plotter->drawstate->path->num_segments - 1].p.y == _plotter->drawstate->path->segments[0].p.y))
+	    && (_plotter->drawstate->path->points[_plotter->drawstate->path->num_segments - 1].x == _plotter->drawstate->path->points[0].x)
+	    && (_plotter->drawstate->path->points[_plotter->drawstate->path->num_segments - 1].y == _plotter->drawstate->path->points[0].y))
 	  closed = true;
 	else
 	  closed = false;		/* 2-point ones should be open */
@@ -107,7 +107,7 @@ _pl_p_paint_path (S___(Plotter *_plotter))
 	    plPoint datapoint;
 	    int x_int, y_int;
 	    
-	    datapoint = _plotter->drawstate->path->segments[i].p;
+	    datapoint = _plotter->drawstate->path->points[i];
 	    x_int = IROUND(granularity * datapoint.x);
 	    y_int = IROUND(granularity * datapoint.y);
 	    
@@ -185,15 +185,17 @@ _pl_p_paint_path (S___(Plotter *_plotter))
 	    index_start = 0;
 	    index_increment = 1;
 	  }
+	/* room for the points, each "%d %d\n" */
+	_reserve_outbuf (_plotter->data->page, (unsigned long)numpoints * 24);
 	for (i = index_start; 
 	     i >= 0 && i <= numpoints - 1; 
 	     i += index_increment)
 	  {
 	    /* output the data point */
-	    sprintf (_plotter->data->page->point, "\
-%d %d\n",
-		     xarray[i].x, xarray[i].y);
-	    _update_buffer (_plotter->data->page);
+	    _append_integer (_plotter->data->page, xarray[i].x);
+	    _append_to_outbuf (_plotter->data->page, " ", 1);
+	    _append_integer (_plotter->data->page, xarray[i].y);
+	    _append_to_outbuf (_plotter->data->page, "\n", 1);
 	  }
 	
 	if (closed_int)
@@ -239,10 +241,10 @@ End\n\n", numpoints);
 		
 		j = (i == 0 ? 1 : numpoints - 2);
 		_set_line_end_bbox (_plotter->data->page,
-				    _plotter->drawstate->path->segments[i].p.x,
-				    _plotter->drawstate->path->segments[i].p.y,
-				    _plotter->drawstate->path->segments[j].p.x,
-				    _plotter->drawstate->path->segments[j].p.y,
+				    _plotter->drawstate->path->points[i].x,
+				    _plotter->drawstate->path->points[i].y,
+				    _plotter->drawstate->path->points[j].x,
+				    _plotter->drawstate->path->points[j].y,
 				    _plotter->drawstate->line_width,
 				    _plotter->drawstate->cap_type,
 				    _plotter->drawstate->transform.m);
@@ -265,12 +267,12 @@ End\n\n", numpoints);
 		    c = i + 1;
 		  }
 		_set_line_join_bbox(_plotter->data->page,
-				    _plotter->drawstate->path->segments[a].p.x,
-				    _plotter->drawstate->path->segments[a].p.y,
-				    _plotter->drawstate->path->segments[b].p.x,
-				    _plotter->drawstate->path->segments[b].p.y,
-				    _plotter->drawstate->path->segments[c].p.x,
-				    _plotter->drawstate->path->segments[c].p.y,
+				    _plotter->drawstate->path->points[a].x,
+				    _plotter->drawstate->path->points[a].y,
+				    _plotter->drawstate->path->points[b].x,
+				    _plotter->drawstate->path->points[b].y,
+				    _plotter->drawstate->path->points[c].x,
+				    _plotter->drawstate->path->points[c].y,
 				    _plotter->drawstate->line_width,
 				    _plotter->drawstate->join_type,
 				    _plotter->drawstate->miter_limit,
@@ -763,3 +765,91 @@ _pl_p_paint_paths (S___(Plotter *_plotter))
 {
   return false;
 }
+
+/* The PSPlotter-specific version of the paint_image method.  The image is
+   emitted as hexadecimal data for the `image' operator (if it contains
+   only shades of gray) or the `colorimage' operator, with a CTM that maps
+   the unit square onto the image's box in the device frame. */
+
+/* number of image bytes per line of hexadecimal data */
+#define PS_IMAGE_BYTES_PER_LINE 36
+
+bool
+_pl_p_paint_image (R___(Plotter *_plotter) double x0, double y0, double x1, double y1, int width, int height, const unsigned char *rgb)
+{
+  static const char hexdigits[] = "0123456789abcdef";
+  plOutbuf *page = _plotter->data->page;
+  double local[6], m[6];
+  long num_pixels, num_bytes, i;
+  bool gray = true;
+  int k;
+
+  num_pixels = (long)width * (long)height;
+  for (i = 0; i < num_pixels; i++)
+    if (rgb[3 * i] != rgb[3 * i + 1] || rgb[3 * i] != rgb[3 * i + 2])
+      {
+	gray = false;
+	break;
+      }
+
+  /* map from unit square to device frame */
+  local[0] = x1 - x0;
+  local[1] = 0.0;
+  local[2] = 0.0;
+  local[3] = y1 - y0;
+  local[4] = x0;
+  local[5] = y0;
+  _matrix_product (local, _plotter->drawstate->transform.m, m);
+
+  strcpy (page->point, "Begin\n[");
+  _update_buffer (page);
+  for (k = 0; k < 6; k++)
+    {
+      sprintf (page->point, "%.7g ", m[k]);
+      _update_buffer (page);
+    }
+  sprintf (page->point, "\
+] concat\n\
+/picstr %d string def\n\
+%d %d 8 [%d 0 0 %d neg 0 %d]\n\
+{ currentfile picstr readhexstring pop }\n%s",
+	   gray ? width : 3 * width,
+	   width, height, width, height, height,
+	   gray ? "image\n" : "false 3 colorimage\n");
+  _update_buffer (page);
+
+  /* emit image data, one byte per pixel if gray, otherwise three */
+  num_bytes = gray ? num_pixels : 3 * num_pixels;
+  for (i = 0; i < num_bytes; i += PS_IMAGE_BYTES_PER_LINE)
+    {
+      long j, end = i + PS_IMAGE_BYTES_PER_LINE;
+      char *s = page->point;
+
+      if (end > num_bytes)
+	end = num_bytes;
+      for (j = i; j < end; j++)
+	{
+	  unsigned char c = gray ? rgb[3 * j] : rgb[j];
+
+	  *s++ = hexdigits[c >> 4];
+	  *s++ = hexdigits[c & 0xf];
+	}
+      *s++ = '\n';
+      *s = '\0';
+      _update_buffer (page);
+    }
+
+  strcpy (page->point, "End\n");
+  _update_buffer (page);
+
+  /* update bounding box */
+  for (k = 0; k < 4; k++)
+    {
+      double u = (k & 1) ? 1.0 : 0.0;
+      double v = (k & 2) ? 1.0 : 0.0;
+
+      _update_bbox (page, m[4] + u * m[0] + v * m[2], m[5] + u * m[1] + v * m[3]);
+    }
+
+  return true;
+}
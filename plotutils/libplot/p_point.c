@@ -47,3 +47,85 @@ _pl_p_paint_point (S___(Plotter *_plotter))
 	}
     }
 }
+
+/* The PSPlotter-specific version of the paint_markers method, which draws
+   n identical marker symbols.  The PS code for the first marker is
+   wrapped in a procedure that takes a translation (in device coordinates)
+   as argument, and every marker is drawn by invoking the procedure.  The
+   page's bounding box is updated with translated copies of the first
+   marker's bounding box.
+
+   The output remains valid PostScript, but idraw can't edit it: the
+   marker's idraw object sits inside the procedure, and the invocations
+   are not idraw objects.  Each of them is still drawn, and printed,
+   correctly. */
+
+bool
+_pl_p_paint_markers (R___(Plotter *_plotter) const double *x, const double *y, int n, int type, double size)
+{
+  plOutbuf *page = _plotter->data->page;
+  double saved_xmin, saved_xmax, saved_ymin, saved_ymax;
+  double marker_xmin, marker_xmax, marker_ymin, marker_ymax;
+  double x0, y0;
+  unsigned long id;
+  int i;
+
+  if (n < 2)
+    return false;		/* not worth it */
+
+  x0 = XD(x[0], y[0]);
+  y0 = YD(x[0], y[0]);
+  if (!(x0 == x0 && y0 == y0))
+    return false;
+
+  /* name the procedure after the current offset in the page, so that
+     each batch of markers gets a distinct name */
+  id = page->contents;
+  sprintf (page->point, "/PLm%lu {\ngsave\ntranslate\n", id);
+  _update_buffer (page);
+
+  /* draw the first marker, collecting its bounding box separately */
+  saved_xmin = page->xrange_min;
+  saved_xmax = page->xrange_max;
+  saved_ymin = page->yrange_min;
+  saved_ymax = page->yrange_max;
+  page->xrange_min = DBL_MAX;
+  page->xrange_max = -(DBL_MAX);
+  page->yrange_min = DBL_MAX;
+  page->yrange_max = -(DBL_MAX);
+
+  _API_fmarker (R___(_plotter) x[0], y[0], type, size);
+
+  marker_xmin = page->xrange_min;
+  marker_xmax = page->xrange_max;
+  marker_ymin = page->yrange_min;
+  marker_ymax = page->yrange_max;
+  page->xrange_min = saved_xmin;
+  page->xrange_max = saved_xmax;
+  page->yrange_min = saved_ymin;
+  page->yrange_max = saved_ymax;
+
+  strcpy (page->point, "grestore\n} bind def\n");
+  _update_buffer (page);
+
+  for (i = 0; i < n; i++)
+    {
+      double dx, dy;
+
+      dx = XD(x[i], y[i]) - x0;
+      dy = YD(x[i], y[i]) - y0;
+      if (!(dx == dx && dy == dy))
+	continue;
+
+      sprintf (page->point, "%.7g %.7g PLm%lu\n", dx, dy, id);
+      _update_buffer (page);
+
+      if (marker_xmin <= marker_xmax)
+	{
+	  _update_bbox (page, marker_xmin + dx, marker_ymin + dy);
+	  _update_bbox (page, marker_xmax + dx, marker_ymax + dy);
+	}
+    }
+
+  return true;
+}
@@ -25,6 +25,10 @@
 #include "sys-defines.h"
 #include "extern.h"
 
+/* number of decimal places kept in device coordinates, if SVG_RELATIVE is
+   set but SVG_DECIMALS is not; i.e. 1/10000 of the page size */
+#define SVG_DEFAULT_DECIMALS 4
+
 #ifndef LIBPLOTTER
 /* In libplot, this is the initialization for the function-pointer part of
    a SVGPlotter struct. */
@@ -39,7 +43,9 @@ const Plotter _pl_s_default_plotter =
   /* internal path-painting methods (endpath() is a wrapper for the first) */
   _pl_s_paint_path, _pl_s_paint_paths, _pl_g_path_is_flushable, _pl_g_maybe_prepaint_segments,
   /* internal methods for drawing of markers and points */
-  _pl_g_paint_marker, _pl_s_paint_point,
+  _pl_g_paint_marker, _pl_s_paint_markers, _pl_s_paint_point,
+  /* internal methods for drawing and reading of raster images */
+  _pl_s_paint_image, _pl_g_read_image,
   /* internal methods that plot strings in Hershey, non-Hershey fonts */
   _pl_g_paint_text_string_with_escapes, _pl_s_paint_text_string,
   _pl_g_get_text_width,
@@ -144,6 +150,42 @@ _pl_s_initialize (S___(Plotter *_plotter))
   _plotter->s_bgcolor.green = -1;
   _plotter->s_bgcolor.blue = -1;
   _plotter->s_bgcolor_suppressed = false;
+  _plotter->s_decimals = -1;
+  _plotter->s_relative = false;
+  _plotter->s_merge_paths = false;
+  _plotter->s_path_mergeable = false;
+  _plotter->s_path_start = 0;
+  _plotter->s_path_data_start = 0;
+  _plotter->s_path_data_end = 0;
+  _plotter->s_path_end = 0;
+
+  /* compact path data?  SVG_DECIMALS is the number of decimal places to
+     which coordinates are rounded in device space (in which the page is
+     the unit square), SVG_RELATIVE requests relative moves, and
+     SVG_MERGE_PATHS the merging of consecutive line paths that are drawn
+     in the same style */
+  {
+    const char *decimals_s, *relative_s, *merge_s;
+    int decimals;
+
+    decimals_s = (const char *)_get_plot_param (_plotter->data, "SVG_DECIMALS");
+    if (strcasecmp (decimals_s, "none") != 0
+	&& sscanf (decimals_s, "%d", &decimals) == 1 && decimals >= 0)
+      _plotter->s_decimals = IMIN(decimals, 9);
+
+    relative_s = (const char *)_get_plot_param (_plotter->data, "SVG_RELATIVE");
+    if (strcasecmp (relative_s, "yes") == 0)
+      {
+	_plotter->s_relative = true;
+	/* relative moves are computed from rounded coordinates */
+	if (_plotter->s_decimals < 0)
+	  _plotter->s_decimals = SVG_DEFAULT_DECIMALS;
+      }
+
+    merge_s = (const char *)_get_plot_param (_plotter->data, "SVG_MERGE_PATHS");
+    if (strcasecmp (merge_s, "yes") == 0)
+      _plotter->s_merge_paths = true;
+  }
 
   /* Note: xmin,xmax,ymin,ymax determine the range of device coordinates
      over which the viewport will extend (and hence the transformation from
@@ -191,6 +233,10 @@ _pl_s_initialize (S___(Plotter *_plotter))
 void
 _pl_s_terminate (S___(Plotter *_plotter))
 {
+#ifndef LIBPLOTTER
+  /* in libplot, manually invoke superclass termination method */
+  _pl_g_terminate (S___(_plotter));
+#endif
 }
 
 #ifdef LIBPLOTTER
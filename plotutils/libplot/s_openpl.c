@@ -37,5 +37,8 @@ _pl_s_begin_page (S___(Plotter *_plotter))
   _plotter->s_bgcolor = _plotter->drawstate->bgcolor;
   _plotter->s_bgcolor_suppressed = _plotter->drawstate->bgcolor_suppressed;
 
+  /* nothing on the page to merge a path into */
+  _plotter->s_path_mergeable = false;
+
   return true;
 }
@@ -24,8 +24,14 @@
    path in terms of SVG shapes:
    path/rect/circle/ellipse/line/polyline/polygon. */
 
+/* This file also contains the paint_image() method, which renders a raster
+   image as an SVG <image> element containing an embedded PNG. */
+
 #include "sys-defines.h"
 #include "extern.h"
+#ifdef INCLUDE_PNG_SUPPORT
+#include <png.h>
+#endif
 
 /* SVG join styles, i.e., stroke-linejoin attribute, indexed by internal
    number (miter/rd./bevel/triangular) */
@@ -44,8 +50,14 @@ static const char * const svg_fill_style[PL_NUM_FILL_RULES] =
 
 static const double identity_matrix[6] = { 1.0, 0.0, 0.0, 1.0, 0.0, 0.0 };
 
+/* upper bound on the length of an "x,y " pair, as written with "%.5g",
+   e.g. "-1.2346e+100,-1.2346e+100 "; used to reserve room for a path */
+#define SVG_MAX_POINT_LEN 26
+
 /* forward references */
 static void write_svg_path_data (plOutbuf *page, const plPath *path);
+static void write_svg_line_data (plOutbuf *page, const plPath *path, int decimals, bool relative);
+static void write_svg_points (plOutbuf *page, const plPath *path, int npoints, int decimals);
 static void write_svg_path_style (plOutbuf *page, const plDrawState *drawstate, bool need_cap, bool need_join);
 
 void
@@ -55,8 +67,8 @@ _pl_s_paint_path (S___(Plotter *_plotter))
     {
     case (int)PATH_SEGMENT_LIST:
       {
-	bool closed, lines_only;
-	int i;
+	bool closed, lines_only, mergeable;
+	int i, decimals;
 
 	/* sanity checks */
 	if (_plotter->drawstate->path->num_segments == 0)/* nothing to do */
@@ -65,8 +77,8 @@ _pl_s_paint_path (S___(Plotter *_plotter))
 	  break;
 
 	if ((_plotter->drawstate->path->num_segments >= 3)/*check for closure*/
-	    && (_plotter->drawstate->path->segments[_plotter->drawstate->path->num_segments - 1].p.x == _plotter->drawstate->path->segments[0].p.x)
-	    && (_plotter->drawstate->path->segments[_plotter->drawstate->path->num_segments - 1].p.y == _plotter->drawstate->path->segments[0].p.y))
+	    && (_plotter->drawstate->path->points[_plotter->drawstate->path->num_segments - 1].x == _plotter->drawstate->path->points[0].x)
+	    && (_plotter->drawstate->path->points[_plotter->drawstate->path->num_segments - 1].y == _plotter->drawstate->path->points[0].y))
 	  closed = true;
 	else
 	  closed = false;		/* 2-point ones should be open */
@@ -79,7 +91,7 @@ _pl_s_paint_path (S___(Plotter *_plotter))
 	  {
 	    plPathSegmentType element_type;
 	    
-	    element_type = _plotter->drawstate->path->segments[i].type;
+	    element_type = (plPathSegmentType)_plotter->drawstate->path->types[i];
 	    if (element_type != S_LINE)
 	      {
 		lines_only = false;
@@ -87,21 +99,103 @@ _pl_s_paint_path (S___(Plotter *_plotter))
 	      }
 	  }
 	
-	if (lines_only && _plotter->drawstate->path->num_segments == 2)
+	/* compact output?  (see the SVG_DECIMALS, SVG_RELATIVE and
+	   SVG_MERGE_PATHS parameters) */
+	decimals = _svg_frame_decimals (_plotter->drawstate->transform.m_user_to_ndc,
+					_plotter->s_decimals);
+	mergeable = (lines_only
+		     && _plotter->s_merge_paths
+		     && _plotter->drawstate->pen_type != 0
+		     && _plotter->drawstate->fill_type == 0
+		     && _plotter->drawstate->dash_array_in_effect == false
+		     && _plotter->drawstate->line_type == PL_L_SOLID);
+
+	if (lines_only && (_plotter->s_relative || mergeable))
+	  /* SVG path, with compact path data */
+	  {
+	    plOutbuf *page = _plotter->data->page;
+	    unsigned long start, data_start, data_end, end;
+
+	    start = page->contents;
+	    sprintf (page->point, "<path ");
+	    _update_buffer (page);
+
+	    _pl_s_set_matrix (R___(_plotter) identity_matrix); 
+
+	    sprintf (page->point, "d=\"");
+	    _update_buffer (page);
+	    data_start = page->contents;
+	    write_svg_line_data (page, _plotter->drawstate->path,
+				 decimals, _plotter->s_relative);
+	    data_end = page->contents;
+	    sprintf (page->point, "\" ");
+	    _update_buffer (page);
+
+	    write_svg_path_style (page, _plotter->drawstate, true, true);
+
+	    sprintf (page->point, "/>\n");
+	    _update_buffer (page);
+	    end = page->contents;
+
+	    if (mergeable
+		&& _plotter->s_path_mergeable
+		&& _plotter->s_path_end == start
+		&& (_plotter->s_path_data_start - _plotter->s_path_start
+		    == data_start - start)
+		&& (_plotter->s_path_end - _plotter->s_path_data_end
+		    == end - data_end)
+		&& memcmp (page->base + _plotter->s_path_start, 
+			   page->base + start, data_start - start) == 0
+		&& memcmp (page->base + _plotter->s_path_data_end, 
+			   page->base + data_end, end - data_end) == 0)
+	      /* preceding element is a <path> with the same attributes, so
+		 move our path data into it, as further subpaths (each
+		 begins with a moveto), and drop the rest */
+	      {
+		unsigned long data_len = data_end - data_start;
+		unsigned long merged_data_end;
+
+		merged_data_end = _plotter->s_path_data_end + data_len;
+		memmove (page->base + _plotter->s_path_data_end,
+			 page->base + data_start, data_len);
+		memmove (page->base + merged_data_end,
+			 page->base + data_end, end - data_end);
+		page->contents = merged_data_end + (end - data_end);
+		page->point = page->base + page->contents;
+		*(page->point) = '\0';
+		_plotter->s_path_data_end = merged_data_end;
+		_plotter->s_path_end = page->contents;
+	      }
+	    else
+	      {
+		_plotter->s_path_start = start;
+		_plotter->s_path_data_start = data_start;
+		_plotter->s_path_data_end = data_end;
+		_plotter->s_path_end = end;
+	      }
+	    _plotter->s_path_mergeable = mergeable;
+	  }
+
+	else if (lines_only && _plotter->drawstate->path->num_segments == 2)
 	  /* SVG line */
 	  {
-	    sprintf (_plotter->data->page->point, "<line ");
-	    _update_buffer (_plotter->data->page);
+	    plOutbuf *page = _plotter->data->page;
+	    const plPath *path = _plotter->drawstate->path;
+
+	    sprintf (page->point, "<line ");
+	    _update_buffer (page);
 
 	    _pl_s_set_matrix (R___(_plotter) identity_matrix); 
 
-	    sprintf (_plotter->data->page->point,
-		     "x1=\"%.5g\" y1=\"%.5g\" x2=\"%.5g\" y2=\"%.5g\" ",
-		     _plotter->drawstate->path->segments[0].p.x,
-		     _plotter->drawstate->path->segments[0].p.y,
-		     _plotter->drawstate->path->segments[1].p.x,
-		     _plotter->drawstate->path->segments[1].p.y);
-	    _update_buffer (_plotter->data->page);
+	    _append_string (page, "x1=\"");
+	    _write_svg_number (page, path->points[0].x, decimals);
+	    _append_string (page, "\" y1=\"");
+	    _write_svg_number (page, path->points[0].y, decimals);
+	    _append_string (page, "\" x2=\"");
+	    _write_svg_number (page, path->points[1].x, decimals);
+	    _append_string (page, "\" y2=\"");
+	    _write_svg_number (page, path->points[1].y, decimals);
+	    _append_string (page, "\" ");
 
 	    write_svg_path_style (_plotter->data->page, _plotter->drawstate, 
 				   true, false);
@@ -121,16 +215,10 @@ _pl_s_paint_path (S___(Plotter *_plotter))
 	    sprintf (_plotter->data->page->point,
 		     "points=\"");
 	    _update_buffer (_plotter->data->page);
-	    for (i = 0; i < _plotter->drawstate->path->num_segments; i++)
-	      {
-		plPoint p;
-
-		p = _plotter->drawstate->path->segments[i].p;
-		sprintf (_plotter->data->page->point,
-			 "%.5g,%.5g ",
-			 p.x, p.y);
-		_update_buffer (_plotter->data->page);
-	      }
+	    write_svg_points (_plotter->data->page,
+			      _plotter->drawstate->path,
+			      _plotter->drawstate->path->num_segments,
+			      decimals);
 	    sprintf (_plotter->data->page->point,
 		     "\" ");
 	    _update_buffer (_plotter->data->page);
@@ -154,16 +242,10 @@ _pl_s_paint_path (S___(Plotter *_plotter))
 	    sprintf (_plotter->data->page->point,
 		     "points=\"");
 	    _update_buffer (_plotter->data->page);
-	    for (i = 0; i < _plotter->drawstate->path->num_segments - 1; i++)
-	      {
-		plPoint p;
-
-		p = _plotter->drawstate->path->segments[i].p;
-		sprintf (_plotter->data->page->point,
-			 "%.5g,%.5g ",
-			 p.x, p.y);
-		_update_buffer (_plotter->data->page);
-	      }
+	    write_svg_points (_plotter->data->page,
+			      _plotter->drawstate->path,
+			      _plotter->drawstate->path->num_segments - 1,
+			      decimals);
 	    sprintf (_plotter->data->page->point,
 		     "\" ");
 	    _update_buffer (_plotter->data->page);
@@ -471,16 +553,21 @@ write_svg_path_data (plOutbuf *page, const plPath *path)
     return;
 
   if ((path->num_segments >= 3)	/* check for closure */
-      && (path->segments[path->num_segments - 1].p.x == path->segments[0].p.x)
-      && (path->segments[path->num_segments - 1].p.y == path->segments[0].p.y))
+      && (path->points[path->num_segments - 1].x == path->points[0].x)
+      && (path->points[path->num_segments - 1].y == path->points[0].y))
     closed = true;
   else
     closed = false;		/* 2-point ones should be open */
 	
-  p = path->segments[0].p;	/* initial seg should be a moveto */
-  sprintf (page->point, "M%.5g,%.5g ",
-	   p.x, p.y);
-  _update_buffer (page);
+  /* room for the line segments, at most 2 numbers each */
+  _reserve_outbuf (page, (unsigned long)path->num_segments * SVG_MAX_POINT_LEN);
+
+  p = path->points[0];	/* initial seg should be a moveto */
+  _append_to_outbuf (page, "M", 1);
+  _append_double (page, p.x, 5);
+  _append_to_outbuf (page, ",", 1);
+  _append_double (page, p.y, 5);
+  _append_to_outbuf (page, " ", 1);
   
   oldpoint = p;
   for (i = 1; i < path->num_segments; i++)
@@ -488,10 +575,8 @@ write_svg_path_data (plOutbuf *page, const plPath *path)
       plPathSegmentType type;
       plPoint pc, pd;
       
-      type = path->segments[i].type;
-      p = path->segments[i].p;
-      pc = path->segments[i].pc;
-      pd = path->segments[i].pd;
+      type = (plPathSegmentType)path->types[i];
+      p = path->points[i];
       
       if (closed
 	  && i == path->num_segments - 1
@@ -502,14 +587,23 @@ write_svg_path_data (plOutbuf *page, const plPath *path)
 	{
 	case (int)S_LINE:
 	  if (p.y == oldpoint.y)
-	    sprintf (page->point, "H%.5g ",
-		     p.x);
+	    {
+	      _append_to_outbuf (page, "H", 1);
+	      _append_double (page, p.x, 5);
+	    }
 	  else if (p.x == oldpoint.x)
-	    sprintf (page->point, "V%.5g ",
-		     p.y);
+	    {
+	      _append_to_outbuf (page, "V", 1);
+	      _append_double (page, p.y, 5);
+	    }
 	  else
-	    sprintf (page->point, "L%.5g,%.5g ",
-		     p.x, p.y);
+	    {
+	      _append_to_outbuf (page, "L", 1);
+	      _append_double (page, p.x, 5);
+	      _append_to_outbuf (page, ",", 1);
+	      _append_double (page, p.y, 5);
+	    }
+	  _append_to_outbuf (page, " ", 1);
 	  break;
 	  
 	case (int)S_ARC:
@@ -517,6 +611,8 @@ write_svg_path_data (plOutbuf *page, const plPath *path)
 	    double radius;
 	    double angle;
 	    
+	    pc = path->controls[i].pc;
+
 	    /* compute angle in radians, range -pi..pi */
 	    angle = _angle_of_arc (oldpoint, p, pc);
 	    
@@ -537,6 +633,8 @@ write_svg_path_data (plOutbuf *page, const plPath *path)
 	    plVector u, v, semi_axis_1, semi_axis_2;
 	    bool clockwise;
 
+	    pc = path->controls[i].pc;
+
 	    /* conjugate radial vectors for the quarter-ellipse */
 	    u.x = oldpoint.x - pc.x;
 	    u.y = oldpoint.y - pc.y;
@@ -585,11 +683,14 @@ write_svg_path_data (plOutbuf *page, const plPath *path)
 	  break;
 	  
 	case (int)S_QUAD:
+	  pc = path->controls[i].pc;
 	  sprintf (page->point, "Q%.5g,%.5g,%.5g,%.5g ",
 		   pc.x, pc.y, p.x, p.y);
 	  break;
 	  
 	case (int)S_CUBIC:
+	  pc = path->controls[i].pc;
+	  pd = path->controls[i].pd;
 	  sprintf (page->point, "C%.5g,%.5g,%.5g,%.5g,%.5g,%.5g ",
 		   pc.x, pc.y, pd.x, pd.y, p.x, p.y);
 	  break;
@@ -609,6 +710,152 @@ write_svg_path_data (plOutbuf *page, const plPath *path)
     }
 }
 
+/* Write an SVG path data string for a libplot segment-list path that
+   contains only line segments, in compact form.  Each coordinate is
+   rounded to `decimals' decimal places (or if `decimals' is negative,
+   written with "%.5g"), and a command letter is omitted when it repeats
+   the previous one.  If `relative' is set, which requires rounding, each
+   vertex after the first is given relative to its predecessor; the
+   offsets are differences of rounded coordinates, so rounding errors do
+   not accumulate along the path. */
+
+static void
+write_svg_line_data (plOutbuf *page, const plPath *path, int decimals, bool relative)
+{
+  bool closed;
+  char command, last_command = '\0';
+  double scale, x, y, oldx = 0.0, oldy = 0.0;
+  int i, npoints;
+
+  if ((path->num_segments >= 3)	/* check for closure */
+      && (path->points[path->num_segments - 1].x == path->points[0].x)
+      && (path->points[path->num_segments - 1].y == path->points[0].y))
+    closed = true;
+  else
+    closed = false;		/* 2-point ones should be open */
+  npoints = (closed ? path->num_segments - 1 : path->num_segments);
+
+  if (decimals < 0)
+    relative = false;
+  scale = (decimals >= 0 ? pow (10.0, (double)decimals) : 1.0);
+
+  _reserve_outbuf (page, (unsigned long)npoints * SVG_MAX_POINT_LEN + 1);
+  for (i = 0; i < npoints; i++)
+    {
+      x = path->points[i].x;
+      y = path->points[i].y;
+      if (decimals >= 0)
+	/* in units of the last decimal place */
+	{
+	  x = floor (x * scale + 0.5);
+	  y = floor (y * scale + 0.5);
+	}
+
+      if (i == 0)		/* initial seg should be a moveto */
+	command = 'M';
+      else if (y == oldy)
+	command = (relative ? 'h' : 'H');
+      else if (x == oldx)
+	command = (relative ? 'v' : 'V');
+      else
+	command = (relative ? 'l' : 'L');
+
+      if (command != last_command)
+	_append_to_outbuf (page, &command, 1);
+      else
+	_append_to_outbuf (page, " ", 1);
+
+      switch (command)
+	{
+	case 'M':
+	case 'L':
+	  _write_svg_number (page, x / scale, decimals);
+	  _append_to_outbuf (page, ",", 1);
+	  _write_svg_number (page, y / scale, decimals);
+	  break;
+	case 'H':
+	  _write_svg_number (page, x / scale, decimals);
+	  break;
+	case 'V':
+	  _write_svg_number (page, y / scale, decimals);
+	  break;
+	case 'l':
+	  _write_svg_number (page, (x - oldx) / scale, decimals);
+	  _append_to_outbuf (page, ",", 1);
+	  _write_svg_number (page, (y - oldy) / scale, decimals);
+	  break;
+	case 'h':
+	  _write_svg_number (page, (x - oldx) / scale, decimals);
+	  break;
+	case 'v':
+	  _write_svg_number (page, (y - oldy) / scale, decimals);
+	  break;
+	}
+
+      last_command = command;
+      oldx = x;
+      oldy = y;
+    }
+
+  if (closed)
+    _append_to_outbuf (page, "Z", 1);
+}
+
+/* write the first `npoints' vertices of a path, as the value of the
+   `points' attribute of a <polyline> or <polygon> */
+static void
+write_svg_points (plOutbuf *page, const plPath *path, int npoints, int decimals)
+{
+  int i;
+
+  _reserve_outbuf (page, (unsigned long)npoints * SVG_MAX_POINT_LEN);
+  for (i = 0; i < npoints; i++)
+    {
+      plPoint p;
+
+      p = path->points[i];
+      _write_svg_number (page, p.x, decimals);
+      _append_to_outbuf (page, ",", 1);
+      _write_svg_number (page, p.y, decimals);
+      _append_to_outbuf (page, " ", 1);
+    }
+}
+
+/* write a coordinate, rounded to `decimals' decimal places, or if
+   `decimals' is negative, with "%.5g" */
+void
+_write_svg_number (plOutbuf *page, double x, int decimals)
+{
+  if (decimals >= 0)
+    _append_fixed (page, x, decimals);
+  else
+    _append_double (page, x, 5);
+}
+
+/* Number of decimal places to which coordinates in the frame mapped to
+   device space (in which the page is the unit square) by the matrix m
+   should be rounded, so that the rounding error in device space is at
+   most half a unit in the `device_decimals'th place; -1 if coordinates
+   should not be rounded.  A rounding error in the frame is magnified by
+   at most the largest singular value of m. */
+
+int
+_svg_frame_decimals (const double m[6], int device_decimals)
+{
+  double min_sing_val, max_sing_val;
+  int decimals;
+
+  if (device_decimals < 0)
+    return -1;
+
+  _matrix_sing_vals (m, &min_sing_val, &max_sing_val);
+  if (max_sing_val <= 0.0)
+    return device_decimals;
+
+  decimals = (int)ceil (device_decimals + log10 (max_sing_val) - 1e-9);
+  return IMAX(0, IMIN(decimals, 9));
+}
+
 static void
 write_svg_path_style (plOutbuf *page, const plDrawState *drawstate, bool need_cap, bool need_join)
 {
@@ -759,3 +1006,150 @@ write_svg_path_style (plOutbuf *page, const plDrawState *drawstate, bool need_ca
 	}
     }
 }
+
+/* The SVGPlotter-specific version of the paint_image method.  The image is
+   encoded in PNG format and embedded as a `data:' URI in an <image>
+   element.  Without libpng, it returns `false', so that image() draws
+   each pixel as a box. */
+
+#ifdef INCLUDE_PNG_SUPPORT
+
+/* number of PNG bytes per chunk of base64 data written to the page */
+#define SVG_IMAGE_BYTES_PER_CHUNK 1500
+
+typedef struct
+{
+  unsigned char *data;
+  unsigned long len, size;
+} plMemoryPNG;
+
+static void
+_svg_png_write_fn (png_struct *png_ptr, png_byte *data, png_size_t length)
+{
+  plMemoryPNG *buf = (plMemoryPNG *)png_get_io_ptr (png_ptr);
+
+  if (buf->len + length > buf->size)
+    {
+      while (buf->len + length > buf->size)
+	buf->size *= 2;
+      buf->data = (unsigned char *)_pl_xrealloc (buf->data, buf->size);
+    }
+  memcpy (buf->data + buf->len, data, length);
+  buf->len += length;
+}
+
+static void
+_svg_png_flush_fn (png_struct *png_ptr)
+{
+}
+
+bool
+_pl_s_paint_image (R___(Plotter *_plotter) double x0, double y0, double x1, double y1, int width, int height, const unsigned char *rgb)
+{
+  static const char base64digits[] = 
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  plOutbuf *page = _plotter->data->page;
+  png_struct *png_ptr;
+  png_info *info_ptr;
+  plMemoryPNG buf;
+  double local[6];
+  unsigned long i;
+  int j;
+
+  png_ptr = png_create_write_struct (PNG_LIBPNG_VER_STRING, 
+				     (void *)NULL, NULL, NULL);
+  if (png_ptr == (png_struct *)NULL)
+    return false;
+  info_ptr = png_create_info_struct (png_ptr);
+  if (info_ptr == (png_info *)NULL)
+    {
+      png_destroy_write_struct (&png_ptr, (png_info **)NULL);
+      return false;
+    }
+
+  buf.size = 1024;
+  buf.len = 0;
+  buf.data = (unsigned char *)_pl_xmalloc (buf.size);
+
+  /* cleanup after libpng errors (error handler does a longjmp) */
+  if (setjmp (png_jmpbuf (png_ptr)))
+    {
+      png_destroy_write_struct (&png_ptr, &info_ptr);
+      free (buf.data);
+      return false;
+    }
+
+  png_set_write_fn (png_ptr, (void *)&buf, 
+		    (png_rw_ptr)_svg_png_write_fn, 
+		    (png_flush_ptr)_svg_png_flush_fn);
+  png_set_IHDR (png_ptr, info_ptr, 
+		(png_uint_32)width, (png_uint_32)height, 8, 
+		PNG_COLOR_TYPE_RGB, PNG_INTERLACE_NONE,
+		PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT);
+  png_write_info (png_ptr, info_ptr);
+  for (j = 0; j < height; j++)
+    png_write_row (png_ptr, (png_byte *)(rgb + 3 * (long)j * width));
+  png_write_end (png_ptr, (png_info *)NULL);
+  png_destroy_write_struct (&png_ptr, &info_ptr);
+
+  /* map from the image frame, in which the image pixel in row j and
+     column i is the unit square with upper left corner (i,j), to the user
+     frame */
+  local[0] = (x1 - x0) / width;
+  local[1] = 0.0;
+  local[2] = 0.0;
+  local[3] = (y0 - y1) / height;
+  local[4] = x0;
+  local[5] = y1;
+
+  strcpy (page->point, "<image ");
+  _update_buffer (page);
+
+  _pl_s_set_matrix (R___(_plotter) local); 
+
+  sprintf (page->point, "\
+x=\"0\" y=\"0\" width=\"%d\" height=\"%d\" preserveAspectRatio=\"none\" \
+image-rendering=\"optimizeSpeed\" xlink:href=\"data:image/png;base64,",
+	   width, height);
+  _update_buffer (page);
+
+  for (i = 0; i < buf.len; i += SVG_IMAGE_BYTES_PER_CHUNK)
+    {
+      unsigned long k, end = i + SVG_IMAGE_BYTES_PER_CHUNK;
+      char *s = page->point;
+
+      if (end > buf.len)
+	end = buf.len;
+      for (k = i; k < end; k += 3)
+	{
+	  unsigned long n = (unsigned long)buf.data[k] << 16;
+
+	  if (k + 1 < end)
+	    n |= (unsigned long)buf.data[k + 1] << 8;
+	  if (k + 2 < end)
+	    n |= (unsigned long)buf.data[k + 2];
+	  *s++ = base64digits[(n >> 18) & 0x3f];
+	  *s++ = base64digits[(n >> 12) & 0x3f];
+	  *s++ = (k + 1 < end) ? base64digits[(n >> 6) & 0x3f] : '=';
+	  *s++ = (k + 2 < end) ? base64digits[n & 0x3f] : '=';
+	}
+      *s = '\0';
+      _update_buffer (page);
+    }
+  free (buf.data);
+
+  strcpy (page->point, "\"/>\n");
+  _update_buffer (page);
+
+  return true;
+}
+
+#else  /* not INCLUDE_PNG_SUPPORT */
+
+bool
+_pl_s_paint_image (R___(Plotter *_plotter) double x0, double y0, double x1, double y1, int width, int height, const unsigned char *rgb)
+{
+  return false;
+}
+
+#endif /* not INCLUDE_PNG_SUPPORT */
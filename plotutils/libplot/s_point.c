@@ -65,3 +65,81 @@ write_svg_point_style (plOutbuf *page, const plDrawState *drawstate)
 	   _libplot_color_to_svg_color (drawstate->fgcolor, color_buf));
   _update_buffer (page);
 }
+
+/* The SVGPlotter-specific version of the paint_markers method, which draws
+   n identical marker symbols.  The SVG elements for the first marker are
+   grouped, and given an id, and every other marker is a <use> element
+   that refers to the group. */
+
+bool
+_pl_s_paint_markers (R___(Plotter *_plotter) const double *x, const double *y, int n, int type, double size)
+{
+  plOutbuf *page = _plotter->data->page;
+  const double *m = _plotter->drawstate->transform.m_user_to_ndc;
+  double inverse_of_global[6];
+  unsigned long id;
+  int i, decimals;
+
+  if (n < 2)
+    return false;		/* not worth it */
+
+  if (!(x[0] == x[0] && y[0] == y[0]))
+    return false;
+
+  /* name the group after the current offset in the page, so that each
+     batch of markers gets a distinct id */
+  id = page->contents;
+  sprintf (page->point, "<g id=\"m%lu\">\n", id);
+  _update_buffer (page);
+
+  _API_fmarker (R___(_plotter) x[0], y[0], type, size);
+
+  strcpy (page->point, "</g>\n");
+  _update_buffer (page);
+
+  if (_plotter->s_matrix_is_unknown)
+    /* marker produced no SVG elements */
+    return true;
+
+  /* a <use> element is translated in the coordinate frame of the page's
+     global transformation matrix, if any (see _pl_s_set_matrix) */
+  if (_plotter->s_matrix_is_bogus == false)
+    _matrix_inverse (_plotter->s_matrix, inverse_of_global);
+
+  /* offsets are rounded as path coordinates are (see SVG_DECIMALS), in
+     the frame they're written in */
+  decimals = _svg_frame_decimals (_plotter->s_matrix_is_bogus
+				  ? identity_matrix : _plotter->s_matrix,
+				  _plotter->s_decimals);
+
+  for (i = 1; i < n; i++)
+    {
+      double dx, dy, ndc_dx, ndc_dy;
+
+      dx = x[i] - x[0];
+      dy = y[i] - y[0];
+      ndc_dx = m[0] * dx + m[2] * dy;
+      ndc_dy = m[1] * dx + m[3] * dy;
+      if (_plotter->s_matrix_is_bogus == false)
+	{
+	  dx = inverse_of_global[0] * ndc_dx + inverse_of_global[2] * ndc_dy;
+	  dy = inverse_of_global[1] * ndc_dx + inverse_of_global[3] * ndc_dy;
+	}
+      else
+	{
+	  dx = ndc_dx;
+	  dy = ndc_dy;
+	}
+      if (!(dx == dx && dy == dy))
+	continue;
+
+      sprintf (page->point, "<use xlink:href=\"#m%lu\" x=\"", id);
+      _update_buffer (page);
+      _write_svg_number (page, dx, decimals);
+      _append_string (page, "\" y=\"");
+      _write_svg_number (page, dy, decimals);
+      _append_string (page, "\"/>\n");
+    }
+
+  return true;
+}
@@ -28,22 +28,22 @@ _pl_x_end_page (S___(Plotter *_plotter))
     /* copy final frame of buffered graphics from pixmap serving as
        graphics buffer, to window */
     {
-      /* compute rectangle size; note flipped-y convention */
-      int window_width = (_plotter->data->imax - _plotter->data->imin) + 1;
-      int window_height = (_plotter->data->jmin - _plotter->data->jmax) + 1;
+      /* the frame differs from the one on display only where one of them
+	 was painted (see x_erase.c) */
+      int x, y;
+      unsigned int width, height;
       
-      if (_plotter->x_drawable1)
-	XCopyArea (_plotter->x_dpy, _plotter->x_drawable3, _plotter->x_drawable1,
-		   _plotter->drawstate->x_gc_bg,		   
-		   0, 0,
-		   (unsigned int)window_width, (unsigned int)window_height,
-		   0, 0);
-      if (_plotter->x_drawable2)
-	XCopyArea (_plotter->x_dpy, _plotter->x_drawable3, _plotter->x_drawable2,
-		   _plotter->drawstate->x_gc_bg,		   
-		   0, 0,
-		   (unsigned int)window_width, (unsigned int)window_height,
-		   0, 0);
+      if (_pl_x_damage_rect (R___(_plotter) true, &x, &y, &width, &height))
+	{
+	  if (_plotter->x_drawable1)
+	    XCopyArea (_plotter->x_dpy, _plotter->x_drawable3, 
+		       _plotter->x_drawable1, _plotter->drawstate->x_gc_bg,
+		       x, y, width, height, x, y);
+	  if (_plotter->x_drawable2)
+	    XCopyArea (_plotter->x_dpy, _plotter->x_drawable3, 
+		       _plotter->x_drawable2, _plotter->drawstate->x_gc_bg,
+		       x, y, width, height, x, y);
+	}
       
       /* no more need for pixmap, so free it (if there is one) */
       if (_plotter->x_drawable1 || _plotter->x_drawable2)
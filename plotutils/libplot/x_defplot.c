@@ -38,7 +38,9 @@ const Plotter _pl_x_default_plotter =
   /* internal path-painting methods (endpath() is a wrapper for the first) */
   _pl_x_paint_path, _pl_x_paint_paths, _pl_x_path_is_flushable, _pl_x_maybe_prepaint_segments,
   /* internal methods for drawing of markers and points */
-  _pl_g_paint_marker, _pl_x_paint_point,
+  _pl_g_paint_marker, _pl_g_paint_markers, _pl_x_paint_point,
+  /* internal methods for drawing and reading of raster images */
+  _pl_g_paint_image, _pl_g_read_image,
   /* internal methods that plot strings in Hershey, non-Hershey fonts */
   _pl_g_paint_text_string_with_escapes, _pl_x_paint_text_string,
   _pl_x_get_text_width,
@@ -148,6 +150,11 @@ _pl_x_initialize (S___(Plotter *_plotter))
   _plotter->x_colormap_warning_issued = false;
   _plotter->x_bg_color_warning_issued = false;
   _plotter->x_paint_pixel_count = 0;
+  _plotter->x_damage_xmin = _plotter->x_shown_xmin = 0;
+  _plotter->x_damage_ymin = _plotter->x_shown_ymin = 0;
+  _plotter->x_damage_xmax = _plotter->x_shown_xmax = -1;
+  _plotter->x_damage_ymax = _plotter->x_shown_ymax = -1;
+  _plotter->x_damage_bg = 0;
 
   /* initialize certain data members from device driver parameters */
 
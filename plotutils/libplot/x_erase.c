@@ -52,6 +52,13 @@ _pl_x_erase_page (S___(Plotter *_plotter))
   window_width = (_plotter->data->imax - _plotter->data->imin) + 1;
   window_height = (_plotter->data->jmin - _plotter->data->jmax) + 1;
 
+  /* Outside the regions painted in the current frame and in the frame on
+     display, the graphics buffer and the drawable(s) already hold the
+     background color; so unless that has changed, only those regions need
+     to be copied or cleared (see _pl_x_add_damage() below). */
+  if (_plotter->drawstate->x_gc_bgcolor != _plotter->x_damage_bg)
+    _pl_x_set_full_damage (S___(_plotter));
+
   if (_plotter->x_double_buffering != X_DBL_BUF_NONE)
     {
       /* Following two sorts of server-supported double buffering
@@ -107,53 +114,76 @@ _pl_x_erase_page (S___(Plotter *_plotter))
          an X protocol extension */
       if (_plotter->x_double_buffering == X_DBL_BUF_BY_HAND)
 	{
-	  /* copy current frame of buffered graphics to drawable(s) */
-	  if (_plotter->x_drawable1)
-	    XCopyArea (_plotter->x_dpy, 
-		       _plotter->x_drawable3, _plotter->x_drawable1,
-		       _plotter->drawstate->x_gc_bg,		   
-		       0, 0,
-		       (unsigned int)window_width, 
-		       (unsigned int)window_height,
-		       0, 0);
-	  if (_plotter->x_drawable2)
-	    XCopyArea (_plotter->x_dpy, 
-		       _plotter->x_drawable3, _plotter->x_drawable2,
-		       _plotter->drawstate->x_gc_bg,		   
-		       0, 0,
-		       (unsigned int)window_width, 
-		       (unsigned int)window_height,
-		       0, 0);
-	}
+	  int x, y;
+	  unsigned int width, height;
 
-      /* irrespective of which of the three sorts of double buffering is
-	 being performed, clear the (new) graphics buffer, by filling it
-	 with background color */
-      XFillRectangle (_plotter->x_dpy, _plotter->x_drawable3, 
-		      _plotter->drawstate->x_gc_bg,
-		      /* upper left corner */
-		      0, 0,
-		      (unsigned int)window_width, 
-		      (unsigned int)window_height);
+	  /* copy current frame of buffered graphics to drawable(s), where
+	     it differs from the frame on display */
+	  if (_pl_x_damage_rect (R___(_plotter) true, 
+				 &x, &y, &width, &height))
+	    {
+	      if (_plotter->x_drawable1)
+		XCopyArea (_plotter->x_dpy, 
+			   _plotter->x_drawable3, _plotter->x_drawable1,
+			   _plotter->drawstate->x_gc_bg,		   
+			   x, y, width, height, x, y);
+	      if (_plotter->x_drawable2)
+		XCopyArea (_plotter->x_dpy, 
+			   _plotter->x_drawable3, _plotter->x_drawable2,
+			   _plotter->drawstate->x_gc_bg,		   
+			   x, y, width, height, x, y);
+	    }
+
+	  /* clear the graphics buffer where the current frame was painted,
+	     by filling it with background color */
+	  if (_pl_x_damage_rect (R___(_plotter) false, 
+				 &x, &y, &width, &height))
+	    XFillRectangle (_plotter->x_dpy, _plotter->x_drawable3, 
+			    _plotter->drawstate->x_gc_bg,
+			    x, y, width, height);
+	}
+      else
+	/* with server-supported double buffering, the new graphics buffer
+	   is an older frame, so clear all of it, by filling it with
+	   background color */
+	XFillRectangle (_plotter->x_dpy, _plotter->x_drawable3, 
+			_plotter->drawstate->x_gc_bg,
+			/* upper left corner */
+			0, 0,
+			(unsigned int)window_width, 
+			(unsigned int)window_height);
     }
   else
     /* not double buffering at all */
     {
-      /* erase drawable(s) by filling with background color */
-      if (_plotter->x_drawable1)
-	XFillRectangle (_plotter->x_dpy, _plotter->x_drawable1, 
-			_plotter->drawstate->x_gc_bg,
-			/* upper left corner */
-			0, 0,
-			(unsigned int)window_width, (unsigned int)window_height);
-      if (_plotter->x_drawable2)
-	XFillRectangle (_plotter->x_dpy, _plotter->x_drawable2, 
-			_plotter->drawstate->x_gc_bg,
-			/* upper left corner */
-			0, 0,
-			(unsigned int)window_width, (unsigned int)window_height);
+      int x, y;
+      unsigned int width, height;
+
+      /* erase drawable(s) where the current frame was painted, by filling
+	 with background color */
+      if (_pl_x_damage_rect (R___(_plotter) false, &x, &y, &width, &height))
+	{
+	  if (_plotter->x_drawable1)
+	    XFillRectangle (_plotter->x_dpy, _plotter->x_drawable1, 
+			    _plotter->drawstate->x_gc_bg,
+			    x, y, width, height);
+	  if (_plotter->x_drawable2)
+	    XFillRectangle (_plotter->x_dpy, _plotter->x_drawable2, 
+			    _plotter->drawstate->x_gc_bg,
+			    x, y, width, height);
+	}
     }
 
+  /* the frame just painted is now on display (if double buffering), and
+     nothing has been painted in the new one */
+  _plotter->x_shown_xmin = _plotter->x_damage_xmin;
+  _plotter->x_shown_ymin = _plotter->x_damage_ymin;
+  _plotter->x_shown_xmax = _plotter->x_damage_xmax;
+  _plotter->x_shown_ymax = _plotter->x_damage_ymax;
+  _plotter->x_damage_xmin = _plotter->x_damage_ymin = 0;
+  _plotter->x_damage_xmax = _plotter->x_damage_ymax = -1;
+  _plotter->x_damage_bg = _plotter->drawstate->x_gc_bgcolor;
+
 #if 0
   /* If an X Plotter, update background color of y_canvas widget,
      irrespective of whether or not we're double buffering.  This fixes
@@ -265,3 +295,94 @@ _pl_x_erase_page (S___(Plotter *_plotter))
 
   return true;
 }
+
+/* Damage tracking.  Each painting operation records the device-frame
+   rectangle it may have touched, so that erase() and end_page() copy and
+   clear only the part of the graphics buffer and drawable(s) that differs
+   from the background color.  In a live view in which only part of each
+   frame changes, this saves repainting the rest of the window.  The
+   regions are kept as bounding boxes, in X11 coordinates, and may be
+   larger than what was actually painted, but never smaller. */
+
+/* extend the region painted in the current frame by a rectangle (given by
+   inclusive corners, which needn't lie within the window) */
+void
+_pl_x_add_damage (R___(Plotter *_plotter) int xmin, int ymin, int xmax, int ymax)
+{
+  int window_width = (_plotter->data->imax - _plotter->data->imin) + 1;
+  int window_height = (_plotter->data->jmin - _plotter->data->jmax) + 1;
+
+  xmin = IMAX(xmin, 0);
+  ymin = IMAX(ymin, 0);
+  xmax = IMIN(xmax, window_width - 1);
+  ymax = IMIN(ymax, window_height - 1);
+  if (xmin > xmax || ymin > ymax)
+    return;			/* off the window */
+
+  if (_plotter->x_damage_xmin > _plotter->x_damage_xmax)
+    /* first painting operation in frame */
+    {
+      _plotter->x_damage_xmin = xmin;
+      _plotter->x_damage_ymin = ymin;
+      _plotter->x_damage_xmax = xmax;
+      _plotter->x_damage_ymax = ymax;
+    }
+  else
+    {
+      _plotter->x_damage_xmin = IMIN(_plotter->x_damage_xmin, xmin);
+      _plotter->x_damage_ymin = IMIN(_plotter->x_damage_ymin, ymin);
+      _plotter->x_damage_xmax = IMAX(_plotter->x_damage_xmax, xmax);
+      _plotter->x_damage_ymax = IMAX(_plotter->x_damage_ymax, ymax);
+    }
+}
+
+/* mark the whole window as painted, both in the current frame and in the
+   frame on display, e.g. because its contents are unknown */
+void
+_pl_x_set_full_damage (S___(Plotter *_plotter))
+{
+  int window_width = (_plotter->data->imax - _plotter->data->imin) + 1;
+  int window_height = (_plotter->data->jmin - _plotter->data->jmax) + 1;
+
+  _plotter->x_damage_xmin = _plotter->x_shown_xmin = 0;
+  _plotter->x_damage_ymin = _plotter->x_shown_ymin = 0;
+  _plotter->x_damage_xmax = _plotter->x_shown_xmax = window_width - 1;
+  _plotter->x_damage_ymax = _plotter->x_shown_ymax = window_height - 1;
+}
+
+/* Compute the rectangle (as passed to XCopyArea or XFillRectangle) that
+   bounds the region painted in the current frame, and also the region
+   painted in the frame on display if include_shown is true.  Return false
+   if it's empty. */
+bool
+_pl_x_damage_rect (R___(Plotter *_plotter) bool include_shown, int *x, int *y, unsigned int *width, unsigned int *height)
+{
+  int xmin = _plotter->x_damage_xmin, ymin = _plotter->x_damage_ymin;
+  int xmax = _plotter->x_damage_xmax, ymax = _plotter->x_damage_ymax;
+
+  if (include_shown && _plotter->x_shown_xmin <= _plotter->x_shown_xmax)
+    {
+      if (xmin > xmax)
+	{
+	  xmin = _plotter->x_shown_xmin;
+	  ymin = _plotter->x_shown_ymin;
+	  xmax = _plotter->x_shown_xmax;
+	  ymax = _plotter->x_shown_ymax;
+	}
+      else
+	{
+	  xmin = IMIN(xmin, _plotter->x_shown_xmin);
+	  ymin = IMIN(ymin, _plotter->x_shown_ymin);
+	  xmax = IMAX(xmax, _plotter->x_shown_xmax);
+	  ymax = IMAX(ymax, _plotter->x_shown_ymax);
+	}
+    }
+  if (xmin > xmax || ymin > ymax)
+    return false;
+
+  *x = xmin;
+  *y = ymin;
+  *width = (unsigned int)(xmax - xmin + 1);
+  *height = (unsigned int)(ymax - ymin + 1);
+  return true;
+}
@@ -137,6 +137,10 @@ _pl_x_begin_page (S___(Plotter *_plotter))
 	}
     }
 
+  /* the drawable(s) may hold anything, so the first erase() or end_page()
+     must repaint all of them */
+  _pl_x_set_full_damage (S___(_plotter));
+
   /* Note: at this point the drawing state, which we added X GC's to, a few
      lines above, won't be ready for drawing graphics, since it won't
      contain an X font or meaningful line width.  To retrieve an X font and
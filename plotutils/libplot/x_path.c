@@ -64,14 +64,28 @@
 #define DIST(p1, p2) sqrt( ((p1).x - (p2).x) * ((p1).x - (p2).x) \
 			  + ((p1).y - (p2).y) * ((p1).y - (p2).y))
 
+/* forward references */
+static void path_device_bbox (const plPath *path, double m[6], double pad, int *xmin, int *ymin, int *xmax, int *ymax);
+
 void
 _pl_x_paint_path (S___(Plotter *_plotter))
 {
+  int xmin, ymin, xmax, ymax;
+
   if (_plotter->drawstate->pen_type == 0
       && _plotter->drawstate->fill_type == 0)
     /* nothing to draw */
     return;
 
+  /* record the region that's about to be painted (see x_erase.c); the
+     pad allows for the line width and for mitered joins */
+  path_device_bbox (_plotter->drawstate->path, 
+		    _plotter->drawstate->transform.m,
+		    0.5 * DMAX(_plotter->drawstate->device_line_width, 1.0)
+		    * DMAX(_plotter->drawstate->miter_limit, 1.0) + 2.0,
+		    &xmin, &ymin, &xmax, &ymax);
+  _pl_x_add_damage (R___(_plotter) xmin, ymin, xmax, ymax);
+
   switch ((int)_plotter->drawstate->path->type)
     {
     case (int)PATH_SEGMENT_LIST:
@@ -92,12 +106,12 @@ _pl_x_paint_path (S___(Plotter *_plotter))
 	  break;
 
 	if (_plotter->drawstate->path->num_segments == 2
-	    && _plotter->drawstate->path->segments[1].type == S_ARC)
+	    && _plotter->drawstate->path->types[1] == S_ARC)
 	  /* segment buffer contains a single circular arc, not a polyline */
 	  {
-	    p0 = _plotter->drawstate->path->segments[0].p;
-	    p1 = _plotter->drawstate->path->segments[1].p;
-	    pc = _plotter->drawstate->path->segments[1].pc;
+	    p0 = _plotter->drawstate->path->points[0];
+	    p1 = _plotter->drawstate->path->points[1];
+	    pc = _plotter->drawstate->path->controls[1].pc;
 	    
 	    /* use native X rendering to draw the (transformed) circular
                arc */
@@ -107,12 +121,12 @@ _pl_x_paint_path (S___(Plotter *_plotter))
 	  }
 
 	if (_plotter->drawstate->path->num_segments == 2
-	    && _plotter->drawstate->path->segments[1].type == S_ELLARC)
+	    && _plotter->drawstate->path->types[1] == S_ELLARC)
 	  /* segment buffer contains a single elliptic arc, not a polyline */
 	  {
-	    p0 = _plotter->drawstate->path->segments[0].p;
-	    p1 = _plotter->drawstate->path->segments[1].p;
-	    pc = _plotter->drawstate->path->segments[1].pc;
+	    p0 = _plotter->drawstate->path->points[0];
+	    p1 = _plotter->drawstate->path->points[1];
+	    pc = _plotter->drawstate->path->controls[1].pc;
 	    
 	    /* use native X rendering to draw the (transformed) elliptic
                arc */
@@ -125,8 +139,8 @@ _pl_x_paint_path (S___(Plotter *_plotter))
 	   not an arc */
 
 	if ((_plotter->drawstate->path->num_segments >= 3)/*check for closure*/
-	    && (_plotter->drawstate->path->segments[_plotter->drawstate->path->num_segments - 1].p.x == _plotter->drawstate->path->segments[0].p.x)
-	    && (_plotter->drawstate->path->segments[_plotter->drawstate->path->num_segments - 1].p.y == _plotter->drawstate->path->segments[0].p.y))
+	    && (_plotter->drawstate->path->points[_plotter->drawstate->path->num_segments - 1].x == _plotter->drawstate->path->points[0].x)
+	    && (_plotter->drawstate->path->points[_plotter->drawstate->path->num_segments - 1].y == _plotter->drawstate->path->points[0].y))
 	  closed = true;
 	else
 	  closed = false;	/* 2-point ones should be open */
@@ -182,13 +196,13 @@ _pl_x_paint_path (S___(Plotter *_plotter))
 	identical_user_coordinates = true;
 	for (i = 0; i < _plotter->drawstate->path->num_segments; i++)
 	  {
-	    plPathSegment datapoint;
+	    plPoint datapoint;
 	    double xu, yu, xd, yd;
 	    int device_x, device_y;
 	    
-	    datapoint = _plotter->drawstate->path->segments[i];
-	    xu = datapoint.p.x;
-	    yu = datapoint.p.y;
+	    datapoint = _plotter->drawstate->path->points[i];
+	    xu = datapoint.x;
+	    yu = datapoint.y;
 	    xd = XD(xu, yu);
 	    yd = YD(xu, yu);
 	    device_x = IROUND(xd);
@@ -597,6 +611,100 @@ _pl_x_paint_path (S___(Plotter *_plotter))
   _maybe_handle_x_events (S___(_plotter));
 }
   
+/* Compute a device-frame bounding box, in integer X11 coordinates, that
+   contains everything painting a simple path could touch: its vertices,
+   the control points of any Bezier segments, and the full circles on
+   which any arcs lie, padded by `pad' pixels. */
+
+#define DAMAGE_CLAMP(x) ((x) < -1.0 ? -1 : (x) > 65536.0 ? 65536 : IROUND(x))
+
+static void
+path_device_bbox (const plPath *path, double m[6], double pad, int *xmin, int *ymin, int *xmax, int *ymax)
+{
+  double x0 = DBL_MAX, y0 = DBL_MAX, x1 = -DBL_MAX, y1 = -DBL_MAX;
+  double scale = _matrix_norm (m);
+  int i;
+
+#define DAMAGE_POINT(p, r) \
+  { double _xd = XD_INTERNAL((p).x, (p).y, m); \
+    double _yd = YD_INTERNAL((p).x, (p).y, m); \
+    x0 = DMIN(x0, _xd - (r)); x1 = DMAX(x1, _xd + (r)); \
+    y0 = DMIN(y0, _yd - (r)); y1 = DMAX(y1, _yd + (r)); }
+
+  switch ((int)path->type)
+    {
+    case (int)PATH_SEGMENT_LIST:
+      for (i = 0; i < path->num_segments; i++)
+	{
+	  const plPathControls *controls = path->controls;
+
+	  DAMAGE_POINT(path->points[i], 0.0)
+	  switch ((int)path->types[i])
+	    {
+	    case (int)S_ARC:
+	    case (int)S_ELLARC:
+	      if (i > 0)
+		{
+		  double r = scale * (DIST(controls[i].pc, path->points[i-1])
+				      + DIST(controls[i].pc, path->points[i]));
+
+		  DAMAGE_POINT(controls[i].pc, r)
+		}
+	      break;
+	    case (int)S_CUBIC:
+	      DAMAGE_POINT(controls[i].pd, 0.0)
+	      /* fall through */
+	    case (int)S_QUAD:
+	      DAMAGE_POINT(controls[i].pc, 0.0)
+	      break;
+	    default:
+	      break;
+	    }
+	}
+      break;
+
+    case (int)PATH_CIRCLE:
+      DAMAGE_POINT(path->pc, scale * path->radius)
+      break;
+
+    case (int)PATH_ELLIPSE:
+      DAMAGE_POINT(path->pc, scale * DMAX(path->rx, path->ry))
+      break;
+
+    case (int)PATH_BOX:
+      {
+	plPoint p;
+
+	DAMAGE_POINT(path->p0, 0.0)
+	DAMAGE_POINT(path->p1, 0.0)
+	p.x = path->p0.x;
+	p.y = path->p1.y;
+	DAMAGE_POINT(p, 0.0)
+	p.x = path->p1.x;
+	p.y = path->p0.y;
+	DAMAGE_POINT(p, 0.0)
+      }
+      break;
+
+    default:
+      break;
+    }
+#undef DAMAGE_POINT
+
+  if (x0 > x1)
+    /* empty path, so empty box */
+    {
+      *xmin = *ymin = 0;
+      *xmax = *ymax = -1;
+      return;
+    }
+  
+  *xmin = DAMAGE_CLAMP(x0 - pad);
+  *ymin = DAMAGE_CLAMP(y0 - pad);
+  *xmax = DAMAGE_CLAMP(x1 + pad);
+  *ymax = DAMAGE_CLAMP(y1 + pad);
+}
+
 /* Use native X rendering to draw what would be a circular arc in the user
    frame on an X display.  If this is called, the map from user to device
    coordinates is assumed to preserve coordinate axes (it may be
@@ -1021,9 +1129,9 @@ _pl_x_maybe_prepaint_segments (R___(Plotter *_plotter) int prev_num_segments)
 
   if (prev_num_segments == 0 && 
       _plotter->drawstate->path->num_segments == 2
-      && _plotter->drawstate->path->segments[0].type == S_MOVETO
-      && (_plotter->drawstate->path->segments[1].type == S_ARC
-	  || _plotter->drawstate->path->segments[1].type == S_ELLARC))
+      && _plotter->drawstate->path->types[0] == S_MOVETO
+      && (_plotter->drawstate->path->types[1] == S_ARC
+	  || _plotter->drawstate->path->types[1] == S_ELLARC))
     return;
 
   if (prev_num_segments == 0)
@@ -1053,10 +1161,10 @@ _pl_x_maybe_prepaint_segments (R___(Plotter *_plotter) int prev_num_segments)
 
       /* starting and ending points for zero-width line segment: (xu,yu)
 	 and (x,y) respectively */
-      xu = _plotter->drawstate->path->segments[i-1].p.x;
-      yu = _plotter->drawstate->path->segments[i-1].p.y;
-      x = _plotter->drawstate->path->segments[i].p.x;
-      y = _plotter->drawstate->path->segments[i].p.y;
+      xu = _plotter->drawstate->path->points[i-1].x;
+      yu = _plotter->drawstate->path->points[i-1].y;
+      x = _plotter->drawstate->path->points[i].x;
+      y = _plotter->drawstate->path->points[i].y;
   
       /* convert to integer X11 coordinates */
       xd = XD(xu, yu);
@@ -1068,6 +1176,11 @@ _pl_x_maybe_prepaint_segments (R___(Plotter *_plotter) int prev_num_segments)
       x2 = IROUND(xd);
       y2 = IROUND(yd);
       
+      /* zero-width line, so a one-pixel margin covers it */
+      _pl_x_add_damage (R___(_plotter) 
+			IMIN(x1, x2) - 1, IMIN(y1, y2) - 1,
+			IMAX(x1, x2) + 1, IMAX(y1, y2) + 1);
+
       if (x1 != x2 || y1 != y2)
 	/* line segment has nonzero length, so draw it */
 	{
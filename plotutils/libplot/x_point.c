@@ -58,6 +58,7 @@ _pl_x_paint_point (S___(Plotter *_plotter))
       yy = YD(_plotter->drawstate->pos.x, _plotter->drawstate->pos.y);
       ix = IROUND(xx);
       iy = IROUND(yy);
+      _pl_x_add_damage (R___(_plotter) ix - 1, iy - 1, ix + 1, iy + 1);
 
       if (_plotter->x_double_buffering != X_DBL_BUF_NONE)
 	/* double buffering, have a `x_drawable3' to draw into */
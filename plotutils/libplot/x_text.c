@@ -59,6 +59,7 @@ _pl_x_paint_text_string (R___(Plotter *_plotter) const unsigned char *s, int h_j
   double width = 0.0;		/* width of string in user units */
   double rot[4];		/* user-frame rotation matrix */
   double a[4];		   /* transformation matrix for XAffDrawString() */
+  double scale, reach;		/* for recording the painted region */
   int i, ix, iy;
   
   /* sanity check; this routine supports only baseline positioning */
@@ -168,6 +169,20 @@ _pl_x_paint_text_string (R___(Plotter *_plotter) const unsigned char *s, int h_j
     a[i] = a[i] 
       * (_plotter->drawstate->true_font_size / _plotter->drawstate->x_font_pixel_size);
     
+  /* record the region that's about to be painted (see x_erase.c): the
+     transformed bitmap lies within a generous disk about (ix,iy) */
+  scale = 0.0;
+  for (i = 0; i < 4; i++)
+    scale = DMAX(scale, a[i] < 0.0 ? -a[i] : a[i]);
+  reach = scale * (XTextWidth (_plotter->drawstate->x_font_struct, 
+			       (char *)s, (int)(strlen((char *)s)))
+		   + _plotter->drawstate->x_font_struct->ascent
+		   + _plotter->drawstate->x_font_struct->descent) + 2.0;
+  reach = DMIN(reach, 65536.0);
+  _pl_x_add_damage (R___(_plotter) 
+		    ix - IROUND(reach), iy - IROUND(reach), 
+		    ix + IROUND(reach), iy + IROUND(reach));
+
   if (_plotter->x_double_buffering != X_DBL_BUF_NONE)
     /* double buffering, have a `x_drawable3' to draw into */
     XAffDrawAffString (_plotter->x_dpy, _plotter->x_drawable3, 
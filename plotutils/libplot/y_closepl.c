@@ -143,13 +143,17 @@ _pl_y_end_page (S___(Plotter *_plotter))
        protocol extension, so our off-screen graphics buffer `x_drawable3' is
        an ordinary pixmap */
 	{
+	  int x, y;
+	  unsigned int width, height;
+
 	  /* make final frame of graphics visible by copying from pixmap to
-             window */
-	  XCopyArea (_plotter->x_dpy, _plotter->x_drawable3, _plotter->x_drawable2,
-		     _plotter->drawstate->x_gc_bg,		   
-		     0, 0,
-		     (unsigned int)window_width, (unsigned int)window_height,
-		     0, 0);
+             window, where it differs from the frame on display (see
+             x_erase.c) */
+	  if (_pl_x_damage_rect (R___(_plotter) true, 
+				 &x, &y, &width, &height))
+	    XCopyArea (_plotter->x_dpy, _plotter->x_drawable3, 
+		       _plotter->x_drawable2, _plotter->drawstate->x_gc_bg,
+		       x, y, width, height, x, y);
 	}
 
   /* Finally: if we're not double buffering at all, we copy our off-screen
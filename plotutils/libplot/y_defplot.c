@@ -62,7 +62,9 @@ const Plotter _pl_y_default_plotter =
   /* internal path-painting methods (endpath() is a wrapper for the first) */
   _pl_x_paint_path, _pl_x_paint_paths, _pl_x_path_is_flushable, _pl_x_maybe_prepaint_segments,
   /* internal methods for drawing of markers and points */
-  _pl_g_paint_marker, _pl_x_paint_point,
+  _pl_g_paint_marker, _pl_g_paint_markers, _pl_x_paint_point,
+  /* internal methods for drawing and reading of raster images */
+  _pl_g_paint_image, _pl_g_read_image,
   /* internal methods that plot strings in Hershey, non-Hershey fonts */
   _pl_g_paint_text_string_with_escapes, _pl_x_paint_text_string,
   _pl_x_get_text_width,
@@ -51,6 +51,13 @@ _pl_y_erase_page (S___(Plotter *_plotter))
   window_width = (_plotter->data->imax - _plotter->data->imin) + 1;
   window_height = (_plotter->data->jmin - _plotter->data->jmax) + 1;
 
+  /* Outside the regions painted in the current frame and in the frame on
+     display, the graphics buffer and the drawable(s) already hold the
+     background color; so unless that has changed, only those regions need
+     to be copied or cleared (see x_erase.c). */
+  if (_plotter->drawstate->x_gc_bgcolor != _plotter->x_damage_bg)
+    _pl_x_set_full_damage (S___(_plotter));
+
   if (_plotter->x_double_buffering != X_DBL_BUF_NONE)
     {
       /* Following two sorts of server-supported double buffering
@@ -106,52 +113,75 @@ _pl_y_erase_page (S___(Plotter *_plotter))
          an X protocol extension */
       if (_plotter->x_double_buffering == X_DBL_BUF_BY_HAND)
 	{
-	  /* copy current frame of buffered graphics to drawable(s) */
-	  if (_plotter->x_drawable1)
-	    XCopyArea (_plotter->x_dpy, 
-		       _plotter->x_drawable3, _plotter->x_drawable1,
-		       _plotter->drawstate->x_gc_bg,		   
-		       0, 0,
-		       (unsigned int)window_width, 
-		       (unsigned int)window_height,
-		       0, 0);
-	  if (_plotter->x_drawable2)
-	    XCopyArea (_plotter->x_dpy, 
-		       _plotter->x_drawable3, _plotter->x_drawable2,
-		       _plotter->drawstate->x_gc_bg,		   
-		       0, 0,
-		       (unsigned int)window_width, 
-		       (unsigned int)window_height,
-		       0, 0);
-	}
+	  int x, y;
+	  unsigned int width, height;
 
-      /* irrespective of which of the three sorts of double buffering is
-	 being performed, clear the (new) graphics buffer, by filling it
-	 with background color */
-      XFillRectangle (_plotter->x_dpy, _plotter->x_drawable3, 
-		      _plotter->drawstate->x_gc_bg,
-		      /* upper left corner */
-		      0, 0,
-		      (unsigned int)window_width, 
-		      (unsigned int)window_height);
+	  /* copy current frame of buffered graphics to drawable(s), where
+	     it differs from the frame on display */
+	  if (_pl_x_damage_rect (R___(_plotter) true, 
+				 &x, &y, &width, &height))
+	    {
+	      if (_plotter->x_drawable1)
+		XCopyArea (_plotter->x_dpy, 
+			   _plotter->x_drawable3, _plotter->x_drawable1,
+			   _plotter->drawstate->x_gc_bg,		   
+			   x, y, width, height, x, y);
+	      if (_plotter->x_drawable2)
+		XCopyArea (_plotter->x_dpy, 
+			   _plotter->x_drawable3, _plotter->x_drawable2,
+			   _plotter->drawstate->x_gc_bg,		   
+			   x, y, width, height, x, y);
+	    }
+
+	  /* clear the graphics buffer where the current frame was painted,
+	     by filling it with background color */
+	  if (_pl_x_damage_rect (R___(_plotter) false, 
+				 &x, &y, &width, &height))
+	    XFillRectangle (_plotter->x_dpy, _plotter->x_drawable3, 
+			    _plotter->drawstate->x_gc_bg,
+			    x, y, width, height);
+	}
+      else
+	/* with server-supported double buffering, the new graphics buffer
+	   is an older frame, so clear all of it, by filling it with
+	   background color */
+	XFillRectangle (_plotter->x_dpy, _plotter->x_drawable3, 
+			_plotter->drawstate->x_gc_bg,
+			/* upper left corner */
+			0, 0,
+			(unsigned int)window_width, 
+			(unsigned int)window_height);
     }
   else
     /* not double buffering at all */
     {
-      /* erase drawable(s) by filling with background color */
-      if (_plotter->x_drawable1)
-	XFillRectangle (_plotter->x_dpy, _plotter->x_drawable1, 
-			_plotter->drawstate->x_gc_bg,
-			/* upper left corner */
-			0, 0,
-			(unsigned int)window_width, (unsigned int)window_height);
-      if (_plotter->x_drawable2)
-	XFillRectangle (_plotter->x_dpy, _plotter->x_drawable2, 
-			_plotter->drawstate->x_gc_bg,
-			/* upper left corner */
-			0, 0,
-			(unsigned int)window_width, (unsigned int)window_height);
+      int x, y;
+      unsigned int width, height;
+
+      /* erase drawable(s) where the current frame was painted, by filling
+	 with background color */
+      if (_pl_x_damage_rect (R___(_plotter) false, &x, &y, &width, &height))
+	{
+	  if (_plotter->x_drawable1)
+	    XFillRectangle (_plotter->x_dpy, _plotter->x_drawable1, 
+			    _plotter->drawstate->x_gc_bg,
+			    x, y, width, height);
+	  if (_plotter->x_drawable2)
+	    XFillRectangle (_plotter->x_dpy, _plotter->x_drawable2, 
+			    _plotter->drawstate->x_gc_bg,
+			    x, y, width, height);
+	}
     }
+
+  /* the frame just painted is now on display (if double buffering), and
+     nothing has been painted in the new one */
+  _plotter->x_shown_xmin = _plotter->x_damage_xmin;
+  _plotter->x_shown_ymin = _plotter->x_damage_ymin;
+  _plotter->x_shown_xmax = _plotter->x_damage_xmax;
+  _plotter->x_shown_ymax = _plotter->x_damage_ymax;
+  _plotter->x_damage_xmin = _plotter->x_damage_ymin = 0;
+  _plotter->x_damage_xmax = _plotter->x_damage_ymax = -1;
+  _plotter->x_damage_bg = _plotter->drawstate->x_gc_bgcolor;
   
 #if 1
   /* If an X Plotter, update background color of y_canvas widget,
@@ -564,7 +564,9 @@ _pl_y_begin_page (S___(Plotter *_plotter))
 
   /* If not double-buffering, clear both pixmap and window by filling them
      with the drawing state's background color, via XFillRectangle.  If
-     double buffering, do something similar (see y_erase.c). */
+     double buffering, do something similar (see y_erase.c).  Nothing is
+     known about their contents yet, so all of them must be cleared. */
+  _pl_x_set_full_damage (S___(_plotter));
   _pl_y_erase_page (S___(_plotter));
   
   /* If double buffering, must invoke `erase' one more time to clear both
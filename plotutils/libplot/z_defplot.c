@@ -24,6 +24,8 @@
 #include "sys-defines.h"
 #include "extern.h"
 
+#include <png.h>		/* for PNG_FILTER_* */
+
 #ifndef LIBPLOTTER
 /* In libplot, this is the initialization for the function-pointer part of
    a PNGPlotter struct.  It is the same as for a BitmapPlotter, except for
@@ -39,7 +41,9 @@ const Plotter _pl_z_default_plotter =
   /* internal path-painting methods (endpath() is a wrapper for the first) */
   _pl_b_paint_path, _pl_b_paint_paths, _pl_g_path_is_flushable, _pl_g_maybe_prepaint_segments,
   /* internal methods for drawing of markers and points */
-  _pl_g_paint_marker, _pl_b_paint_point,
+  _pl_g_paint_marker, _pl_b_paint_markers, _pl_b_paint_point,
+  /* internal methods for drawing and reading of raster images */
+  _pl_b_paint_image, _pl_b_read_image,
   /* internal methods that plot strings in Hershey, non-Hershey fonts */
   _pl_g_paint_text_string_with_escapes, _pl_g_paint_text_string,
   _pl_g_get_text_width,
@@ -84,6 +88,9 @@ _pl_z_initialize (S___(Plotter *_plotter))
   _plotter->z_transparent_color.red = 255; /* dummy */
   _plotter->z_transparent_color.green = 255; /* dummy */
   _plotter->z_transparent_color.blue = 255; /* dummy */
+  _plotter->z_compression_level = -1;
+  _plotter->z_filters = 0;
+  _plotter->z_palette = false;
 
   /* initialize certain data members from device driver parameters */
       
@@ -110,6 +117,45 @@ _pl_z_initialize (S___(Plotter *_plotter))
 	_plotter->z_transparent_color = color;
       }
   }
+
+  /* zlib compression level (0 = none, 1 = fastest .. 9 = smallest) */
+  {
+    const char *level_s;
+    int level;
+
+    level_s = (const char *)_get_plot_param (_plotter->data, "PNG_COMPRESSION_LEVEL" );
+    if (sscanf (level_s, "%d", &level) > 0 
+	&& level >= 0 && level <= 9)
+      _plotter->z_compression_level = level;
+  }
+
+  /* row filter, for all rows (libpng otherwise chooses one per row) */
+  {
+    const char *filter_s;
+
+    filter_s = (const char *)_get_plot_param (_plotter->data, "PNG_FILTER" );
+    if (strcasecmp (filter_s, "none") == 0)
+      _plotter->z_filters = PNG_FILTER_NONE;
+    else if (strcasecmp (filter_s, "sub") == 0)
+      _plotter->z_filters = PNG_FILTER_SUB;
+    else if (strcasecmp (filter_s, "up") == 0)
+      _plotter->z_filters = PNG_FILTER_UP;
+    else if (strcasecmp (filter_s, "avg") == 0)
+      _plotter->z_filters = PNG_FILTER_AVG;
+    else if (strcasecmp (filter_s, "paeth") == 0)
+      _plotter->z_filters = PNG_FILTER_PAETH;
+    else if (strcasecmp (filter_s, "all") == 0)
+      _plotter->z_filters = PNG_ALL_FILTERS;
+  }
+
+  /* write an indexed-color PNG, if few enough colors were painted? */
+  {
+    const char *palette_s;
+
+    palette_s = (const char *)_get_plot_param (_plotter->data, "PNG_PALETTE" );
+    if (strcasecmp (palette_s, "yes") == 0)
+      _plotter->z_palette = true;
+  }
 }
 
 /* The private `terminate' method, which is invoked when a Plotter is
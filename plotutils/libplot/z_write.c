@@ -68,10 +68,16 @@ extern pthread_mutex_t _message_mutex;
 static const char _short_months[12][4] = 
 { "Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec" };
 
+/* size of hash table mapping 24-bit colors to palette indices (a power of
+   two, at least 4 times the maximum palette size) */
+#define PALETTE_HASH_SIZE 1024
+#define PALETTE_HASH(red,green,blue) \
+  ((((red) * 31 + (green)) * 31 + (blue)) & (PALETTE_HASH_SIZE - 1))
+
 /* forward references */
-static int _image_type (miPixel **pixmap, int width, int height);
 static void _our_error_fn_stdio (png_struct *png_ptr, const char *data);
 static void _our_warn_fn_stdio (png_struct *png_ptr, const char *data);
+static int palette_index (const plColor *palette, const short *hash, const png_byte *rgb);
 #ifdef LIBPLOTTER
 static void _our_IO_flush_fn (png_struct *png_ptr);
 static void _our_error_fn_stream (png_struct *png_ptr, const char *data);
@@ -82,9 +88,10 @@ static void _our_write_fn (png_struct *png_ptr, png_byte *data, png_size_t lengt
 int
 _pl_z_maybe_output_image (S___(Plotter *_plotter))
 {
-  miPixel **pixmap;		/* pixmap in miCanvas */
+  void *canvas;			/* libxmi's miCanvas */
   int width, height;
-  int image_type, bit_depth, color_type;
+  int image_type, bit_depth, color_type, num_colors;
+  png_color palette[256];
   png_struct *png_ptr;
   png_info *info_ptr;
   char time_buf[32], software_buf[64];
@@ -188,13 +195,27 @@ _pl_z_maybe_output_image (S___(Plotter *_plotter))
     png_init_io (png_ptr, fp);
 #endif /* not LIBPLOTTER */
 
-  /* extract pixmap (2D array of miPixels) from miCanvas */
-  pixmap = ((miCanvas *)(_plotter->b_canvas))->drawable->pixmap;
+  canvas = _plotter->b_canvas;
 
-  /* what is best image type that can be used?  0/1/2 = mono/gray/rgb */
+  /* what is best image type that can be used?  0/1/2/3 =
+     mono/gray/rgb/palette.  The colors painted on the canvas were recorded
+     while drawing (see b_openpl.c), so the canvas needn't be scanned. */
   width = _plotter->b_xn;
   height = _plotter->b_yn;
-  image_type = _image_type (pixmap, width, height);
+  image_type = _plotter->b_image_type;
+  num_colors = _plotter->b_num_palette_colors;
+  if (_plotter->z_palette && image_type != 0 && num_colors > 0)
+    {
+      int i;
+
+      image_type = 3;
+      for (i = 0; i < num_colors; i++)
+	{
+	  palette[i].red = (png_byte)_plotter->b_palette[i].red;
+	  palette[i].green = (png_byte)_plotter->b_palette[i].green;
+	  palette[i].blue = (png_byte)_plotter->b_palette[i].blue;
+	}
+    }
   switch (image_type)
     {
     case 0:			/* mono */
@@ -205,6 +226,11 @@ _pl_z_maybe_output_image (S___(Plotter *_plotter))
       bit_depth = 8;
       color_type = PNG_COLOR_TYPE_GRAY;
       break;
+    case 3:			/* palette */
+      bit_depth = (num_colors <= 2 ? 1 : num_colors <= 4 ? 2 
+		   : num_colors <= 16 ? 4 : 8);
+      color_type = PNG_COLOR_TYPE_PALETTE;
+      break;
     case 2:			/* rgb */
     default:
       bit_depth = 8;
@@ -226,6 +252,14 @@ _pl_z_maybe_output_image (S___(Plotter *_plotter))
 		_plotter->z_interlace ? PNG_INTERLACE_ADAM7 
 		                      : PNG_INTERLACE_NONE,
 		PNG_COMPRESSION_TYPE_BASE, PNG_FILTER_TYPE_BASE);
+  if (image_type == 3)
+    png_set_PLTE (png_ptr, info_ptr, palette, num_colors);
+
+  /* trade off speed against size, if the user asked to */
+  if (_plotter->z_compression_level >= 0)
+    png_set_compression_level (png_ptr, _plotter->z_compression_level);
+  if (_plotter->z_filters)
+    png_set_filter (png_ptr, PNG_FILTER_TYPE_BASE, _plotter->z_filters);
   
   /* set transparent color (if user specified one) */
   if (_plotter->z_transparent)
@@ -258,6 +292,28 @@ _pl_z_maybe_output_image (S___(Plotter *_plotter))
 	  else
 	    trans_value.gray = (png_uint_16)transparent_color.red;
 	  break;
+	case 3:			/* palette */
+	  {
+	    png_byte alpha[256];
+	    int i;
+
+	    /* make the palette entry for the color, if any, transparent */
+	    transparent_color_ok = false;
+	    for (i = 0; i < num_colors; i++)
+	      {
+		alpha[i] = 0xff;
+		if (palette[i].red == transparent_color.red
+		    && palette[i].green == transparent_color.green
+		    && palette[i].blue == transparent_color.blue)
+		  {
+		    alpha[i] = 0;
+		    png_set_tRNS (png_ptr, info_ptr, alpha, i + 1, 
+				  (png_color_16 *)NULL);
+		    break;
+		  }
+	      }
+	  }
+	  break;
 	case 2:			/* rgb */
 	default:
 	  trans_value.red = (png_uint_16)transparent_color.red;
@@ -293,24 +349,49 @@ _pl_z_maybe_output_image (S___(Plotter *_plotter))
   
   /* write out PNG file header */
   png_write_info (png_ptr, info_ptr);
+
+  /* palette indices are written 1 byte per pixel, and packed by libpng */
+  if (image_type == 3)
+    png_set_packing (png_ptr);
   
   /* Write out image data, a row at a time; support multiple passes over
      image if interlacing.  We don't simply call png_write_image() because
-     the image in the miCanvas's pixmap is a 2-D array of miPixels, and
-     sizeof(miPixel) > 4 is possible.  Instead we copy each miPixel in a
-     row into a local row buffer, and write out the row buffer. */
+     each miPixel in the miCanvas's rows carries a type byte.  Instead we
+     copy the color bytes of each row into a local row buffer, and write
+     out the row buffer. */
   {
-    png_byte *rowbuf;
+    png_byte *rowbuf, *graybuf = (png_byte *)NULL, *rgbbuf = (png_byte *)NULL;
+    short *hash = (short *)NULL;
     int num_passes, pass;
 
     switch (image_type)
       {
       case 0:			/* mono */
 	rowbuf = (png_byte *)_pl_xmalloc(((width + 7)/8) * sizeof(png_byte));
+	graybuf = (png_byte *)_pl_xmalloc(width * sizeof(png_byte));
 	break;
       case 1:			/* gray */
 	rowbuf = (png_byte *)_pl_xmalloc(width * sizeof(png_byte));	
 	break;
+      case 3:			/* palette */
+	{
+	  int i;
+
+	  rowbuf = (png_byte *)_pl_xmalloc(width * sizeof(png_byte));
+	  rgbbuf = (png_byte *)_pl_xmalloc(3 * width * sizeof(png_byte));
+	  /* hash each palette color to its index (plus 1; 0 = empty slot) */
+	  hash = (short *)_pl_xcalloc(PALETTE_HASH_SIZE, sizeof(short));
+	  for (i = 0; i < num_colors; i++)
+	    {
+	      int k = PALETTE_HASH(palette[i].red, palette[i].green, 
+				   palette[i].blue);
+
+	      while (hash[k])
+		k = (k + 1) & (PALETTE_HASH_SIZE - 1);
+	      hash[k] = (short)(i + 1);
+	    }
+	}
+	break;
       case 2:			/* rgb */
       default:
 	rowbuf = (png_byte *)_pl_xmalloc(3 * width * sizeof(png_byte));
@@ -329,35 +410,38 @@ _pl_z_maybe_output_image (S___(Plotter *_plotter))
 
 	for (j = 0; j < height; j++)
 	  {
-	    png_byte *ptr;
-
 	    /* fill row buffer with 3 bytes per miPixel (RGB), or 1 byte
-	       (gray), or 1 bit (mono) */
-	    ptr = rowbuf;
-	    for (i = 0; i < width; i++)
+	       (gray, or palette index), or 1 bit (mono) */
+	    switch (image_type)
 	      {
-		switch (image_type)
+	      case 0:		/* mono */
+		_pl_canvas_row (canvas, j, 1, graybuf);
+		memset (rowbuf, 0, (width + 7)/8);
+		for (i = 0; i < width; i++)
+		  if (graybuf[i])	/* white pixel */
+		    rowbuf[i / 8] |= (1 << (7 - (i % 8)));
+		break;
+	      case 1:		/* gray */
+		_pl_canvas_row (canvas, j, 1, rowbuf);
+		break;
+	      case 3:		/* palette */
+		_pl_canvas_row (canvas, j, 3, rgbbuf);
+		for (i = 0; i < width; i++)
 		  {
-		  case 0:	/* mono */
-		    if (i % 8 == 0)
-		      {
-			if (i != 0)
-			  ptr++;
-			*ptr = (png_byte)0;
-		      }
-		    if (pixmap[j][i].u.rgb[0]) /* white pixel */
-		      *ptr |= (1 << (7 - (i % 8)));
-		    break;
-		  case 1:	/* gray */
-		    *ptr++ = (png_byte)pixmap[j][i].u.rgb[0];
-		    break;
-		  case 2:	/* rgb */
-		  default:
-		    *ptr++ = (png_byte)pixmap[j][i].u.rgb[0];
-		    *ptr++ = (png_byte)pixmap[j][i].u.rgb[1];
-		    *ptr++ = (png_byte)pixmap[j][i].u.rgb[2];
-		    break;
+		    const png_byte *rgb = rgbbuf + 3 * i;
+
+		    if (i > 0 && rgb[0] == rgb[-3] && rgb[1] == rgb[-2] 
+			&& rgb[2] == rgb[-1])
+		      rowbuf[i] = rowbuf[i - 1];	/* same as last pixel */
+		    else
+		      rowbuf[i] = 
+			(png_byte)palette_index (_plotter->b_palette, hash, rgb);
 		  }
+		break;
+	      case 2:		/* rgb */
+	      default:
+		_pl_canvas_row (canvas, j, 3, rowbuf);
+		break;
 	      }
 	    
 	    /* write out row buffer */
@@ -366,6 +450,9 @@ _pl_z_maybe_output_image (S___(Plotter *_plotter))
       }
 
     free (rowbuf);
+    free (graybuf);
+    free (rgbbuf);
+    free (hash);
   }
 
   /* write out PNG file trailer (could add more comments here) */
@@ -377,47 +464,23 @@ _pl_z_maybe_output_image (S___(Plotter *_plotter))
   return true;
 }
 
-/* return best type for writing an image (0=mono, 1=grey, 2=color) */
+/* look up the palette index of a 24-bit color; the recorded palette
+   includes every color painted, so the lookup can't fail */
 static int
-_image_type (miPixel **pixmap, int width, int height)
+palette_index (const plColor *palette, const short *hash, const png_byte *rgb)
 {
-  int i, j;
-  int type = 0;			/* default is mono */
-  
-  for (j = 0; j < height; j++)
-    for (i = 0; i < width; i++)
-      {
-	unsigned char red, green, blue;
-	
-	red = pixmap[j][i].u.rgb[0];
-	green = pixmap[j][i].u.rgb[1];
-	blue = pixmap[j][i].u.rgb[2];
-	if (type == 0)		/* up to now, all pixels are black or white */
-	  {
-	    if (! ((red == (unsigned char)0 && green == (unsigned char)0
-		    && blue == (unsigned char)0)
-		   || (red == (unsigned char)255 && green == (unsigned char)255
-		    && blue == (unsigned char)255)))
-	      {
-		if (red == green && red == blue)
-		  type = 1;	/* need grey */
-		else
-		  {
-		    type = 2;	/* need color */
-		    return type;
-		  }
-	      }
-	  }
-	else if (type == 1)
-	  {
-	    if (red != green || red != blue)
-	      {
-		type = 2;	/* need color */
-		return type;
-	      }
-	  }
-      }
-  return type;
+  int k = PALETTE_HASH(rgb[0], rgb[1], rgb[2]);
+
+  while (hash[k])
+    {
+      const plColor *color = &palette[hash[k] - 1];
+
+      if (color->red == rgb[0] && color->green == rgb[1] 
+	  && color->blue == rgb[2])
+	return hash[k] - 1;
+      k = (k + 1) & (PALETTE_HASH_SIZE - 1);
+    }
+  return 0;
 }
 
 /* custom error and warning handlers (for stdio) */
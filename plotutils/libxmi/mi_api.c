@@ -82,8 +82,6 @@ miDrawRectangles (miPaintedSet *paintedSet, const miGC *pGC, int nrects, const m
 void
 miFillRectangles (miPaintedSet *paintedSet, const miGC *pGC, int nrectFill, const miRectangle *prectInit)
 {
-  fprintf (stderr, "miFillRectangles()\n");
-
   MI_SETUP_PAINTED_SET(paintedSet, pGC);
   miFillRectangles_internal (paintedSet, pGC, nrectFill, prectInit);
   MI_TEAR_DOWN_PAINTED_SET(paintedSet)
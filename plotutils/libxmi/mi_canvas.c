@@ -31,6 +31,7 @@
 static miPixmap * miNewPixmap (unsigned int width, unsigned int height, miPixel initPixel);
 static miPixmap * miCopyPixmap (const miPixmap *pPixmap);
 static void miDeletePixmap (miPixmap *pPixmap);
+static void miFillPixels (miPixel *p, miPixel pixel, unsigned int n);
 #if 0		/* not currently used, so commented out */
 static miBitmap * miNewBitmap (unsigned int width, unsigned int height, int initBit);
 #endif
@@ -101,80 +102,115 @@ miDeleteCanvas (miCanvas *pCanvas)
 
 #endif /* not MI_CANVAS_DRAWABLE_TYPE */
 
-/* create a new miPixmap, and fill it with a specified miPixel */
+/* create a new miPixmap, without initializing its pixels.  The rows are
+   allocated as a single block, each padded to a multiple of
+   MI_PIXMAP_ROW_ALIGN bytes, and pixmap[] points into it. */
 static miPixmap * 
-miNewPixmap (unsigned int width, unsigned int height, miPixel initPixel)
+miAllocPixmap (unsigned int width, unsigned int height)
 {
   miPixmap *new_pPixmap;
   miPixel **pixmap;
-  int i, j;
+  unsigned int stride;
+  int j;
   
   new_pPixmap = (miPixmap *)mi_xmalloc (sizeof(miPixmap));
 
+  stride = width;
+  while ((stride * sizeof(miPixel)) % MI_PIXMAP_ROW_ALIGN != 0)
+    stride++;
+
+  new_pPixmap->pixels = 
+    (miPixel *)mi_xmalloc ((size_t)stride * height * sizeof(miPixel));
+
   /* create a pixmap (an array of pointers to rows of miPixels) */
   pixmap = (miPixel **)mi_xmalloc (height * sizeof(miPixel *));
   for (j = 0; j < (int)height; j++)
-    {
-      pixmap[j] = (miPixel *)mi_xmalloc (width * sizeof(miPixel));
-      for (i = 0; i < (int)width; i++)
-	pixmap[j][i] = initPixel;
-    }
+    pixmap[j] = new_pPixmap->pixels + (size_t)j * stride;
 
   new_pPixmap->pixmap = pixmap;
   new_pPixmap->width = width;
   new_pPixmap->height = height;
+  new_pPixmap->stride = stride;
 
   return new_pPixmap;
 }
 
-/* copy a miPixmap */
+/* create a new miPixmap, and fill it with a specified miPixel */
+static miPixmap * 
+miNewPixmap (unsigned int width, unsigned int height, miPixel initPixel)
+{
+  miPixmap *new_pPixmap;
+  int j;
+  
+  new_pPixmap = miAllocPixmap (width, height);
+
+  /* fill the first row, and copy it to the others */
+  miFillPixels (new_pPixmap->pixmap[0], initPixel, width);
+  for (j = 1; j < (int)height; j++)
+    memcpy (new_pPixmap->pixmap[j], new_pPixmap->pixmap[0], 
+	    width * sizeof(miPixel));
+
+  return new_pPixmap;
+}
+
+/* copy a miPixmap (which may have been built by the caller, with rows
+   that are not contiguous) */
 static miPixmap * 
 miCopyPixmap (const miPixmap *pPixmap)
 {
   miPixmap *new_pPixmap;
-  miPixel **pixmap;
-  miPixel * const *old_pixmap;
-  int i, j;
+  int j;
   
   if (pPixmap == (const miPixmap *)NULL)
     return (miPixmap *)NULL;
 
-  new_pPixmap = (miPixmap *)mi_xmalloc (sizeof(miPixmap));
-
-  /* create a pixmap (an array of pointers to rows of miPixels) */
-  pixmap = (miPixel **)mi_xmalloc (pPixmap->height * sizeof(miPixel *));
-  old_pixmap = pPixmap->pixmap;
+  new_pPixmap = miAllocPixmap (pPixmap->width, pPixmap->height);
   for (j = 0; j < (int)(pPixmap->height); j++)
-    {
-      pixmap[j] = (miPixel *)mi_xmalloc (pPixmap->width * sizeof(miPixel));
-      for (i = 0; i < (int)(pPixmap->width); i++)
-	pixmap[j][i] = old_pixmap[j][i];
-    }
-
-  new_pPixmap->pixmap = pixmap;
-  new_pPixmap->width = pPixmap->width;
-  new_pPixmap->height = pPixmap->height;
+    memcpy (new_pPixmap->pixmap[j], pPixmap->pixmap[j], 
+	    pPixmap->width * sizeof(miPixel));
 
   return new_pPixmap;
 }
 
-/* destroy (deallocate) an miPixmap */
+/* destroy (deallocate) an miPixmap created by miNewPixmap or
+   miCopyPixmap */
 static void
 miDeletePixmap (miPixmap *pPixmap)
 {
-  int j;
-
   if (pPixmap == (miPixmap *)NULL)
     return;
 
-  /* free pixmap (an array of pointers to rows of miPixels) */
-  for (j = 0; j < (int)(pPixmap->height); j++)
-    free (pPixmap->pixmap[j]);
+  free (pPixmap->pixels);
   free (pPixmap->pixmap);
 
   free (pPixmap);
 }
 
+/* Set n consecutive miPixels to a single value.  Long runs are filled by
+   repeatedly doubling the filled prefix with memcpy, which libc performs
+   with wide (vector) stores whatever the size of a miPixel. */
+static void
+miFillPixels (miPixel *p, miPixel pixel, unsigned int n)
+{
+  unsigned int filled, chunk;
+
+  if (n < 16)
+    {
+      for (filled = 0; filled < n; filled++)
+	p[filled] = pixel;
+      return;
+    }
+
+  for (filled = 0; filled < 8; filled++)
+    p[filled] = pixel;
+  while (filled < n)
+    {
+      chunk = UMIN(filled, n - filled);
+      memcpy (p + filled, p, chunk * sizeof(miPixel));
+      filled += chunk;
+    }
+}
+
 #if 0		/* not currently used, so commented out */
 /* create a new miBitmap, and fill it with a specified value (only 0 and 1
    are meaningful) */
@@ -380,6 +416,34 @@ miPaintCanvas (miCanvas *canvas, miPixel pixel, int n, const miPoint *ppt, const
 	textureYOrigin -= textureHeight;
     }
 
+#if !defined(MI_CANVAS_DRAWABLE_TYPE) && defined(MI_DEFAULT_MERGE2_IS_PAINTERS)
+  /* Fast path for the common case: no stipple, no texture, and the
+     Painter's Algorithm, so each span is a run of identical pixels that
+     can be stored directly into the drawable's row. */
+  if (pCanvas->stipple == (miBitmap *)NULL 
+      && pCanvas->texture == (miPixmap *)NULL
+      && pixelMerge2 == (miPixelMerge2)NULL)
+    {
+      for (i = 0; i < n; i++)
+	{
+	  y = ppt[i].y + yoffset;
+	  if (y > ybottom)
+	    return;		/* no more spans will be painted */
+	  if (y >= ytop)
+	    {
+	      xstart = ppt[i].x + xoffset;
+	      xend = xstart + (int)pwidth[i] - 1;
+	      xstart_clip = IMAX(xstart,xleft);
+	      xend_clip = IMIN(xend,xright);
+	      if (xstart_clip <= xend_clip)
+		miFillPixels (pCanvas->drawable->pixmap[y] + xstart_clip, pixel,
+			      (unsigned int)(xend_clip - xstart_clip + 1));
+	    }
+	}
+      return;
+    }
+#endif
+
   for (i = 0; i < n; i++)
     {
       y = ppt[i].y + yoffset;
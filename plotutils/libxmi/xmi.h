@@ -295,7 +295,10 @@ ___END_DECLS
    a miCanvasPixmap is a miPixmap, i.e., basically a 2-D array of miPixels
    (an array of pointers to rows of miPixels).  That is a low-level
    implementation decision that may easily be changed by the libxmi
-   installer. */
+   installer.  The miPixmaps that libxmi allocates store their rows in a
+   single contiguous block, `stride' miPixels apart, with each row starting
+   on a MI_PIXMAP_ROW_ALIGN-byte boundary, so a drawable may also be read
+   (or written) as one flat framebuffer. */
 
 /* Binary pixel-merging function type.  Such a function maps a source pixel
    and a destination pixel to a new, merged pixel. */
@@ -321,9 +324,13 @@ typedef struct
   miPixel **pixmap;		/* each element is a miPixel */
   unsigned int width;
   unsigned int height;
+  miPixel *pixels;		/* block holding the rows, if libxmi allocated them */
+  unsigned int stride;		/* miPixels from one row to the next, ditto */
 }
 miPixmap;
 
+#define MI_PIXMAP_ROW_ALIGN 16
+
 /* Definition of miCanvasPixmap, the datatype of the drawable encapsulated
    within a miCanvas.  By default, a miCanvasPixmap is a miPixmap.  The
    libxmi installer may alter the definition by defining the symbol
@@ -407,6 +414,7 @@ extern void miSetPixelMerge3 (miCanvas *pCanvas, miPixelMerge3 pixelMerge3);
 #ifndef MI_DEFAULT_MERGE2_PIXEL
 /* use painter's algorithm */
 #define MI_DEFAULT_MERGE2_PIXEL(new, source, dest) { (new) = (source); }
+#define MI_DEFAULT_MERGE2_IS_PAINTERS 1
 #endif
 
 /* Likewise, the libxmi installer may request that the default algorithm
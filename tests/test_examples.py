@@ -1,4 +1,7 @@
 import os
+import re
+import struct
+import zlib
 import biggles
 import numpy
 
@@ -20,6 +23,18 @@ def _write_example(label, p):
             pass
 
 
+def _png_pixels(data):
+    # the decoded image data; png files also carry their creation time
+    chunks = []
+    i = 8
+    while i < len(data):
+        n, = struct.unpack('>I', data[i:i + 4])
+        if data[i + 4:i + 8] == b'IDAT':
+            chunks.append(data[i + 8:i + 8 + n])
+        i += n + 12
+    return zlib.decompress(b''.join(chunks))
+
+
 def test_example1():
     x = numpy.arange(0, 3 * numpy.pi, numpy.pi / 30)
     c = numpy.cos(x)
@@ -367,6 +382,26 @@ def test_example12():
     _write_example(12, p)
 
 
+def test_layout_cache_invalidate():
+    x = numpy.arange(10.)
+    y = numpy.arange(10.)
+
+    c = biggles.Curve(x, y)
+    p = biggles.FramedPlot()
+    p.add(c)
+    p.write_bytes('svg')
+
+    # modifying the data in place leaves the cached layout stale, until
+    # the component is invalidated
+    y *= 10
+    fresh = biggles.FramedPlot()
+    fresh.add(biggles.Curve(x, y))
+    assert p.write_bytes('svg') != fresh.write_bytes('svg')
+
+    c.invalidate()
+    assert p.write_bytes('svg') == fresh.write_bytes('svg')
+
+
 def test_labels():
     import numpy
     from numpy import linspace
@@ -430,3 +465,319 @@ def test_labels():
     )
 
     _write_example('labels', plt)
+
+
+def test_antialias_values():
+    import warnings
+    from biggles.libplot.renderer import ImageRenderer
+
+    for value, resolution in (("no", 1.), ("yes", .25), (2, .5),
+                              ("16", 1. / 8)):
+        r = ImageRenderer('png', 10, 10, antialias=value)
+        assert r.resolution == resolution
+
+    # libplot ignores values it can't parse, and so do we
+    with warnings.catch_warnings(record=True) as caught:
+        warnings.simplefilter("always")
+        r = ImageRenderer('png', 10, 10, antialias="fine")
+    assert r.resolution == 1.
+    assert len(caught) == 1
+
+
+def test_write_bytes():
+    x = numpy.arange(0, 3 * numpy.pi, numpy.pi / 30)
+
+    p = biggles.FramedPlot()
+    p.add(biggles.Curve(x, numpy.cos(x)))
+
+    assert p.write_bytes('png').startswith(b'\x89PNG')
+    assert p.write_bytes('eps').startswith(b'%!PS')
+    assert b'<svg' in p.write_bytes('svg')
+    assert p._repr_png_().startswith(b'\x89PNG')
+
+
+def test_plotter_after_get_output():
+    from biggles.libplot._libplot_pywrap import Plotter
+
+    pl = Plotter('svg', {}, None)
+    pl.begin_page()
+    pl.line(0., 0., 1., 1.)
+    pl.end_page()
+    assert b'<svg' in pl.get_output()
+
+    for call in (pl.begin_page, pl.end_page, lambda: pl.line(0., 0., 1., 1.),
+                 lambda: pl.curve(numpy.zeros(3), numpy.ones(3)),
+                 lambda: pl.string(0, 0, 'x'), pl.get_output):
+        try:
+            call()
+        except RuntimeError:
+            pass
+        else:
+            assert False, "drawing after get_output() didn't raise"
+
+
+def test_curve_chunks():
+    from biggles.libplot._libplot_pywrap import Plotter
+
+    # long enough to be passed to libplot in several chunks
+    x = numpy.linspace(0, 1, 2 * 5000, dtype=numpy.float32)[::2]
+    y = numpy.sin(20 * x)
+
+    def draw(x, y, clip=False):
+        pl = Plotter('svg', {}, None)
+        pl.begin_page()
+        pl.space(0., -1., 1., 1.)
+        if clip:
+            pl.clipped_curve(x, y, 0.1, 0.9, -0.5, 0.5)
+        else:
+            pl.curve(x, y)
+        pl.end_page()
+        return pl.get_output()
+
+    for clip in (False, True):
+        expected = draw(x.astype(numpy.float64), y.astype(numpy.float64), clip)
+        assert draw(x, y, clip) == expected
+        assert draw(list(x), y, clip) == expected
+
+
+def test_decimate():
+    from biggles import _biggles
+
+    # first, lowest, highest and last of each column, in order
+    x = numpy.array([0., .1, .2, .3, .4, 1., 1.1, 1.2, 2.5])
+    y = numpy.array([0., 5., -3., 2., 1., 4., 4., 4., 7.])
+    u, v = _biggles.decimate(x, y, 1.)
+    assert list(u) == [0., .1, .2, .4, 1., 1.2, 2.5]
+    assert list(v) == [0., 5., -3., 1., 4., 4., 7.]
+
+    rng = numpy.random.RandomState(5)
+    x = numpy.sort(rng.uniform(0, 100, 10000))
+    y = rng.normal(size=x.size)
+    u, v = _biggles.decimate(x, y, 1.)
+    keep = []
+    for col in range(100):
+        i, = numpy.nonzero(numpy.floor(x) == col)
+        if i.size:
+            keep += sorted(set([i[0], i[numpy.argmin(y[i])],
+                                i[numpy.argmax(y[i])], i[-1]]))
+    assert numpy.array_equal(u, x[keep])
+    assert numpy.array_equal(v, y[keep])
+
+    # a NaN ends a run and is kept on its own; infinities are values
+    x = numpy.array([0., .1, .2, .3, .4])
+    u, v = _biggles.decimate(x, [1., numpy.nan, 2., 3., 0.], 1.)
+    assert numpy.array_equal(u, x)
+    assert numpy.array_equal(v, [1., numpy.nan, 2., 3., 0.], equal_nan=True)
+    u, v = _biggles.decimate(x, [0., numpy.inf, -numpy.inf, 1., 2.], 1.)
+    assert list(u) == [0., .1, .2, .4]
+    assert list(v) == [0., numpy.inf, -numpy.inf, 2.]
+    u, v = _biggles.decimate([0., .5, numpy.inf, numpy.inf], x[:4], 1.)
+    assert list(v) == list(x[:4])
+
+    for tol in (0., -1., numpy.nan):
+        try:
+            _biggles.decimate(x, x, tol)
+        except ValueError:
+            pass
+        else:
+            assert False, "decimate(tol=%r) didn't raise" % tol
+
+
+def _curve_vertices(data, ftype):
+    # the vertices of the red curve, and everything else in the file
+    if ftype == 'svg':
+        lines = data.decode().split('\n')
+        curve = [ln for ln in lines if 'stroke="red"' in ln]
+        rest = [ln for ln in lines if 'stroke="red"' not in ln]
+        pts = [p for ln in curve for p in ln.split('"')[1].split()]
+        pts = [p.split(',') for p in pts]
+    else:
+        blocks = data.decode().split('Begin %I MLine')
+        curve = [b for b in blocks if '%I cfg Red' in b]
+        rest = [b for b in blocks[1:] if '%I cfg Red' not in b]
+        pts = [p.split() for b in curve
+               for p in re.findall(r'^-?\d+ -?\d+$', b, re.M)]
+    return numpy.array(pts, dtype=float), rest
+
+
+def test_decimate_output():
+    x = numpy.linspace(0, 1, 20000)
+    y = numpy.sin(40 * x) + numpy.random.RandomState(1).normal(0, .3, x.size)
+
+    def draw(ftype, decimate):
+        p = biggles.FramedPlot()
+        c = biggles.Curve(x, y, color='red')
+        c.decimate = decimate
+        p.add(c)
+        return _curve_vertices(p.write_bytes(ftype), ftype)
+
+    # one 0.1pt column, plus rounding, in file units
+    for ftype, width in (('svg', 0.1 + 0.02), ('eps', 2 + 1)):
+        full, rest = draw(ftype, 0)
+        thin, thin_rest = draw(ftype, 1)
+
+        assert len(full) >= x.size
+        assert len(thin) < 0.75 * len(full)
+        assert thin_rest == rest
+
+        # every point drawn is still there, or lies between points
+        # kept within a column of it
+        assert set(map(tuple, thin)) <= set(map(tuple, full))
+        order = numpy.argsort(thin[:, 0], kind='stable')
+        tx, ty = thin[order, 0], thin[order, 1]
+        lo = numpy.searchsorted(tx, full[:, 0] - width, 'left')
+        hi = numpy.searchsorted(tx, full[:, 0] + width, 'right')
+        for (px, py), i, j in zip(full, lo, hi):
+            assert ty[i:j].min() <= py <= ty[i:j].max(), (ftype, px, py)
+
+
+def test_svg_compact():
+    x = numpy.arange(0, 3 * numpy.pi, numpy.pi / 300)
+
+    p = biggles.FramedPlot()
+    p.add(biggles.Curve(x, numpy.cos(x)))
+
+    full = p.write_bytes('svg')
+    compact = p.write_bytes('svg', decimals=3, relative=1, merge=1)
+
+    assert b'<polyline' in full
+    assert b'<polyline' not in compact
+    assert len(compact) < len(full) / 2
+
+
+def test_svg_markers_rounded():
+    from biggles.libplot._libplot_pywrap import Plotter
+
+    x = numpy.random.uniform(0, 1000, size=100)
+    y = numpy.random.uniform(0, 1000, size=100)
+
+    # 5 decimals of the page are 2 decimals of a 1000 unit wide space
+    pl = Plotter('svg', {'SVG_DECIMALS': '5'}, None)
+    pl.begin_page()
+    pl.space(0., 0., 1000., 1000.)
+    pl.symbols(x, y, 3, 5.)
+    pl.end_page()
+
+    uses = re.findall(rb'<use [^>]*x="([^"]*)" y="([^"]*)"', pl.get_output())
+    assert len(uses) == len(x) - 1
+    for dx, dy in uses:
+        assert len(dx.partition(b'.')[2]) <= 2
+        assert len(dy.partition(b'.')[2]) <= 2
+
+
+def test_table_threads():
+    from biggles.libplot._libplot_pywrap import Plotter
+
+    x = numpy.linspace(0, 10, 1000)
+    t = biggles.Table(2, 3)
+    for k in range(6):
+        p = biggles.FramedPlot(title=str(k))
+        p.add(biggles.Curve(x, numpy.sin((k + 1) * x), color='red'))
+        t[k // 3, k % 3] = p
+
+    # the tiles are read and copied onto the page without changing them
+    for antialias in ('no', 'yes'):
+        serial = t.write_bytes('png', antialias=antialias, threads=1)
+        tiled = t.write_bytes('png', antialias=antialias, threads=3)
+        assert _png_pixels(tiled) == _png_pixels(serial)
+
+    pl = Plotter('pnm', {'BITMAPSIZE': '4x3', 'ANTIALIAS': '2'}, '')
+    pl.begin_page()
+    width, height, rgb = pl.get_image()
+    assert (width, height) == (8, 6)
+    assert rgb == b'\xff' * 3 * 8 * 6
+    pl.end_page()
+
+    pl = Plotter('svg', {}, None)
+    pl.begin_page()
+    try:
+        pl.get_image()
+    except RuntimeError:
+        pass
+    else:
+        assert False, "svg plotter returned a canvas"
+
+
+def test_retained():
+    x = numpy.arange(0, 3 * numpy.pi, numpy.pi / 30)
+
+    p = biggles.FramedPlot(retained=True)
+    p.add(biggles.Curve(x, numpy.sin(x)))
+    c = biggles.Curve(x, numpy.cos(x), color="red")
+    p.add(c)
+
+    first = p.write_bytes('png')
+    c.set_data(x, numpy.cos(2 * x))
+    second = p.write_bytes('png')
+    c.set_data(x, numpy.cos(x))
+    third = p.write_bytes('png')
+
+    assert first.startswith(b'\x89PNG')
+    assert second != first
+    assert third.startswith(b'\x89PNG')
+    assert b'<svg' in p.write_bytes('svg')
+
+
+def test_retained_axis_change():
+    x = numpy.arange(0, 3 * numpy.pi, numpy.pi / 30)
+
+    def make(retained):
+        p = biggles.FramedPlot(retained=retained)
+        p.add(biggles.Curve(x, numpy.sin(x)))
+        return p
+
+    p = make(True)
+    p.write_bytes('png')
+    p.xlabel = "x"
+    p.ylabel = "y"
+    p.frame.grid_style["color"] = "red"
+    p.frame.draw_grid = 1
+
+    fresh = make(False)
+    fresh.xlabel = "x"
+    fresh.ylabel = "y"
+    fresh.frame.grid_style["color"] = "red"
+    fresh.frame.draw_grid = 1
+
+    expected = _png_pixels(fresh.write_bytes('png'))
+    assert _png_pixels(p.write_bytes('png')) == expected
+    # and again, with the retained background reused
+    assert _png_pixels(p.write_bytes('png')) == expected
+
+
+def test_streaming_curve():
+    c = biggles.StreamingCurve(window=50)
+    for i in range(120):
+        c.append(float(i), numpy.sin(i / 10.))
+    c.append(numpy.arange(120., 130.), numpy.zeros(10))
+
+    assert len(c) == 50
+    assert c.x[0] == 80. and c.x[-1] == 129.
+    lim = c.limits()
+    assert lim.xrange() == (80., 129.)
+    assert lim.yrange() == (min(c.y), max(c.y))
+
+    p = biggles.FramedPlot()
+    p.add(c)
+    assert p.write_bytes('png').startswith(b'\x89PNG')
+
+
+def test_multipage():
+    x = numpy.arange(0, 3 * numpy.pi, numpy.pi / 30)
+
+    plots = []
+    for i in range(3):
+        p = biggles.FramedPlot()
+        p.add(biggles.Curve(x, numpy.sin(x + i)))
+        plots.append(p)
+
+    fname = "multipage.ps"
+    biggles.multipage(plots, fname)
+    with open(fname, 'rb') as fp:
+        ps = fp.read()
+    os.remove(fname)
+
+    assert ps.startswith(b'%!PS')
+    assert b'%%Pages: (atend)' in ps
+    assert ps.count(b'%%Page: ') == 3
+    assert b'%%Trailer\nend\n%%Pages: 3\n' in ps